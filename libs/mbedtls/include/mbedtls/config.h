@@ -159,9 +159,9 @@
  *
  * Comment if your system does not support time functions
  */
-#ifndef ENCLAVE_ENVIRONMENT
+#if !defined(ENCLAVE_ENVIRONMENT) || defined(DECENT_ENCLAVE_MBEDTLS_TIME)
 #define MBEDTLS_HAVE_TIME
-#endif // !ENCLAVE_ENVIRONMENT
+#endif // !ENCLAVE_ENVIRONMENT || DECENT_ENCLAVE_MBEDTLS_TIME
 
 /**
  * \def MBEDTLS_HAVE_TIME_DATE
@@ -182,9 +182,9 @@
  * mbedtls_platform_gmtime_r() at compile-time by using the macro
  * MBEDTLS_PLATFORM_GMTIME_R_ALT.
  */
-#ifndef ENCLAVE_ENVIRONMENT
+#if !defined(ENCLAVE_ENVIRONMENT) || defined(DECENT_ENCLAVE_MBEDTLS_TIME)
 #define MBEDTLS_HAVE_TIME_DATE
-#endif // !ENCLAVE_ENVIRONMENT
+#endif // !ENCLAVE_ENVIRONMENT || DECENT_ENCLAVE_MBEDTLS_TIME
 
 /**
  * \def MBEDTLS_PLATFORM_MEMORY
@@ -253,7 +253,12 @@
  * platform function
  */
 //#define MBEDTLS_PLATFORM_EXIT_ALT
+#if defined(ENCLAVE_ENVIRONMENT) && defined(DECENT_ENCLAVE_MBEDTLS_TIME)
+/* The time inside the enclave is given by DECENT, see Decent::Tools::GetSystemTime */
+#define MBEDTLS_PLATFORM_TIME_ALT
+#else
 //#define MBEDTLS_PLATFORM_TIME_ALT
+#endif // ENCLAVE_ENVIRONMENT && DECENT_ENCLAVE_MBEDTLS_TIME
 //#define MBEDTLS_PLATFORM_FPRINTF_ALT
 //#define MBEDTLS_PLATFORM_PRINTF_ALT
 //#define MBEDTLS_PLATFORM_SNPRINTF_ALT
@@ -3414,7 +3419,11 @@
  * unconditionally use the implementation for mbedtls_platform_gmtime_r()
  * supplied at compile time.
  */
+#if defined(ENCLAVE_ENVIRONMENT) && defined(DECENT_ENCLAVE_MBEDTLS_TIME)
+#define MBEDTLS_PLATFORM_GMTIME_R_ALT
+#else
 //#define MBEDTLS_PLATFORM_GMTIME_R_ALT
+#endif // ENCLAVE_ENVIRONMENT && DECENT_ENCLAVE_MBEDTLS_TIME
 
 /* \} name SECTION: Customisation configuration options */
 
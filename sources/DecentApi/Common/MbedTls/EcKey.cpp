@@ -1,5 +1,8 @@
 #include "EcKey.h"
 
+#include <map>
+#include <mutex>
+
 #include <mbedtls/pk.h>
 #include <mbedtls/ecp.h>
 #include <mbedtls/ecdh.h>
@@ -92,6 +95,39 @@ namespace
 			throw RuntimeException("The given EC key type is not supported.");
 		}
 	}
+
+	/**
+	 * \brief	Multiplies the base point of the group once, so that mbedTLS computes the comb table for
+	 * 			the base point and keeps it in the group.
+	 *
+	 * \param [in,out]	grp	The group.
+	 *
+	 * \return	The mbedTLS error code.
+	 */
+	int EcpPrecomputeBasePoint(mbedtls_ecp_group* grp)
+	{
+		int ret = 0;
+		mbedtls_mpi one;
+		mbedtls_ecp_point res;
+
+		mbedtls_mpi_init(&one);
+		mbedtls_ecp_point_init(&res);
+
+		MBEDTLS_MPI_CHK(mbedtls_mpi_lset(&one, 1));
+		MBEDTLS_MPI_CHK(mbedtls_ecp_mul(grp, &res, &one, &grp->G, nullptr, nullptr));
+
+	cleanup:
+		mbedtls_ecp_point_free(&res);
+		mbedtls_mpi_free(&one);
+
+		return ret;
+	}
+
+	mbedtls_ecp_group* GetSharedGroup(const mbedtls_ecp_keypair& ecCtx)
+	{
+		//The shared group is read-only for mbedTLS once the table is computed; mbedTLS API just doesn't take const.
+		return const_cast<mbedtls_ecp_group*>(EcGroup::GetShared(GetEcGroupId(ecCtx.grp.id)).Get());
+	}
 }
 
 void EcGroup::FreeObject(mbedtls_ecp_group * ptr)
@@ -124,10 +160,35 @@ EcGroup::EcGroup(const mbedtls_ecp_group & rhs) :
 	CALL_MBEDTLS_C_FUNC(mbedtls_ecp_group_copy, Get(), &rhs);
 }
 
+EcGroup::EcGroup(EcKeyType type) :
+	EcGroup()
+{
+	CALL_MBEDTLS_C_FUNC(mbedtls_ecp_group_load, Get(), GetEcGroupId(type));
+}
+
 EcGroup::~EcGroup()
 {
 }
 
+const EcGroup & EcGroup::GetShared(EcKeyType type)
+{
+	static std::mutex sharedGrpMutex;
+	static std::map<EcKeyType, std::unique_ptr<EcGroup> > sharedGrps;
+
+	std::unique_lock<std::mutex> sharedGrpLock(sharedGrpMutex);
+
+	auto it = sharedGrps.find(type);
+	if (it != sharedGrps.end())
+	{
+		return *(it->second);
+	}
+
+	std::unique_ptr<EcGroup> grp = std::unique_ptr<EcGroup>(new EcGroup(type));
+	CALL_MBEDTLS_C_FUNC(EcpPrecomputeBasePoint, grp->Get());
+
+	return *(sharedGrps[type] = std::move(grp));
+}
+
 void EcPublicKeyBase::CheckHasPublicKey(const mbedtls_ecp_keypair & ctx)
 {
 	CALL_MBEDTLS_C_FUNC(mbedtls_ecp_check_pubkey, &ctx.grp, &ctx.Q);
@@ -299,9 +360,7 @@ void EcPublicKeyBase::VerifySign(const void * hashBuf, size_t hashSize, const Bi
 {
 	auto& ecCtx = GetEcContext();
 
-	EcGroup ecGrp = ecCtx.grp;
-
-	CALL_MBEDTLS_C_FUNC(mbedtls_ecdsa_verify, ecGrp.Get(), static_cast<const uint8_t*>(hashBuf), hashSize, &(ecCtx.Q), r.Get(), s.Get());
+	CALL_MBEDTLS_C_FUNC(mbedtls_ecdsa_verify, GetSharedGroup(ecCtx), static_cast<const uint8_t*>(hashBuf), hashSize, &(ecCtx.Q), r.Get(), s.Get());
 }
 
 void EcPublicKeyBase::ToPublicBinary(void * xPtr, size_t xSize, void * yPtr, size_t ySize) const
@@ -447,13 +506,13 @@ void EcKeyPairBase::Sign(HashType hashType, const void * hashBuf, size_t hashSiz
 
 	auto& ecCtx = GetEcContext();
 
-	EcGroup ecGrp = ecCtx.grp;
+	mbedtls_ecp_group* ecGrp = GetSharedGroup(ecCtx);
 
 #ifdef MBEDTLS_ECDSA_DETERMINISTIC
-	CALL_MBEDTLS_C_FUNC(mbedtls_ecdsa_sign_det, ecGrp.Get(), r.Get(), s.Get(),
+	CALL_MBEDTLS_C_FUNC(mbedtls_ecdsa_sign_det, ecGrp, r.Get(), s.Get(),
 		&ecCtx.d, static_cast<const uint8_t*>(hashBuf), hashSize, detail::GetMsgDigestType(hashType));
 #else
-	CALL_MBEDTLS_C_FUNC(mbedtls_ecdsa_sign, ecGrp.Get(), r.Get(), s.Get(),
+	CALL_MBEDTLS_C_FUNC(mbedtls_ecdsa_sign, ecGrp, r.Get(), s.Get(),
 		&ecCtx.d, static_cast<const uint8_t*>(hashBuf), hashSize, &RbgBase::CallBack, &rbg);
 #endif
 }
@@ -483,9 +542,7 @@ void EcKeyPairBase::DeriveSharedKey(BigNumber & key, const EcPublicKeyBase & pub
 	auto& ecCtx = GetEcContext();
 	auto& pubEcCtx = pubKey.GetEcContext();
 
-	EcGroup ecGrp = ecCtx.grp;
-
-	CALL_MBEDTLS_C_FUNC(mbedtls_ecdh_compute_shared, ecGrp.Get(), key.Get(),
+	CALL_MBEDTLS_C_FUNC(mbedtls_ecdh_compute_shared, GetSharedGroup(ecCtx), key.Get(),
 		&(pubEcCtx.Q), &ecCtx.d,
 		&RbgBase::CallBack, &rbg);
 }
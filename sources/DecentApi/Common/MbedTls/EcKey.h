@@ -110,8 +110,30 @@ namespace Decent
 
 			EcGroup(const mbedtls_ecp_group& rhs);
 
+			/**
+			 * \brief	Constructs a group for a named curve.
+			 *
+			 * \param	type	The curve type.
+			 */
+			EcGroup(EcKeyType type);
+
 			virtual ~EcGroup();
 
+			/**
+			 * \brief	Gets the group shared by the whole program for the given curve. The group is loaded
+			 * 			lazily on its first use, together with the precomputed comb table for its base
+			 * 			point, so that fixed-base multiplications (e.g. signing, and half of the ECDSA
+			 * 			verification) do not recompute the table every time. After that, mbedTLS only
+			 * 			reads from the group, thus, it can be used by multiple threads at the same time.
+			 *
+			 * \exception	MbedTlsObj::RuntimeException	Thrown when Invalid Elliptic Curve type is given.
+			 *
+			 * \param	type	The curve type.
+			 *
+			 * \return	The shared group, which lives until the program exits.
+			 */
+			static const EcGroup& GetShared(EcKeyType type);
+
 		};
 
 		class EcPublicKeyBase : public AsymKeyBase
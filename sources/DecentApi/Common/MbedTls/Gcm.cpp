@@ -1,9 +1,15 @@
 #include "Gcm.h"
 
+#include <cstring>
+
+#include <algorithm>
+
 #include <mbedtls/gcm.h>
 
 #include "../make_unique.h"
+#include "../consttime_memequal.h"
 #include "MbedTlsException.h"
+#include "SafeWrappers.h"
 
 using namespace Decent::MbedTlsObj;
 
@@ -50,6 +56,7 @@ void GcmBase::Encrypt(const void * inData, const size_t inLen, void * outData, c
 	{
 		throw RuntimeException("Invalid input parameters for function " "GcmBase::Encrypt" ". ");
 	}
+	ResetStream();
 	CALL_MBEDTLS_C_FUNC(
 		mbedtls_gcm_crypt_and_tag,
 		Get(), MBEDTLS_GCM_ENCRYPT, inLen,
@@ -72,6 +79,7 @@ void GcmBase::Decrypt(const void * inData, const size_t inLen, void * outData, c
 	{
 		throw RuntimeException("Invalid input parameters for function " "GcmBase::Decrypt" ". ");
 	}
+	ResetStream();
 	CALL_MBEDTLS_C_FUNC(
 		mbedtls_gcm_auth_decrypt, Get(), inLen,
 		static_cast<const uint8_t*>(iv), ivLen,
@@ -81,3 +89,228 @@ void GcmBase::Decrypt(const void * inData, const size_t inLen, void * outData, c
 		static_cast<uint8_t*>(outData)
 	);
 }
+
+constexpr size_t GcmBase::sk_blockSize;
+
+void GcmBase::BeginEncrypt(const void * iv, const size_t ivLen)
+{
+	Begin(true, iv, ivLen);
+}
+
+void GcmBase::BeginDecrypt(const void * iv, const size_t ivLen)
+{
+	Begin(false, iv, ivLen);
+}
+
+void GcmBase::UpdateAad(const void * add, const size_t addLen)
+{
+	if (m_streamStatus != StreamStatus::Began || (!add && addLen > 0))
+	{
+		throw RuntimeException("Invalid call to function " "GcmBase::UpdateAad" ". ");
+	}
+	if (addLen == 0)
+	{
+		return;
+	}
+
+	const uint8_t* addByte = static_cast<const uint8_t*>(add);
+	if (m_streamAadSize == 0)
+	{
+		//The first segment is referenced, rather than copied.
+		m_streamAadPtr = addByte;
+		m_streamAadSize = addLen;
+		return;
+	}
+
+	//mbedtls_gcm_starts only accepts AAD as a single buffer, thus, multiple segments have to be joined.
+	if (m_streamAadBuf.empty())
+	{
+		m_streamAadBuf.assign(m_streamAadPtr, m_streamAadPtr + m_streamAadSize);
+	}
+	m_streamAadBuf.insert(m_streamAadBuf.end(), addByte, addByte + addLen);
+	m_streamAadPtr = m_streamAadBuf.data();
+	m_streamAadSize = m_streamAadBuf.size();
+}
+
+size_t GcmBase::Update(const void * inData, const size_t inLen, void * outData, const size_t outLen)
+{
+	if (m_streamStatus == StreamStatus::Idle || (!inData && inLen > 0))
+	{
+		throw RuntimeException("Invalid call to function " "GcmBase::Update" ". ");
+	}
+
+	const size_t outNeeded = ((m_streamPartialLen + inLen) / sk_blockSize) * sk_blockSize;
+	if (outNeeded > 0 && (!outData || outLen < outNeeded))
+	{
+		throw RuntimeException("Output buffer is too small for function " "GcmBase::Update" ". ");
+	}
+
+	StartStreamIfNeeded();
+
+	const uint8_t* inByte = static_cast<const uint8_t*>(inData);
+	uint8_t* outByte = static_cast<uint8_t*>(outData);
+	size_t inRemain = inLen;
+	size_t written = 0;
+
+	//1. Complete the block held back from last call.
+	if (m_streamPartialLen > 0)
+	{
+		const size_t toFill = std::min(sk_blockSize - m_streamPartialLen, inRemain);
+		std::memcpy(m_streamPartial.data() + m_streamPartialLen, inByte, toFill);
+		m_streamPartialLen += toFill;
+		inByte += toFill;
+		inRemain -= toFill;
+
+		if (m_streamPartialLen < sk_blockSize)
+		{
+			return 0;
+		}
+
+		written += FlushPartial(outByte, outLen);
+	}
+
+	//2. Whole blocks go directly from the input to the output.
+	const size_t alignedLen = (inRemain / sk_blockSize) * sk_blockSize;
+	if (alignedLen > 0)
+	{
+		CALL_MBEDTLS_C_FUNC(mbedtls_gcm_update, Get(), alignedLen, inByte, outByte + written);
+		inByte += alignedLen;
+		inRemain -= alignedLen;
+		written += alignedLen;
+	}
+
+	//3. Hold back the rest.
+	if (inRemain > 0)
+	{
+		std::memcpy(m_streamPartial.data(), inByte, inRemain);
+		m_streamPartialLen = inRemain;
+	}
+
+	return written;
+}
+
+size_t GcmBase::FinishEncrypt(void * outData, const size_t outLen, void * tag, const size_t tagLen)
+{
+	if (m_streamStatus == StreamStatus::Idle || !m_isStreamEncrypt || !tag ||
+		(m_streamPartialLen > 0 && (!outData || outLen < m_streamPartialLen)))
+	{
+		throw RuntimeException("Invalid call to function " "GcmBase::FinishEncrypt" ". ");
+	}
+
+	StartStreamIfNeeded();
+
+	const size_t written = FlushPartial(outData, outLen);
+	try
+	{
+		CALL_MBEDTLS_C_FUNC(mbedtls_gcm_finish, Get(), static_cast<uint8_t*>(tag), tagLen);
+	}
+	catch (const std::exception&)
+	{
+		ResetStream();
+		throw;
+	}
+	ResetStream();
+
+	return written;
+}
+
+size_t GcmBase::FinishDecrypt(void * outData, const size_t outLen, const void * tag, const size_t tagLen)
+{
+	if (m_streamStatus == StreamStatus::Idle || m_isStreamEncrypt || !tag || tagLen > sk_blockSize ||
+		(m_streamPartialLen > 0 && (!outData || outLen < m_streamPartialLen)))
+	{
+		throw RuntimeException("Invalid call to function " "GcmBase::FinishDecrypt" ". ");
+	}
+
+	StartStreamIfNeeded();
+
+	const size_t written = FlushPartial(outData, outLen);
+	std::array<uint8_t, sk_blockSize> calcTag;
+	try
+	{
+		CALL_MBEDTLS_C_FUNC(mbedtls_gcm_finish, Get(), calcTag.data(), tagLen);
+	}
+	catch (const std::exception&)
+	{
+		ResetStream();
+		throw;
+	}
+	ResetStream();
+
+	if (!consttime_memequal(calcTag.data(), tag, tagLen))
+	{
+		throw MbedTlsException("mbedtls_gcm_finish", MBEDTLS_ERR_GCM_AUTH_FAILED);
+	}
+
+	return written;
+}
+
+void GcmBase::Begin(bool isEncrypt, const void * iv, const size_t ivLen)
+{
+	NullCheck();
+
+	if (!iv || ivLen == 0)
+	{
+		throw RuntimeException("Invalid input parameters for function " "GcmBase::Begin" ". ");
+	}
+
+	ResetStream();
+
+	const uint8_t* ivByte = static_cast<const uint8_t*>(iv);
+	m_streamIv.assign(ivByte, ivByte + ivLen);
+	m_isStreamEncrypt = isEncrypt;
+	m_streamStatus = StreamStatus::Began;
+}
+
+void GcmBase::StartStreamIfNeeded()
+{
+	if (m_streamStatus != StreamStatus::Began)
+	{
+		return;
+	}
+
+	CALL_MBEDTLS_C_FUNC(mbedtls_gcm_starts, Get(), m_isStreamEncrypt ? MBEDTLS_GCM_ENCRYPT : MBEDTLS_GCM_DECRYPT,
+		m_streamIv.data(), m_streamIv.size(), m_streamAadPtr, m_streamAadSize);
+
+	//AAD is consumed by mbedtls_gcm_starts.
+	ZeroizeContainer(m_streamAadBuf);
+	m_streamAadBuf.clear();
+	m_streamAadPtr = nullptr;
+	m_streamAadSize = 0;
+
+	m_streamStatus = StreamStatus::Updating;
+}
+
+size_t GcmBase::FlushPartial(void * outData, const size_t outLen)
+{
+	if (m_streamPartialLen == 0)
+	{
+		return 0;
+	}
+
+	if (!outData || outLen < m_streamPartialLen)
+	{
+		throw RuntimeException("Invalid input parameters for function " "GcmBase::FlushPartial" ". ");
+	}
+
+	const size_t toWrite = m_streamPartialLen;
+	m_streamPartialLen = 0;
+
+	//Output must not overlap with the input for decryption, thus, the output goes to the caller's buffer.
+	CALL_MBEDTLS_C_FUNC(mbedtls_gcm_update, Get(), toWrite, m_streamPartial.data(), static_cast<uint8_t*>(outData));
+	ZeroizeContainer(m_streamPartial);
+
+	return toWrite;
+}
+
+void GcmBase::ResetStream() noexcept
+{
+	ZeroizeContainer(m_streamAadBuf);
+	m_streamAadBuf.clear();
+	m_streamAadPtr = nullptr;
+	m_streamAadSize = 0;
+	m_streamIv.clear();
+	ZeroizeContainer(m_streamPartial);
+	m_streamPartialLen = 0;
+	m_streamStatus = StreamStatus::Idle;
+}
@@ -3,6 +3,7 @@
 #include "ObjBase.h"
 
 #include <array>
+#include <vector>
 
 typedef struct mbedtls_gcm_context mbedtls_gcm_context;
 
@@ -46,7 +47,15 @@ namespace Decent
 			* \param [in,out]	ref	The reference.
 			*/
 			GcmBase(mbedtls_gcm_context& ref) noexcept :
-				ObjBase(&ref, &ObjBase::DoNotFree)
+				ObjBase(&ref, &ObjBase::DoNotFree),
+				m_streamStatus(StreamStatus::Idle),
+				m_isStreamEncrypt(true),
+				m_streamIv(),
+				m_streamAadPtr(nullptr),
+				m_streamAadSize(0),
+				m_streamAadBuf(),
+				m_streamPartial(),
+				m_streamPartialLen(0)
 			{}
 
 			/**
@@ -55,11 +64,24 @@ namespace Decent
 			* \param [in,out]	other	The other.
 			*/
 			GcmBase(GcmBase&& other) noexcept :
-				ObjBase(std::forward<ObjBase>(other))
-			{}
+				ObjBase(std::forward<ObjBase>(other)),
+				m_streamStatus(other.m_streamStatus),
+				m_isStreamEncrypt(other.m_isStreamEncrypt),
+				m_streamIv(std::move(other.m_streamIv)),
+				m_streamAadPtr(other.m_streamAadPtr),
+				m_streamAadSize(other.m_streamAadSize),
+				m_streamAadBuf(std::move(other.m_streamAadBuf)),
+				m_streamPartial(other.m_streamPartial),
+				m_streamPartialLen(other.m_streamPartialLen)
+			{
+				other.ResetStream();
+			}
 
 			/** \brief	Destructor */
-			virtual ~GcmBase() {}
+			virtual ~GcmBase()
+			{
+				ResetStream();
+			}
 
 			/**
 			 * \brief	Move assignment operator
@@ -70,7 +92,22 @@ namespace Decent
 			 */
 			virtual GcmBase& operator=(GcmBase&& other) noexcept
 			{
-				ObjBase::operator=(std::forward<ObjBase>(other));
+				if (this != &other)
+				{
+					ResetStream();
+					ObjBase::operator=(std::forward<ObjBase>(other));
+
+					m_streamStatus = other.m_streamStatus;
+					m_isStreamEncrypt = other.m_isStreamEncrypt;
+					m_streamIv = std::move(other.m_streamIv);
+					m_streamAadPtr = other.m_streamAadPtr;
+					m_streamAadSize = other.m_streamAadSize;
+					m_streamAadBuf = std::move(other.m_streamAadBuf);
+					m_streamPartial = other.m_streamPartial;
+					m_streamPartialLen = other.m_streamPartialLen;
+
+					other.ResetStream();
+				}
 				return *this;
 			}
 
@@ -214,6 +251,118 @@ namespace Decent
 				const void* iv, const size_t ivLen, const void* add, const size_t addLen,
 				const void* tag, const size_t tagLen);
 
+			/**
+			 * \brief	Begins a multi-part encryption. After this call, any number of AAD segments can be
+			 * 			given by UpdateAad, followed by any number of plain text segments given by Update,
+			 * 			and finally, FinishEncrypt generates the tag.
+			 *
+			 * \exception MbedTlsObj::RuntimeException
+			 *
+			 * \param	iv   	The iv.
+			 * \param	ivLen	Length of the iv.
+			 */
+			virtual void BeginEncrypt(const void* iv, const size_t ivLen);
+
+			/**
+			 * \brief	Begins a multi-part decryption. See BeginEncrypt. NOTE: the plain text produced by
+			 * 			Update is not authenticated until FinishDecrypt returns successfully.
+			 *
+			 * \exception MbedTlsObj::RuntimeException
+			 *
+			 * \param	iv   	The iv.
+			 * \param	ivLen	Length of the iv.
+			 */
+			virtual void BeginDecrypt(const void* iv, const size_t ivLen);
+
+			template<typename IvStru>
+			void BeginEncrypt(const IvStru& iv)
+			{
+				BeginEncrypt(detail::GetPtr(iv), detail::GetSize(iv));
+			}
+
+			template<typename IvStru>
+			void BeginDecrypt(const IvStru& iv)
+			{
+				BeginDecrypt(detail::GetPtr(iv), detail::GetSize(iv));
+			}
+
+			/**
+			 * \brief	Adds a segment of additional authentication data. All AAD segments must be given
+			 * 			before the first Update call. If only one segment is given, it's not copied, thus,
+			 * 			the buffer must stay valid until the first Update (or Finish) call.
+			 *
+			 * \exception MbedTlsObj::RuntimeException
+			 *
+			 * \param	add   	The additional authentication data.
+			 * \param	addLen	Length of the add.
+			 */
+			virtual void UpdateAad(const void* add, const size_t addLen);
+
+			template<typename AddCtar>
+			void UpdateAad(const AddCtar& add)
+			{
+				UpdateAad(detail::GetPtr(add), detail::GetSize(add));
+			}
+
+			/**
+			 * \brief	Feeds a segment of input into the multi-part operation. Segments can have any size;
+			 * 			input that doesn't fill a complete cipher block is held back, and its output is
+			 * 			written by the next Update or Finish call. Thus, the output size can be different
+			 * 			from the input size, but the total output size is always equal to the total input
+			 * 			size. Output buffer must be at least inLen + 15 bytes to be always sufficient.
+			 *
+			 * \exception MbedTlsObj::RuntimeException
+			 *
+			 * \param 	   	inData 	Input data.
+			 * \param 	   	inLen  	Size of the input data.
+			 * \param [out]	outData	Output data.
+			 * \param 	   	outLen 	Size of the output buffer.
+			 *
+			 * \return	The number of bytes written to the output.
+			 */
+			virtual size_t Update(const void* inData, const size_t inLen, void* outData, const size_t outLen);
+
+			/**
+			 * \brief	Finishes the multi-part encryption, and generates the tag.
+			 *
+			 * \exception MbedTlsObj::RuntimeException
+			 *
+			 * \param [out]	outData	Output for the data held back by Update (less than a block).
+			 * \param 	   	outLen 	Size of the output buffer.
+			 * \param [out]	tag	   	Output tag.
+			 * \param 	   	tagLen 	Length of the tag.
+			 *
+			 * \return	The number of bytes written to the output.
+			 */
+			virtual size_t FinishEncrypt(void* outData, const size_t outLen, void* tag, const size_t tagLen);
+
+			/**
+			 * \brief	Finishes the multi-part decryption, and verifies the tag.
+			 *
+			 * \exception MbedTlsObj::MbedTlsException	The tag doesn't match.
+			 * \exception MbedTlsObj::RuntimeException
+			 *
+			 * \param [out]	outData	Output for the data held back by Update (less than a block).
+			 * \param 	   	outLen 	Size of the output buffer.
+			 * \param 	   	tag	   	The input tag.
+			 * \param 	   	tagLen 	Length of the tag.
+			 *
+			 * \return	The number of bytes written to the output.
+			 */
+			virtual size_t FinishDecrypt(void* outData, const size_t outLen, const void* tag, const size_t tagLen);
+
+			template<typename TagStru>
+			size_t FinishEncrypt(void* outData, const size_t outLen, TagStru& outTag)
+			{
+				return FinishEncrypt(outData, outLen, detail::GetPtr(outTag), detail::GetSize(outTag));
+			}
+
+			template<typename TagStru>
+			size_t FinishDecrypt(void* outData, const size_t outLen, const TagStru& inTag)
+			{
+				return FinishDecrypt(outData, outLen, detail::GetPtr(inTag), detail::GetSize(inTag));
+			}
+
 			/**
 			 * \brief	Query if the pointers to objects held by this object is null
 			 *
@@ -230,8 +379,43 @@ namespace Decent
 			 * \param 		  	freeFunc	The free function.
 			 */
 			GcmBase(mbedtls_gcm_context* ptr, FreeFuncType freeFunc) noexcept :
-				ObjBase(ptr, freeFunc)
+				ObjBase(ptr, freeFunc),
+				m_streamStatus(StreamStatus::Idle),
+				m_isStreamEncrypt(true),
+				m_streamIv(),
+				m_streamAadPtr(nullptr),
+				m_streamAadSize(0),
+				m_streamAadBuf(),
+				m_streamPartial(),
+				m_streamPartialLen(0)
 			{}
+
+		private:
+			static constexpr size_t sk_blockSize = 16;
+
+			enum class StreamStatus
+			{
+				Idle,
+				Began,    //IV is given, waiting for AAD.
+				Updating, //mbedtls_gcm_starts is called.
+			};
+
+			void Begin(bool isEncrypt, const void* iv, const size_t ivLen);
+
+			void StartStreamIfNeeded();
+
+			size_t FlushPartial(void* outData, const size_t outLen);
+
+			void ResetStream() noexcept;
+
+			StreamStatus m_streamStatus;
+			bool m_isStreamEncrypt;
+			std::vector<uint8_t> m_streamIv;
+			const uint8_t* m_streamAadPtr;
+			size_t m_streamAadSize;
+			std::vector<uint8_t> m_streamAadBuf;
+			std::array<uint8_t, sk_blockSize> m_streamPartial;
+			size_t m_streamPartialLen;
 		};
 
 		/**
@@ -1,6 +1,9 @@
 #include "Hasher.h"
 
+#include <cstring>
+
 #include <mbedtls/md.h>
+#include <mbedtls/md_internal.h>
 
 #include "MbedTlsException.h"
 #include "Internal/Hasher.h"
@@ -49,6 +52,20 @@ MsgDigestBase::MsgDigestBase(MsgDigestBase && rhs) :
 {
 }
 
+void MsgDigestBase::CopyStateFrom(const MsgDigestBase & rhs)
+{
+	NullCheck();
+	rhs.NullCheck();
+
+	CALL_MBEDTLS_C_FUNC(mbedtls_md_clone, Get(), rhs.Get());
+
+	//mbedtls_md_clone doesn't copy the HMAC key pads.
+	if (Get()->hmac_ctx && rhs.Get()->hmac_ctx)
+	{
+		std::memcpy(Get()->hmac_ctx, rhs.Get()->hmac_ctx, 2 * static_cast<size_t>(rhs.Get()->md_info->block_size));
+	}
+}
+
 HasherBase::~HasherBase()
 {
 }
@@ -59,11 +76,40 @@ HasherBase::HasherBase(const mbedtls_md_info_t & mdInfo) :
 	CALL_MBEDTLS_C_FUNC(mbedtls_md_starts, Get());
 }
 
+HasherBase::HasherBase(const mbedtls_md_info_t & mdInfo, const HasherBase & rhs) :
+	MsgDigestBase(mdInfo, false)
+{
+	CopyStateFrom(rhs);
+}
+
+HasherBase::HasherBase(HasherBase && rhs) :
+	MsgDigestBase(std::forward<MsgDigestBase>(rhs))
+{
+}
+
 void HasherBase::Update(const void * data, const size_t dataSize)
 {
 	CALL_MBEDTLS_C_FUNC(mbedtls_md_update, Get(), static_cast<const unsigned char*>(data), dataSize);
 }
 
+void HasherBase::Update(const DataListItem * dataList, const size_t listLen)
+{
+	if (listLen > 0 && !dataList)
+	{
+		throw RuntimeException("Invalid parameter(s) given to HasherBase::Update");
+	}
+
+	for (size_t i = 0; i < listLen; ++i)
+	{
+		Update(dataList[i].m_ptr, dataList[i].m_size);
+	}
+}
+
+void HasherBase::Restart()
+{
+	CALL_MBEDTLS_C_FUNC(mbedtls_md_starts, Get());
+}
+
 void HasherBase::Finish(void * output)
 {
 	CALL_MBEDTLS_C_FUNC(mbedtls_md_finish, Get(), static_cast<unsigned char*>(output));
@@ -79,6 +125,22 @@ HMACerBase::HMACerBase(const mbedtls_md_info_t & mdInfo, const void * key, const
 	CALL_MBEDTLS_C_FUNC(mbedtls_md_hmac_starts, Get(), static_cast<const unsigned char*>(key), (keySize * BITS_PER_BYTE));
 }
 
+HMACerBase::HMACerBase(const mbedtls_md_info_t & mdInfo, const HMACerBase & rhs) :
+	MsgDigestBase(mdInfo, true)
+{
+	CopyStateFrom(rhs);
+}
+
+HMACerBase::HMACerBase(HMACerBase && rhs) :
+	MsgDigestBase(std::forward<MsgDigestBase>(rhs))
+{
+}
+
+void HMACerBase::Restart()
+{
+	CALL_MBEDTLS_C_FUNC(mbedtls_md_hmac_reset, Get());
+}
+
 void HMACerBase::Update(const void * data, const size_t dataSize)
 {
 	if (dataSize > 0 && !data)
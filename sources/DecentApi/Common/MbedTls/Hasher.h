@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "ObjBase.h"
@@ -57,6 +58,15 @@ namespace Decent
 			MsgDigestBase(MsgDigestBase&& rhs);
 
 			MsgDigestBase(const MsgDigestBase& rhs) = delete;
+
+			/**
+			 * \brief	Copies the calculation state (i.e. the midstate, and the HMAC key pads if any)
+			 * 			from another instance. Both instances must be set up with the same algorithm and
+			 * 			the same HMAC mode.
+			 *
+			 * \param	rhs	The instance to copy from.
+			 */
+			void CopyStateFrom(const MsgDigestBase& rhs);
 		};
 		
 		class HasherBase : public MsgDigestBase
@@ -66,6 +76,25 @@ namespace Decent
 			/** \brief	Destructor */
 			virtual ~HasherBase();
 
+			/**
+			 * \brief	Updates the calculation with the given data.
+			 *
+			 * \param	data		The data.
+			 * \param	dataSize	Size of the data.
+			 */
+			void Update(const void* data, const size_t dataSize);
+
+			/**
+			 * \brief	Updates the calculation with a list of data (i.e. a scatter list).
+			 *
+			 * \param	dataList	List of data.
+			 * \param	listLen 	Length of the list.
+			 */
+			void Update(const DataListItem* dataList, const size_t listLen);
+
+			/** \brief	Restarts the calculation, so that this instance can be reused after Finish. */
+			void Restart();
+
 		protected:
 
 			HasherBase() = delete;
@@ -78,12 +107,14 @@ namespace Decent
 			HasherBase(const mbedtls_md_info_t& mdInfo);
 
 			/**
-			 * \brief	Updates the calculation with the given data.
+			 * \brief	Constructor that clones the calculation state of another instance.
 			 *
-			 * \param	data		The data.
-			 * \param	dataSize	Size of the data.
+			 * \param	mdInfo	Information describing the md. Must be the same as the one of rhs.
+			 * \param	rhs   	The instance to clone.
 			 */
-			void Update(const void* data, const size_t dataSize);
+			HasherBase(const mbedtls_md_info_t& mdInfo, const HasherBase& rhs);
+
+			HasherBase(HasherBase&& rhs);
 
 			/**
 			 * \brief	Finishes the hash calculation and get the result.
@@ -105,9 +136,68 @@ namespace Decent
 				HasherBase(GetMsgDigestInfo(hType))
 			{}
 
+			Hasher(Hasher&& rhs) :
+				HasherBase(std::forward<HasherBase>(rhs))
+			{}
+
 			virtual ~Hasher()
 			{}
 
+			/**
+			 * \brief	Clones this instance, including the data that has been fed so far (i.e. the
+			 * 			midstate). Thus, a common prefix can be hashed only once, and then the clones can
+			 * 			continue with different data.
+			 *
+			 * \return	A copy of this object.
+			 */
+			Hasher Clone() const
+			{
+				return Hasher(*this);
+			}
+
+			using HasherBase::Update;
+
+			/**
+			 * \brief	Updates the calculation with the given data.
+			 *
+			 * \tparam	Container	Type of the container. NOTE: only continuous containers (i.e. C
+			 * 						array, std::array, std::vector, std::basic_string) are accepted.
+			 * \param	data	The data.
+			 */
+			template<typename Container,
+				typename std::enable_if<detail::ContainerPrpt<Container>::sk_isSprtCtn, int>::type = 0>
+			void Update(const Container& data)
+			{
+				Update(detail::GetPtr(data), detail::GetSize(data));
+			}
+
+			void Update(const std::vector<DataListItem>& list)
+			{
+				Update(list.data(), list.size());
+			}
+
+			template<size_t listLen>
+			void Update(const std::array<DataListItem, listLen>& list)
+			{
+				Update(list.data(), listLen);
+			}
+
+			/**
+			 * \brief	Finishes the calculation and gets the result. Restart must be called before this
+			 * 			instance is used again.
+			 *
+			 * \param [out]	output	The output.
+			 */
+			void Finish(std::array<uint8_t, sk_hashByteSize>& output)
+			{
+				HasherBase::Finish(output.data());
+			}
+
+			void Finish(uint8_t(&output)[sk_hashByteSize])
+			{
+				HasherBase::Finish(output);
+			}
+
 			/**
 			 * \brief	Calculate hash of a list of data in batched mode.
 			 *
@@ -148,7 +238,7 @@ namespace Decent
 			void Calc(std::array<uint8_t, sk_hashByteSize>& output, const Container& data)
 			{
 				Update(detail::GetPtr(data), detail::GetSize(data));
-				Finish(output.data());
+				HasherBase::Finish(output.data());
 			}
 
 			template<typename Container>
@@ -184,6 +274,11 @@ namespace Decent
 				Batched(output, detail::ConstructDataList(arg1, arg2, args...));
 			}
 
+		protected:
+			Hasher(const Hasher& rhs) :
+				HasherBase(GetMsgDigestInfo(hType), rhs)
+			{}
+
 		private:
 
 			/**
@@ -197,12 +292,9 @@ namespace Decent
 			{
 				// Used internally, assume dataList is not null, AND output has enough memory size.
 
-				for (size_t i = 0; i < listLen; ++i)
-				{
-					Update(dataList[i].m_ptr, dataList[i].m_size);
-				}
+				Update(dataList, listLen);
 
-				Finish(output);
+				HasherBase::Finish(output);
 			}
 		};
 
@@ -224,6 +316,20 @@ namespace Decent
 			 */
 			HMACerBase(const mbedtls_md_info_t& mdInfo, const void* key, const size_t keySize);
 
+			/**
+			 * \brief	Constructor that clones the calculation state (including the key) of another
+			 * 			instance.
+			 *
+			 * \param	mdInfo	Information describing the md. Must be the same as the one of rhs.
+			 * \param	rhs   	The instance to clone.
+			 */
+			HMACerBase(const mbedtls_md_info_t& mdInfo, const HMACerBase& rhs);
+
+			HMACerBase(HMACerBase&& rhs);
+
+			/** \brief	Restarts the calculation with the same key, so that this instance can be reused after Finish. */
+			void Restart();
+
 			/**
 			 * \brief	Updates this CMAC instance
 			 *
@@ -260,10 +366,55 @@ namespace Decent
 				HMACerBase(GetMsgDigestInfo(hType), key.m_key.data(), key.m_key.size())
 			{}
 
+			HMACer(HMACer&& rhs) :
+				HMACerBase(std::forward<HMACerBase>(rhs))
+			{}
+
 			/** \brief	Destructor */
 			virtual ~HMACer()
 			{}
 
+			/**
+			 * \brief	Clones this instance, including the processed key and the data that has been fed
+			 * 			so far. Thus, the key (and any common prefix) is processed only once.
+			 *
+			 * \return	A copy of this object.
+			 */
+			HMACer Clone() const
+			{
+				return HMACer(*this);
+			}
+
+			using HMACerBase::Restart;
+			using HMACerBase::Update;
+
+			/**
+			 * \brief	Updates the calculation with the given data.
+			 *
+			 * \tparam	Container	Type of the container. NOTE: only continuous containers (i.e. C
+			 * 						array, std::array, std::vector, std::basic_string) are accepted.
+			 * \param	data	The data.
+			 */
+			template<typename Container,
+				typename std::enable_if<detail::ContainerPrpt<Container>::sk_isSprtCtn, int>::type = 0>
+			void Update(const Container& data)
+			{
+				Update(detail::GetPtr(data), detail::GetSize(data));
+			}
+
+			/**
+			 * \brief	Finishes the calculation and gets the result. Restart must be called before this
+			 * 			instance is used again.
+			 *
+			 * \param [out]	output	The output.
+			 */
+			template<typename containerType,
+				typename std::enable_if<detail::StatCtnWithSize<containerType, sk_hashByteSize>::value, int>::type = 0>
+			void Finish(containerType& output)
+			{
+				HMACerBase::Finish(detail::GetPtr(output));
+			}
+
 			/**
 			 * \brief	Calculate HMAC in batched mode.
 			 *
@@ -305,7 +456,7 @@ namespace Decent
 			void Calc(ResContainerType& output, const DataContainerType& data)
 			{
 				Update(detail::GetPtr(data), detail::GetSize(data));
-				Finish(detail::GetPtr(output));
+				HMACerBase::Finish(detail::GetPtr(output));
 			}
 
 			/**
@@ -330,6 +481,11 @@ namespace Decent
 				Batched(output, detail::ConstructDataList(arg1, arg2, args...));
 			}
 
+		protected:
+			HMACer(const HMACer& rhs) :
+				HMACerBase(GetMsgDigestInfo(hType), rhs)
+			{}
+
 		private:
 
 			/**
@@ -348,7 +504,7 @@ namespace Decent
 					Update(dataList[i].m_ptr, dataList[i].m_size);
 				}
 
-				Finish(output);
+				HMACerBase::Finish(output);
 			}
 		};
 	}
@@ -1,6 +1,7 @@
 #include "Initializer.h"
 
 #include <mbedtls/threading.h>
+#include <mbedtls/platform.h>
 
 #include "MbedTlsSubFunc.h"
 
@@ -30,4 +31,8 @@ Initializer::Initializer()
 		&MbedTls::mbedtls_mutex_lock,
 		&MbedTls::mbedtls_mutex_unlock
 	);
+
+#ifdef MBEDTLS_PLATFORM_TIME_ALT
+	mbedtls_platform_set_time(&MbedTls::mbedtls_time_func);
+#endif // MBEDTLS_PLATFORM_TIME_ALT
 }
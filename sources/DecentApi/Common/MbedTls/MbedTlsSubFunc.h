@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbedtls/threading.h>
+#include <mbedtls/platform_time.h>
 
 namespace Decent
 {
@@ -10,5 +11,9 @@ namespace Decent
 		void mbedtls_mutex_free(mbedtls_threading_mutex_t *mutex);
 		int mbedtls_mutex_lock(mbedtls_threading_mutex_t *mutex);
 		int mbedtls_mutex_unlock(mbedtls_threading_mutex_t *mutex);
+
+#ifdef MBEDTLS_PLATFORM_TIME_ALT
+		mbedtls_time_t mbedtls_time_func(mbedtls_time_t *timer);
+#endif // MBEDTLS_PLATFORM_TIME_ALT
 	}
 }
@@ -523,26 +523,34 @@ X509Cert::X509Cert(const X509Cert & rhs) :
 		CALL_MBEDTLS_C_FUNC(mbedtls_x509_crt_parse_der, Get(), rhsCurr->raw.p, rhsCurr->raw.len);
 		rhsCurr = rhsCurr->next;
 	}
+
+	BuildCurrV3ExtIndex();
 }
 
 X509Cert::X509Cert(X509Cert && rhs) :
 	ObjBase(std::forward<ObjBase>(rhs)),
 	m_currCert(std::move(rhs.m_currCert)),
-	m_certStack(std::move(rhs.m_certStack))
+	m_certStack(std::move(rhs.m_certStack)),
+	m_currExtIndex(std::move(rhs.m_currExtIndex))
 {
 	rhs.m_currCert = nullptr;
+	rhs.m_currExtIndex.clear();
 }
 
 X509Cert::X509Cert(const std::string & pem) :
 	X509Cert()
 {
 	CALL_MBEDTLS_C_FUNC(mbedtls_x509_crt_parse, Get(), reinterpret_cast<const uint8_t*>(pem.c_str()), pem.size() + 1);
+
+	BuildCurrV3ExtIndex();
 }
 
 X509Cert::X509Cert(const std::vector<uint8_t>& der) :
 	X509Cert()
 {
 	CALL_MBEDTLS_C_FUNC(mbedtls_x509_crt_parse, Get(), der.data(), der.size());
+
+	BuildCurrV3ExtIndex();
 }
 
 X509Cert::X509Cert(mbedtls_x509_crt & ref) :
@@ -562,8 +570,10 @@ X509Cert & X509Cert::operator=(X509Cert && rhs)
 	{
 		m_currCert = std::move(rhs.m_currCert);
 		m_certStack = std::move(rhs.m_certStack);
+		m_currExtIndex = std::move(rhs.m_currExtIndex);
 
 		rhs.m_currCert = nullptr;
+		rhs.m_currExtIndex.clear();
 	}
 	return *this;
 }
@@ -674,72 +684,11 @@ std::map<std::string, std::pair<bool, std::string> > X509Cert::GetCurrV3Extensio
 
 	std::map<std::string, std::pair<bool, std::string> > extMap;
 
-	int mbedRet = 0;
-	int is_critical = 0;
-	size_t len = 0;
-
-	unsigned char *end_ext_data = nullptr;
-	unsigned char *end_ext_octet = nullptr;
-
-	unsigned char *begin = Get()->v3_ext.p;
-	const unsigned char *end = Get()->v3_ext.p + Get()->v3_ext.len;
-
-	unsigned char **p = &begin;
-
-	char* oidPtr = nullptr;
-	size_t oidSize = 0;
-
-	char* extDataPtr = nullptr;
-	size_t extDataSize = 0;
-
-	CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end, &len, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE);
-	if (*p + len != end)
-	{
-		throw MbedTlsException("GetCurrV3Extensions", MBEDTLS_ERR_ASN1_INVALID_LENGTH);
-	}
-
-	while (*p < end)
+	for (const V3ExtEntry& entry : m_currExtIndex)
 	{
-		is_critical = 0; /* DEFAULT FALSE */
-
-		CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end, &len, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE);
-
-		end_ext_data = *p + len;
-
-		/* Get extension ID */
-		CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end_ext_data, &len, MBEDTLS_ASN1_OID);
-
-		oidPtr = reinterpret_cast<char*>(*p);
-		oidSize = len;
-
-		*p += len;
-
-		/* Get optional critical */
-		mbedRet = mbedtls_asn1_get_bool(p, end_ext_data, &is_critical);
-		if (mbedRet != MBEDTLS_SUCCESS_RET && mbedRet != MBEDTLS_ERR_ASN1_UNEXPECTED_TAG)
-		{
-			throw MbedTlsException("mbedtls_asn1_get_bool", mbedRet);
-		}
-
-		/* Data should be octet string type */
-		CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end_ext_data, &len, MBEDTLS_ASN1_OCTET_STRING);
-
-		extDataPtr = reinterpret_cast<char*>(*p);
-		extDataSize = len;
-
-		end_ext_octet = *p + len;
-
-		if (end_ext_octet != end_ext_data)
-		{
-			throw MbedTlsException("GetCurrV3Extensions", MBEDTLS_ERR_ASN1_INVALID_LENGTH);
-		}
-
-		//Insert into the map.
 		extMap.insert(
-			std::make_pair(std::string(oidPtr, oidSize),
-				std::make_pair(is_critical != 0, std::string(extDataPtr, extDataSize))));
-
-		*p = end_ext_octet;
+			std::make_pair(entry.m_oid.ToString(),
+				std::make_pair(entry.m_isCritical, entry.m_value.ToString())));
 	}
 
 	return extMap;
@@ -749,78 +698,30 @@ std::pair<bool, std::string> X509Cert::GetCurrV3Extension(const std::string & oi
 {
 	NullCheck();
 
-	int mbedRet = 0;
-	int is_critical = 0;
-	size_t len = 0;
-
-	unsigned char *end_ext_data = nullptr;
-	unsigned char *end_ext_octet = nullptr;
-
-	unsigned char *begin = Get()->v3_ext.p;
-	const unsigned char *end = Get()->v3_ext.p + Get()->v3_ext.len;
-
-	unsigned char **p = &begin;
-
-	char* oidPtr = nullptr;
-	size_t oidSize = 0;
-
-	char* extDataPtr = nullptr;
-	size_t extDataSize = 0;
-
-	CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end, &len, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE);
-	if (*p + len != end)
+	const V3ExtEntry* entry = FindCurrV3Extension(oid);
+	if (!entry)
 	{
-		throw MbedTlsException("GetCurrV3Extensions", MBEDTLS_ERR_ASN1_INVALID_LENGTH);
+		throw RuntimeException("The given OID is not found in the extension list.");
 	}
 
-	while (*p < end)
-	{
-		is_critical = 0; /* DEFAULT FALSE */
-
-		CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end, &len, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE);
-
-		end_ext_data = *p + len;
-
-		/* Get extension ID */
-		CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end_ext_data, &len, MBEDTLS_ASN1_OID);
+	return std::make_pair(entry->m_isCritical, entry->m_value.ToString());
+}
 
-		oidPtr = reinterpret_cast<char*>(*p);
-		oidSize = len;
+const std::vector<X509Cert::V3ExtEntry>& X509Cert::GetCurrV3ExtIndex() const noexcept
+{
+	return m_currExtIndex;
+}
 
-		if (oidSize == oid.size() &&
-			std::memcmp(oidPtr, oid.c_str(), oid.size()) == 0)
+const X509Cert::V3ExtEntry* X509Cert::FindCurrV3Extension(const Decent::Tools::StrView & oid) const noexcept
+{
+	for (const V3ExtEntry& entry : m_currExtIndex)
+	{
+		if (entry.m_oid == oid)
 		{
-			// The extension with given OID is found.
-
-			*p += len;
-
-			/* Get optional critical */
-			mbedRet = mbedtls_asn1_get_bool(p, end_ext_data, &is_critical);
-			if (mbedRet != MBEDTLS_SUCCESS_RET && mbedRet != MBEDTLS_ERR_ASN1_UNEXPECTED_TAG)
-			{
-				throw MbedTlsException("mbedtls_asn1_get_bool", mbedRet);
-			}
-
-			/* Data should be octet string type */
-			CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end_ext_data, &len, MBEDTLS_ASN1_OCTET_STRING);
-
-			extDataPtr = reinterpret_cast<char*>(*p);
-			extDataSize = len;
-
-			end_ext_octet = *p + len;
-
-			if (end_ext_octet != end_ext_data)
-			{
-				throw MbedTlsException("GetCurrV3Extensions", MBEDTLS_ERR_ASN1_INVALID_LENGTH);
-			}
-
-			return std::make_pair(is_critical != 0, std::string(extDataPtr, extDataSize));
+			return &entry;
 		}
-
-		*p = end_ext_data;
 	}
-
-	throw RuntimeException("The given OID is not found in the extension list.");
+	return nullptr;
 }
 
 void X509Cert::VerifyChainWithCa(X509Cert & ca, mbedtls_x509_crl * crl, const char * cn, uint32_t & flags,
@@ -899,6 +800,7 @@ bool X509Cert::NextCert()
 	{
 		m_certStack.push_back(m_currCert);
 		m_currCert = m_currCert->next;
+		BuildCurrV3ExtIndex();
 		return true;
 	}
 	return false;
@@ -910,6 +812,7 @@ bool X509Cert::PrevCert()
 	{
 		m_currCert = m_certStack.back();
 		m_certStack.pop_back();
+		BuildCurrV3ExtIndex();
 		return true;
 	}
 	return false;
@@ -919,6 +822,7 @@ void X509Cert::GoToFirstCert()
 {
 	m_currCert = Get();
 	m_certStack.resize(0);
+	BuildCurrV3ExtIndex();
 }
 
 void X509Cert::GoToLastCert()
@@ -929,7 +833,8 @@ void X509Cert::GoToLastCert()
 X509Cert::X509Cert() :
 	ObjBase(new mbedtls_x509_crt, &FreeObject),
 	m_currCert(Get()),
-	m_certStack()
+	m_certStack(),
+	m_currExtIndex()
 {
 	mbedtls_x509_crt_init(Get());
 }
@@ -937,6 +842,85 @@ X509Cert::X509Cert() :
 X509Cert::X509Cert(mbedtls_x509_crt * ptr, FreeFuncType freeFunc) :
 	ObjBase(ptr, freeFunc),
 	m_currCert(Get()),
-	m_certStack()
+	m_certStack(),
+	m_currExtIndex()
+{
+	BuildCurrV3ExtIndex();
+}
+
+void X509Cert::ParseV3Extensions(const uint8_t * ptr, size_t size, std::vector<V3ExtEntry>& out)
 {
+	int mbedRet = 0;
+	int is_critical = 0;
+	size_t len = 0;
+
+	unsigned char *end_ext_data = nullptr;
+	unsigned char *end_ext_octet = nullptr;
+
+	unsigned char *begin = const_cast<unsigned char*>(ptr);
+	const unsigned char *end = ptr + size;
+
+	unsigned char **p = &begin;
+
+	const char* oidPtr = nullptr;
+	size_t oidSize = 0;
+
+	CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end, &len, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE);
+	if (*p + len != end)
+	{
+		throw MbedTlsException("ParseV3Extensions", MBEDTLS_ERR_ASN1_INVALID_LENGTH);
+	}
+
+	while (*p < end)
+	{
+		is_critical = 0; /* DEFAULT FALSE */
+
+		CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end, &len, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE);
+
+		end_ext_data = *p + len;
+
+		/* Get extension ID */
+		CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end_ext_data, &len, MBEDTLS_ASN1_OID);
+
+		oidPtr = reinterpret_cast<const char*>(*p);
+		oidSize = len;
+
+		*p += len;
+
+		/* Get optional critical */
+		mbedRet = mbedtls_asn1_get_bool(p, end_ext_data, &is_critical);
+		if (mbedRet != MBEDTLS_SUCCESS_RET && mbedRet != MBEDTLS_ERR_ASN1_UNEXPECTED_TAG)
+		{
+			throw MbedTlsException("mbedtls_asn1_get_bool", mbedRet);
+		}
+
+		/* Data should be octet string type */
+		CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, p, end_ext_data, &len, MBEDTLS_ASN1_OCTET_STRING);
+
+		end_ext_octet = *p + len;
+
+		if (end_ext_octet != end_ext_data)
+		{
+			throw MbedTlsException("ParseV3Extensions", MBEDTLS_ERR_ASN1_INVALID_LENGTH);
+		}
+
+		out.push_back(V3ExtEntry{
+			Decent::Tools::StrView(oidPtr, oidSize),
+			is_critical != 0,
+			Decent::Tools::StrView(reinterpret_cast<const char*>(*p), len) });
+
+		*p = end_ext_octet;
+	}
+}
+
+void X509Cert::BuildCurrV3ExtIndex()
+{
+	m_currExtIndex.clear();
+
+	if (GetCurr() == nullptr || GetCurr()->v3_ext.len == 0)
+	{
+		return;
+	}
+
+	ParseV3Extensions(GetCurr()->v3_ext.p, GetCurr()->v3_ext.len, m_currExtIndex);
 }
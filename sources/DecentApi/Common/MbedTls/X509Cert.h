@@ -7,6 +7,8 @@
 #include <vector>
 #include <string>
 
+#include "../Tools/StrView.h"
+
 typedef struct mbedtls_x509write_cert mbedtls_x509write_cert;
 typedef struct mbedtls_x509_crt mbedtls_x509_crt;
 typedef struct mbedtls_x509_crl mbedtls_x509_crl;
@@ -163,6 +165,29 @@ namespace Decent
 			/** \brief	Defines an alias representing the VerifyFunc used for certificate chain verification. */
 			typedef int(*VerifyFunc)(void *, mbedtls_x509_crt *, int, uint32_t *);
 
+			/**
+			 * \brief	An entry in the index of X509 V3 extensions. Both views refer to the DER buffer of
+			 * 			the certificate.
+			 */
+			struct V3ExtEntry
+			{
+				Tools::StrView m_oid;
+				bool m_isCritical;
+				Tools::StrView m_value;
+			};
+
+			/**
+			 * \brief	Parses a DER encoded X509 Extensions sequence (e.g. the V3 extensions of a
+			 * 			certificate, or the extensions of a CRL entry) in one pass, without copying.
+			 *
+			 * \exception	MbedTlsException	Thrown when the sequence is malformed.
+			 *
+			 * \param 	   	ptr 	Pointer to the beginning of the sequence (i.e. its tag).
+			 * \param 	   	size	The size of the sequence, including the tag and the length.
+			 * \param [out]	out 	The entries, which refer to the given buffer, are appended here.
+			 */
+			static void ParseV3Extensions(const uint8_t* ptr, size_t size, std::vector<V3ExtEntry>& out);
+
 		public:
 
 			/**
@@ -315,6 +340,25 @@ namespace Decent
 			 */
 			std::pair<bool, std::string> GetCurrV3Extension(const std::string& oid) const;
 
+			/**
+			 * \brief	Gets the index of X509 V3 extensions of the current certificate. The index is built
+			 * 			in one pass when the certificate is parsed (or when the current certificate is
+			 * 			switched), and it only refers to the DER buffer, without copying any extension.
+			 *
+			 * \return	The index, in the same order as the extensions in the certificate.
+			 */
+			const std::vector<V3ExtEntry>& GetCurrV3ExtIndex() const noexcept;
+
+			/**
+			 * \brief	Finds a specific X509 V3 extension of the current certificate in the index.
+			 *
+			 * \param	oid	The OID of the extension.
+			 *
+			 * \return	Null if the extension is not found, otherwise, the pointer to the entry, which is
+			 * 			valid until this instance is destructed, or the current certificate is switched.
+			 */
+			const V3ExtEntry* FindCurrV3Extension(const Tools::StrView& oid) const noexcept;
+
 			/**
 			 * \brief	Verify the certificate chain with given trusted CA(s).
 			 *
@@ -372,8 +416,12 @@ namespace Decent
 
 		private:
 
+			/** \brief	(Re-)builds the extension index for the current certificate. */
+			void BuildCurrV3ExtIndex();
+
 			mbedtls_x509_crt* m_currCert;
 			std::vector<mbedtls_x509_crt*> m_certStack;
+			std::vector<V3ExtEntry> m_currExtIndex;
 		};
 	}
 }
@@ -1,6 +1,7 @@
 #include "AesGcmCommLayer.h"
 
 #include "../Common.h"
+#include "../make_unique.h"
 
 #include "../Tools/Crypto.h"
 
@@ -19,13 +20,32 @@ namespace
 	static constexpr char const gsk_makKeyDerLabel[] = "next_maskin_key";
 }
 
+struct AesGcmCommLayer::KeyEpoch
+{
+	KeyType m_secKey;
+	KeyType m_makKey;
+	Decent::Tools::GcmPacker m_packer;
+
+	KeyEpoch(const KeyType& sKey, const KeyType& mKey) :
+		m_secKey(sKey),
+		m_makKey(mKey),
+		m_packer(m_secKey.m_key)
+	{}
+};
+
 AesGcmCommLayer::AesGcmCommLayer(const KeyType & sKey, const KeyType & mKey, ConnectionBase* connection) :
-	m_selfSecKey(sKey),
-	m_selfMakKey(mKey),
+	AesGcmCommLayer(sKey, mKey, sk_maxCounter, connection)
+{
+}
+
+AesGcmCommLayer::AesGcmCommLayer(const KeyType & sKey, const KeyType & mKey, uint64_t maxCounter, ConnectionBase* connection) :
+	m_selfKeys(Tools::make_unique<KeyEpoch>(sKey, mKey)),
+	m_selfNextKeys(),
 	m_selfAddData(),
-	m_peerSecKey(sKey),
-	m_peerMakKey(mKey),
+	m_peerKeys(Tools::make_unique<KeyEpoch>(sKey, mKey)),
+	m_peerNextKeys(),
 	m_peerAddData(),
+	m_maxCounter(maxCounter),
 	m_connection(connection),
 	m_streamBuf()
 {
@@ -34,12 +54,13 @@ AesGcmCommLayer::AesGcmCommLayer(const KeyType & sKey, const KeyType & mKey, Con
 }
 
 AesGcmCommLayer::AesGcmCommLayer(AesGcmCommLayer && other) :
-	m_selfSecKey(std::move(other.m_selfSecKey)),
-	m_selfMakKey(std::move(other.m_selfMakKey)),
+	m_selfKeys(std::move(other.m_selfKeys)),
+	m_selfNextKeys(std::move(other.m_selfNextKeys)),
 	m_selfAddData(std::move(other.m_selfAddData)),
-	m_peerSecKey(std::move(other.m_peerSecKey)),
-	m_peerMakKey(std::move(other.m_peerMakKey)),
+	m_peerKeys(std::move(other.m_peerKeys)),
+	m_peerNextKeys(std::move(other.m_peerNextKeys)),
 	m_peerAddData(std::move(other.m_peerAddData)),
+	m_maxCounter(other.m_maxCounter),
 	m_connection(other.m_connection),
 	m_streamBuf(std::move(other.m_streamBuf))
 {
@@ -61,12 +82,13 @@ AesGcmCommLayer & AesGcmCommLayer::operator=(AesGcmCommLayer && other)
 {
 	if (this != &other)
 	{
-		m_selfSecKey = std::forward<decltype(m_selfSecKey)>(other.m_selfSecKey);
-		m_selfMakKey = std::forward<decltype(m_selfMakKey)>(other.m_selfMakKey);
+		m_selfKeys = std::move(other.m_selfKeys);
+		m_selfNextKeys = std::move(other.m_selfNextKeys);
 		m_selfAddData = std::forward<decltype(m_selfAddData)>(other.m_selfAddData);
-		m_peerSecKey = std::forward<decltype(m_peerSecKey)>(other.m_peerSecKey);
-		m_peerMakKey = std::forward<decltype(m_peerMakKey)>(other.m_peerMakKey);
+		m_peerKeys = std::move(other.m_peerKeys);
+		m_peerNextKeys = std::move(other.m_peerNextKeys);
 		m_peerAddData = std::forward<decltype(m_peerAddData)>(other.m_peerAddData);
+		m_maxCounter = other.m_maxCounter;
 
 		m_connection = other.m_connection;
 		other.m_connection = nullptr;
@@ -82,7 +104,7 @@ AesGcmCommLayer & AesGcmCommLayer::operator=(AesGcmCommLayer && other)
 
 bool AesGcmCommLayer::IsValid() const
 {
-	return true;
+	return m_selfKeys && m_peerKeys;
 }
 
 size_t AesGcmCommLayer::SendRaw(const void * buf, const size_t size)
@@ -92,8 +114,7 @@ size_t AesGcmCommLayer::SendRaw(const void * buf, const size_t size)
 		throw ConnectionNotEstablished();
 	}
 
-	std::vector<uint8_t> encBlock = EncryptMsg(
-		std::vector<uint8_t>(static_cast<const uint8_t*>(buf), static_cast<const uint8_t*>(buf) + size));
+	std::vector<uint8_t> encBlock = EncryptMsg(buf, size);
 
 	m_connection->SendContainer(encBlock);
 
@@ -139,21 +160,28 @@ void AesGcmCommLayer::SetConnectionPtr(ConnectionBase& cnt)
 	m_connection = &cnt;
 }
 
+void AesGcmCommLayer::PrepareNextKeys()
+{
+	PrepareSelfNextKeys();
+	PreparePeerNextKeys();
+}
+
 std::vector<uint8_t> AesGcmCommLayer::DecryptMsg(const std::vector<uint8_t>& inMsg)
 {
 	std::vector<uint8_t> meta; //Not used here.
 	std::vector<uint8_t> res;
-	Tools::QuickAesGcmUnpack(m_peerSecKey.m_key, inMsg, m_peerAddData, meta, res, nullptr, PACK_BLOCK_SIZE);
+	m_peerKeys->m_packer.Unpack(inMsg, m_peerAddData, meta, res, nullptr, PACK_BLOCK_SIZE);
 
 	CheckPeerKeysLifetime();
 
 	return res;
 }
 
-std::vector<uint8_t> AesGcmCommLayer::EncryptMsg(const std::vector<uint8_t>& inMsg)
+std::vector<uint8_t> AesGcmCommLayer::EncryptMsg(const void* inMsg, const size_t inMsgSize)
 {
-	std::vector<uint8_t> res =
-		Tools::QuickAesGcmPack(m_selfSecKey.m_key, std::array<uint8_t, 0>(), std::array<uint8_t, 0>(), inMsg, m_selfAddData, nullptr, PACK_BLOCK_SIZE);
+	using namespace ArrayPtrAndSize;
+	std::vector<uint8_t> res = m_selfKeys->m_packer.Pack(nullptr, 0, nullptr, 0, inMsg, inMsgSize,
+		GetPtr(m_selfAddData), GetSize(m_selfAddData), nullptr, PACK_BLOCK_SIZE);
 
 	CheckSelfKeysLifetime();
 
@@ -162,68 +190,95 @@ std::vector<uint8_t> AesGcmCommLayer::EncryptMsg(const std::vector<uint8_t>& inM
 
 void AesGcmCommLayer::CheckSelfKeysLifetime()
 {
-	if (m_selfAddData[2] >= sk_maxCounter)
+	if (m_selfAddData[2] >= m_maxCounter)
 	{
 		RefreshSelfKeys();
 	}
 	else
 	{
 		++m_selfAddData[2];
+
+		//Derive the next keys in the middle of the epoch, rather than at the rotation.
+		if (!m_selfNextKeys && m_selfAddData[2] >= (m_maxCounter / 2))
+		{
+			PrepareSelfNextKeys();
+		}
 	}
 }
 
 void AesGcmCommLayer::CheckPeerKeysLifetime()
 {
-	if (m_peerAddData[2] >= sk_maxCounter)
+	if (m_peerAddData[2] >= m_maxCounter)
 	{
 		RefreshPeerKeys();
 	}
 	else
 	{
 		++m_peerAddData[2];
+
+		//Derive the next keys in the middle of the epoch, rather than at the rotation.
+		if (!m_peerNextKeys && m_peerAddData[2] >= (m_maxCounter / 2))
+		{
+			PreparePeerNextKeys();
+		}
 	}
 }
 
 void AesGcmCommLayer::RefreshSelfKeys()
 {
-	using namespace Decent::MbedTlsObj;
-
-	KeyType tmpSecKey;
-	KeyType tmpMakKey;
+	PrepareSelfNextKeys();
 
-	HKDF<HashType::SHA256>(m_selfSecKey.m_key, gsk_secKeyDerLabel, std::array<uint8_t, 0>(), tmpSecKey.m_key);
-	HKDF<HashType::SHA256>(m_selfMakKey.m_key, gsk_makKeyDerLabel, std::array<uint8_t, 0>(), tmpMakKey.m_key);
-
-	m_selfSecKey = tmpSecKey;
-	m_selfMakKey = tmpMakKey;
+	m_selfKeys = std::move(m_selfNextKeys);
 
 	RefreshSelfAddData();
 }
 
 void AesGcmCommLayer::RefreshPeerKeys()
+{
+	PreparePeerNextKeys();
+
+	m_peerKeys = std::move(m_peerNextKeys);
+
+	RefreshPeerAddData();
+}
+
+void AesGcmCommLayer::PrepareSelfNextKeys()
+{
+	if (!m_selfNextKeys)
+	{
+		m_selfNextKeys = DeriveNextEpoch(*m_selfKeys);
+	}
+}
+
+void AesGcmCommLayer::PreparePeerNextKeys()
+{
+	if (!m_peerNextKeys)
+	{
+		m_peerNextKeys = DeriveNextEpoch(*m_peerKeys);
+	}
+}
+
+std::unique_ptr<AesGcmCommLayer::KeyEpoch> AesGcmCommLayer::DeriveNextEpoch(const KeyEpoch & curr)
 {
 	using namespace Decent::MbedTlsObj;
 
 	KeyType tmpSecKey;
 	KeyType tmpMakKey;
 
-	HKDF<HashType::SHA256>(m_peerSecKey.m_key, gsk_secKeyDerLabel, std::array<uint8_t, 0>(), tmpSecKey.m_key);
-	HKDF<HashType::SHA256>(m_peerMakKey.m_key, gsk_makKeyDerLabel, std::array<uint8_t, 0>(), tmpMakKey.m_key);
+	HKDF<HashType::SHA256>(curr.m_secKey.m_key, gsk_secKeyDerLabel, std::array<uint8_t, 0>(), tmpSecKey.m_key);
+	HKDF<HashType::SHA256>(curr.m_makKey.m_key, gsk_makKeyDerLabel, std::array<uint8_t, 0>(), tmpMakKey.m_key);
 
-	m_peerSecKey = tmpSecKey;
-	m_peerMakKey = tmpMakKey;
-
-	RefreshPeerAddData();
+	return Tools::make_unique<KeyEpoch>(tmpSecKey, tmpMakKey);
 }
 
 void AesGcmCommLayer::RefreshSelfAddData()
 {
 	static_assert(
 		(sizeof(decltype(m_selfAddData)::value_type) * std::tuple_size<decltype(m_selfAddData)>::value) ==
-		(decltype(m_selfMakKey)::GetTotalSize() + sizeof(decltype(m_selfAddData)::value_type)),
+		(KeyType::GetTotalSize() + sizeof(decltype(m_selfAddData)::value_type)),
 		"The size of additional data doesn't match the size actually needed.");
 
-	std::memcpy(m_selfAddData.data(), m_selfMakKey.m_key.data(), decltype(m_selfMakKey)::GetTotalSize());
+	std::memcpy(m_selfAddData.data(), m_selfKeys->m_makKey.m_key.data(), KeyType::GetTotalSize());
 
 	static_assert(std::tuple_size<decltype(m_selfAddData)>::value == 3, "The length of addtional data is too small.");
 
@@ -234,10 +289,10 @@ void AesGcmCommLayer::RefreshPeerAddData()
 {
 	static_assert(
 		(sizeof(decltype(m_peerAddData)::value_type) * std::tuple_size<decltype(m_peerAddData)>::value) ==
-		(decltype(m_peerMakKey)::GetTotalSize() + sizeof(decltype(m_peerAddData)::value_type)),
+		(KeyType::GetTotalSize() + sizeof(decltype(m_peerAddData)::value_type)),
 		"The size of additional data doesn't match the size actually needed.");
 
-	std::memcpy(m_peerAddData.data(), m_peerMakKey.m_key.data(), decltype(m_peerMakKey)::GetTotalSize());
+	std::memcpy(m_peerAddData.data(), m_peerKeys->m_makKey.m_key.data(), KeyType::GetTotalSize());
 
 	static_assert(std::tuple_size<decltype(m_peerAddData)>::value == 3, "The length of addtional data is too small.");
 
@@ -1,14 +1,22 @@
 #pragma once
 
+#include <memory>
+
 #include "SecureCommLayer.h"
 
 #include "../GeneralKeyTypes.h"
+#include "../Tools/Crypto.h"
 
 namespace Decent
 {
 	namespace Net
 	{
-		/** \brief	The communications layer that uses 128-bit AES-GCM encryption. */
+		/**
+		 * \brief	The communications layer that uses 128-bit AES-GCM encryption. Keys are rotated once
+		 * 			the message counter reaches the maximum; the keys (and the GCM context) of the next
+		 * 			epoch are derived ahead of time, once half of the counter is used, so that the
+		 * 			rotation itself is only a pointer swap.
+		 */
 		class AesGcmCommLayer : public SecureCommLayer
 		{
 		public: //static members:
@@ -26,6 +34,17 @@ namespace Decent
 			 */
 			AesGcmCommLayer(const KeyType& sKey, const KeyType& mKey, ConnectionBase* connection);
 
+			/**
+			 * \brief	Constructor
+			 *
+			 * \param 		  	sKey	  	128-bit key used for AES-GCM encryption.
+			 * \param 		  	mKey	  	128-bit masking key used as the additional data.
+			 * \param 		  	maxCounter	The maximum message counter, after which the keys are
+			 * 								rotated. It must be the same on both sides of the channel.
+			 * \param [in,out]	connection	The connection.
+			 */
+			AesGcmCommLayer(const KeyType& sKey, const KeyType& mKey, uint64_t maxCounter, ConnectionBase* connection);
+
 			//Copy is prohibited. 
 			AesGcmCommLayer(const AesGcmCommLayer& other) = delete;
 
@@ -68,6 +87,19 @@ namespace Decent
 
 			virtual void SetConnectionPtr(ConnectionBase& cnt) override;
 
+			/**
+			 * \brief	Derives the keys of the next epoch now, if they are not derived yet. This can be
+			 * 			called when the channel is idle, so that no message needs to pay for it.
+			 */
+			virtual void PrepareNextKeys();
+
+			/**
+			 * \brief	Gets the maximum message counter, after which the keys are rotated.
+			 *
+			 * \return	The maximum message counter.
+			 */
+			uint64_t GetMaxCounter() const noexcept { return m_maxCounter; }
+
 		protected: // Methods:
 
 			/**
@@ -84,11 +116,12 @@ namespace Decent
 			 *
 			 * \exception Decent::Net::Exception
 			 *
-			 * \param 	inMsg	Input message (plain text).
+			 * \param 	inMsg	 	Input message (plain text).
+			 * \param 	inMsgSize	Size of the input message.
 			 *
 			 * \return	Output message in binary (cipher text).
 			 */
-			virtual std::vector<uint8_t> EncryptMsg(const std::vector<uint8_t>& inMsg);
+			virtual std::vector<uint8_t> EncryptMsg(const void* inMsg, const size_t inMsgSize);
 
 			virtual void CheckSelfKeysLifetime();
 
@@ -98,7 +131,21 @@ namespace Decent
 
 			virtual void RefreshPeerKeys();
 
+			virtual void PrepareSelfNextKeys();
+
+			virtual void PreparePeerNextKeys();
+
 		private:
+			struct KeyEpoch;
+
+			/**
+			 * \brief	Derives the keys of the epoch after the given one.
+			 *
+			 * \param	curr	The current epoch.
+			 *
+			 * \return	The next epoch.
+			 */
+			static std::unique_ptr<KeyEpoch> DeriveNextEpoch(const KeyEpoch& curr);
 
 			/** \brief	Refresh self add data. USED BY THE CONSTRUCTOR, CANNOT BE VIRTUAL! */
 			void RefreshSelfAddData();
@@ -107,13 +154,15 @@ namespace Decent
 			void RefreshPeerAddData();
 
 		private:
-			KeyType m_selfSecKey; //Secret Key
-			KeyType m_selfMakKey; //Masking Key
-			std::array<uint64_t, 3> m_selfAddData; //Additonal Data for MAC (m_selfMakKey || MsgCounter)
+			std::unique_ptr<KeyEpoch> m_selfKeys; //Secret Key, Masking Key, and GCM keyed by the secret key
+			std::unique_ptr<KeyEpoch> m_selfNextKeys; //Null until it's derived
+			std::array<uint64_t, 3> m_selfAddData; //Additonal Data for MAC (Masking Key || MsgCounter)
+
+			std::unique_ptr<KeyEpoch> m_peerKeys; //Secret Key, Masking Key, and GCM keyed by the secret key
+			std::unique_ptr<KeyEpoch> m_peerNextKeys; //Null until it's derived
+			std::array<uint64_t, 3> m_peerAddData; //Additonal Data for MAC (Masking Key || MsgCounter)
 
-			KeyType m_peerSecKey; //Secret Key
-			KeyType m_peerMakKey; //Masking Key
-			std::array<uint64_t, 3> m_peerAddData; //Additonal Data for MAC (m_peerMakKey || MsgCounter)
+			uint64_t m_maxCounter;
 
 			ConnectionBase* m_connection;
 
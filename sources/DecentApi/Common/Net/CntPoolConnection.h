@@ -37,6 +37,16 @@ namespace Decent
 				return m_cntPtr->SendRawAll(dataPtr, size);
 			}
 
+			virtual size_t SendRawV(const ConstBufferItem* items, const size_t count) override
+			{
+				return m_cntPtr->SendRawV(items, count);
+			}
+
+			virtual void SendRawVAll(ConstBufferItem* items, const size_t count) override
+			{
+				return m_cntPtr->SendRawVAll(items, count);
+			}
+
 			virtual void SendPack(const void* const dataPtr, const size_t size) override
 			{
 				return m_cntPtr->SendPack(dataPtr, size);
@@ -53,6 +63,16 @@ namespace Decent
 				return m_cntPtr->RecvRawAll(bufPtr, size);
 			}
 
+			virtual size_t RecvRawV(const MutableBufferItem* items, const size_t count) override
+			{
+				return m_cntPtr->RecvRawV(items, count);
+			}
+
+			virtual void RecvRawVAll(MutableBufferItem* items, const size_t count) override
+			{
+				return m_cntPtr->RecvRawVAll(items, count);
+			}
+
 			virtual size_t RecvPack(uint8_t*& dest) override
 			{
 				return m_cntPtr->RecvPack(dest);
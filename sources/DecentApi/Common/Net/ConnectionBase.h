@@ -12,6 +12,20 @@ namespace Decent
 {
 	namespace Net
 	{
+		/** \brief	An item in a list of read-only buffers (i.e. the input of a gather-write). */
+		struct ConstBufferItem
+		{
+			const void* m_ptr;
+			size_t m_size;
+		};
+
+		/** \brief	An item in a list of writable buffers (i.e. the output of a scatter-read). */
+		struct MutableBufferItem
+		{
+			void* m_ptr;
+			size_t m_size;
+		};
+
 		class ConnectionBase
 		{
 		public: //static members:
@@ -86,9 +100,62 @@ namespace Decent
 				}
 			}
 
+			/**
+			 * \brief	Sends raw data from a list of buffers, in order (i.e. gather-write). By default, only
+			 * 			the first non-empty buffer is sent with SendRaw; connections that support vectored I/O
+			 * 			should override it, so that all buffers are sent with one system call. It's not
+			 * 			guaranteed that all the data will be sent out.
+			 *
+			 * \exception	Decent::Net::Exception	.
+			 *
+			 * \param	items	The list of buffers.
+			 * \param	count	Number of items in the list.
+			 *
+			 * \return	A size_t. The size of data has been sent.
+			 */
+			virtual size_t SendRawV(const ConstBufferItem* items, const size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (items[i].m_size > 0)
+					{
+						return SendRaw(items[i].m_ptr, items[i].m_size);
+					}
+				}
+				return 0;
+			}
+
+			/**
+			 * \brief	Sends all data in a list of buffers. This function will keep calling SendRawV until
+			 * 			all the data has been sent out. Exceptions from SendRawV will be thrown directly.
+			 *
+			 * \exception	Decent::Net::Exception	.
+			 *
+			 * \param [in,out]	items	The list of buffers. Items will be modified to track the progress.
+			 * \param 		  	count	Number of items in the list.
+			 */
+			virtual void SendRawVAll(ConstBufferItem* items, const size_t count)
+			{
+				size_t idx = 0;
+				while (idx < count)
+				{
+					size_t sentSize = SendRawV(items + idx, count - idx);
+					for (; idx < count && sentSize >= items[idx].m_size; ++idx)
+					{
+						sentSize -= items[idx].m_size;
+					}
+					if (idx < count)
+					{
+						items[idx].m_ptr = static_cast<const uint8_t*>(items[idx].m_ptr) + sentSize;
+						items[idx].m_size -= sentSize;
+					}
+				}
+			}
+
 			/**
 			 * \brief	Sends a package of message. The size of the package is sent first, so that receiver
-			 * 			can distinguish different packages.
+			 * 			can distinguish different packages. The size and the data are sent together with
+			 * 			SendRawVAll.
 			 *
 			 * \exception	Decent::Net::Exception	.
 			 *
@@ -98,8 +165,12 @@ namespace Decent
 			virtual void SendPack(const void* const dataPtr, const size_t size)
 			{
 				uint64_t packSize = size;
-				SendRawAll(&packSize, sizeof(uint64_t));
-				SendRawAll(dataPtr, packSize);
+				ConstBufferItem items[] =
+				{
+					ConstBufferItem{ &packSize, sizeof(uint64_t) },
+					ConstBufferItem{ dataPtr, size },
+				};
+				SendRawVAll(items, sizeof(items) / sizeof(ConstBufferItem));
 			}
 
 			/**
@@ -172,6 +243,59 @@ namespace Decent
 				}
 			}
 
+			/**
+			 * \brief	Receive raw data into a list of buffers, in order (i.e. scatter-read). By default,
+			 * 			only the first non-empty buffer is filled with RecvRaw; connections that support
+			 * 			vectored I/O should override it. It's not guaranteed that all the buffers will be
+			 * 			filled.
+			 *
+			 * \exception	Decent::Net::Exception	.
+			 *
+			 * \param	items	The list of buffers.
+			 * \param	count	Number of items in the list.
+			 *
+			 * \return	A size_t. The size of data has been received.
+			 */
+			virtual size_t RecvRawV(const MutableBufferItem* items, const size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (items[i].m_size > 0)
+					{
+						return RecvRaw(items[i].m_ptr, items[i].m_size);
+					}
+				}
+				return 0;
+			}
+
+			/**
+			 * \brief	Receive data until all buffers in the list are filled. This function will keep calling
+			 * 			RecvRawV until all the data has been received. Exceptions from RecvRawV will be thrown
+			 * 			directly.
+			 *
+			 * \exception	Decent::Net::Exception	.
+			 *
+			 * \param [in,out]	items	The list of buffers. Items will be modified to track the progress.
+			 * \param 		  	count	Number of items in the list.
+			 */
+			virtual void RecvRawVAll(MutableBufferItem* items, const size_t count)
+			{
+				size_t idx = 0;
+				while (idx < count)
+				{
+					size_t recvSize = RecvRawV(items + idx, count - idx);
+					for (; idx < count && recvSize >= items[idx].m_size; ++idx)
+					{
+						recvSize -= items[idx].m_size;
+					}
+					if (idx < count)
+					{
+						items[idx].m_ptr = static_cast<uint8_t*>(items[idx].m_ptr) + recvSize;
+						items[idx].m_size -= recvSize;
+					}
+				}
+			}
+
 			/**
 			 * \brief	Receive a package of message. It receives the size of the package first, so it knows
 			 * 			how much data to receive. Note: The sender must send the size of package first (e.g.
@@ -78,6 +78,18 @@ namespace Decent
 				return std::make_pair(GetNew(fallbackAddr), fallbackAddr);
 			}
 
+			/**
+			 * \brief	Establishes a new connection to the given address. Implementations should connect
+			 * 			with a bounded timeout, so that a dead peer is reported by
+			 * 			Decent::Net::TimeoutException quickly, and the caller can retry with other peers.
+			 *
+			 * \exception	Decent::Net::TimeoutException	Thrown when the peer does not respond in time.
+			 * \exception	Decent::Net::Exception			Thrown when the connection can't be established.
+			 *
+			 * \param	addr	The address.
+			 *
+			 * \return	A std::unique_ptr&lt;ConnectionBase&gt;
+			 */
 			virtual std::unique_ptr<ConnectionBase> GetNew(const MapKeyType& addr) = 0;
 
 			/**
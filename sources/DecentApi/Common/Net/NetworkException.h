@@ -43,5 +43,17 @@ namespace Decent
 				Exception("The connection has not established!")
 			{}
 		};
+
+		class TimeoutException : public Exception
+		{
+		public:
+			TimeoutException() :
+				Exception("The network operation has timed out!")
+			{}
+
+			explicit TimeoutException(const std::string& what_arg) :
+				Exception(what_arg)
+			{}
+		};
 	}
 }
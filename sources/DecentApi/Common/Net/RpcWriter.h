@@ -103,7 +103,8 @@ namespace Decent
 				return end();
 			}
 
-			std::vector<uint8_t>::iterator Set(const std::vector<uint8_t>& input)
+			template<typename ContainerType>
+			std::vector<uint8_t>::iterator Set(const ContainerType& input)
 			{
 				if (static_cast<size_t>(std::distance(begin(), end())) < input.size())
 				{
@@ -2,6 +2,11 @@
 
 #include "SecureConnectionPoolBase.h"
 
+#include <map>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
 #include "../make_unique.h"
 #include "../Tools/CachingQueue.h"
 
@@ -17,36 +22,59 @@ namespace Decent
 		template<typename MapKeyType>
 		class SecureConnectionPool : public SecureConnectionPoolBase
 		{
+		public: //static member:
+
+			/**
+			 * \brief	A function that runs the given task asynchronously (e.g. by adding it to a thread
+			 * 			pool). Every task given must be eventually run, or an exception must be thrown.
+			 */
+			typedef std::function<void(std::function<void()>)> AsyncRunner;
+
 		public:
 			SecureConnectionPool(size_t maxInCnt, size_t maxOutCnt) :
 				SecureConnectionPoolBase(maxInCnt),
-				m_cachingQueue(maxOutCnt)
+				m_cachingQueue(maxOutCnt),
+				m_preWarmMutex(),
+				m_preWarmCond(),
+				m_asyncRunner(),
+				m_hotPeers(),
+				m_inflightCount(0),
+				m_isPreWarmStopped(false)
 			{}
 
+			/**
+			 * \brief	Destructor. Derived classes that implement GetNew must call StopPreWarming in their
+			 * 			own destructor, since in-flight pre-warming tasks may still call GetNew.
+			 */
 			virtual ~SecureConnectionPool()
-			{}
+			{
+				StopPreWarming();
+			}
 
 			virtual void Put(const MapKeyType& addr, CntPair&& cntPair)
 			{
 				try
 				{
 					SecureConnectionPoolBase::ClientAckKeepAlive(cntPair);
+					m_cachingQueue.Put(addr, Tools::make_unique<PooledCntPair>(std::forward<CntPair>(cntPair), false));
 				}
-				catch (const std::exception&) { return; }
+				catch (const std::exception&) {}
 
-				m_cachingQueue.Put(addr, Tools::make_unique<CntPair>(std::forward<CntPair>(cntPair)));
+				//Either the connection is dead, or some connection may be evicted from the queue.
+				ReplenishHotPeers();
 			}
 
 			virtual CntPair Get(const MapKeyType& addr, Ra::States& state)
 			{
-				std::unique_ptr<CntPair> cntPairPtr = m_cachingQueue.Get(addr);
+				std::unique_ptr<PooledCntPair> cntPairPtr = m_cachingQueue.Get(addr);
 
 				if (cntPairPtr)
 				{
 					try
 					{
-						SecureConnectionPoolBase::ClientWakePeer(*cntPairPtr);
-						return std::move(*cntPairPtr);
+						WakeCachedCntPair(*cntPairPtr);
+						ReplenishHotPeer(addr);
+						return std::move(cntPairPtr->m_cntPair);
 					}
 					catch (const std::exception&)
 					{
@@ -55,20 +83,22 @@ namespace Decent
 				}
 
 				//When no connection in cache, or peer closed connection.
+				ReplenishHotPeer(addr);
 				return GetNew(addr, state);
 			}
 
 			virtual CntPair GetAny(const MapKeyType& fallbackAddr, Ra::States& state, MapKeyType& cntedAddr)
 			{
-				std::pair<std::unique_ptr<CntPair>, MapKeyType> cntPairPtr = m_cachingQueue.GetAnyRecentlyAdded();
+				std::pair<std::unique_ptr<PooledCntPair>, MapKeyType> cntPairPtr = m_cachingQueue.GetAnyRecentlyAdded();
 
 				if (cntPairPtr.first)
 				{
 					try
 					{
-						SecureConnectionPoolBase::ClientWakePeer(*cntPairPtr.first);
+						WakeCachedCntPair(*cntPairPtr.first);
 						cntedAddr = cntPairPtr.second;
-						return std::move(*cntPairPtr.first);
+						ReplenishHotPeer(cntedAddr);
+						return std::move(cntPairPtr.first->m_cntPair);
 					}
 					catch (const std::exception&)
 					{
@@ -83,6 +113,93 @@ namespace Decent
 
 			virtual CntPair GetNew(const MapKeyType& addr, Ra::States& state) = 0;
 
+			/**
+			 * \brief	Establishes new connections (including TLS handshake and RA verification) to the
+			 * 			given peer, and puts them in the pool, so that later Get calls do not pay the
+			 * 			handshake latency. This function is synchronous, and never exceeds the capacity of
+			 * 			the pool.
+			 *
+			 * \param	addr 	The address of the peer.
+			 * \param	state	The Decent state.
+			 * \param	count	Number of connections to establish.
+			 *
+			 * \return	Number of connections actually established.
+			 */
+			virtual size_t PreWarm(const MapKeyType& addr, Ra::States& state, size_t count)
+			{
+				size_t res = 0;
+				for (; res < count && GetCurrentOutConnectionCount() < GetMaxOutConnection(); ++res)
+				{
+					try
+					{
+						PutFresh(addr, GetNew(addr, state));
+					}
+					catch (const std::exception&)
+					{
+						break;
+					}
+				}
+				return res;
+			}
+
+			/**
+			 * \brief	Sets the runner used to replenish connections to hot peers in background. If no
+			 * 			runner is set, hot peers are not replenished.
+			 *
+			 * \param	runner	The runner.
+			 */
+			virtual void SetAsyncRunner(AsyncRunner runner)
+			{
+				std::unique_lock<std::mutex> preWarmLock(m_preWarmMutex);
+				m_asyncRunner = runner;
+			}
+
+			/**
+			 * \brief	Marks a peer as hot. The pool will keep at least minReady ready, already-attested
+			 * 			connections to this peer, as long as the capacity of the pool allows. Connections
+			 * 			are replenished in background (see SetAsyncRunner) whenever a connection is taken,
+			 * 			fails to return, or is evicted.
+			 *
+			 * \param	addr		The address of the peer.
+			 * \param	state   	The Decent state used to establish connections. It must stay alive
+			 * 						as long as the peer is hot.
+			 * \param	minReady	The minimum number of ready connections.
+			 */
+			virtual void SetHotPeer(const MapKeyType& addr, Ra::States& state, size_t minReady)
+			{
+				{
+					std::unique_lock<std::mutex> preWarmLock(m_preWarmMutex);
+					HotPeerInfo& info = m_hotPeers[addr];
+					info.m_state = &state;
+					info.m_minReady = minReady;
+				}
+				ReplenishHotPeer(addr);
+			}
+
+			/**
+			 * \brief	Removes a peer from the hot peer list. Connections already in the pool are kept.
+			 *
+			 * \param	addr	The address of the peer.
+			 */
+			virtual void RemoveHotPeer(const MapKeyType& addr)
+			{
+				std::unique_lock<std::mutex> preWarmLock(m_preWarmMutex);
+				auto it = m_hotPeers.find(addr);
+				if (it != m_hotPeers.end())
+				{
+					//In-flight tasks still need the count, thus, only the target is cleared.
+					it->second.m_minReady = 0;
+				}
+			}
+
+			/** \brief	Stops background pre-warming, and waits for all in-flight tasks to finish. */
+			virtual void StopPreWarming()
+			{
+				std::unique_lock<std::mutex> preWarmLock(m_preWarmMutex);
+				m_isPreWarmStopped = true;
+				m_preWarmCond.wait(preWarmLock, [this]() { return m_inflightCount == 0; });
+			}
+
 			/**
 			* \brief	Gets maximum number of out-coming connection.
 			*
@@ -97,8 +214,147 @@ namespace Decent
 			*/
 			uint64_t GetCurrentOutConnectionCount() const noexcept { return m_cachingQueue.GetCurrentCachedCount(); }
 
+		protected:
+			struct PooledCntPair
+			{
+				PooledCntPair(CntPair&& cntPair, bool isFresh) :
+					m_cntPair(std::forward<CntPair>(cntPair)),
+					m_isFresh(isFresh)
+				{}
+
+				CntPair m_cntPair;
+
+				//A fresh connection has never been used, thus, the peer is not waiting for wake-up message.
+				bool m_isFresh;
+			};
+
+			struct HotPeerInfo
+			{
+				HotPeerInfo() :
+					m_state(nullptr),
+					m_minReady(0),
+					m_inflight(0)
+				{}
+
+				Ra::States* m_state;
+				size_t m_minReady;
+				size_t m_inflight;
+			};
+
+			static void WakeCachedCntPair(PooledCntPair& pooledCnt)
+			{
+				if (!pooledCnt.m_isFresh)
+				{
+					SecureConnectionPoolBase::ClientWakePeer(pooledCnt.m_cntPair);
+				}
+			}
+
+			virtual void PutFresh(const MapKeyType& addr, CntPair&& cntPair)
+			{
+				m_cachingQueue.Put(addr, Tools::make_unique<PooledCntPair>(std::forward<CntPair>(cntPair), true));
+			}
+
+			virtual void ReplenishHotPeers()
+			{
+				std::vector<MapKeyType> addrs;
+				{
+					std::unique_lock<std::mutex> preWarmLock(m_preWarmMutex);
+					if (m_isPreWarmStopped || !m_asyncRunner)
+					{
+						return;
+					}
+					for (const auto& item : m_hotPeers)
+					{
+						addrs.push_back(item.first);
+					}
+				}
+
+				for (const MapKeyType& addr : addrs)
+				{
+					ReplenishHotPeer(addr);
+				}
+			}
+
+			virtual void ReplenishHotPeer(const MapKeyType& addr)
+			{
+				AsyncRunner runner;
+				Ra::States* state = nullptr;
+				size_t toCreate = 0;
+				{
+					std::unique_lock<std::mutex> preWarmLock(m_preWarmMutex);
+					auto it = m_hotPeers.find(addr);
+					if (m_isPreWarmStopped || !m_asyncRunner || it == m_hotPeers.end())
+					{
+						return;
+					}
+
+					const size_t ready = m_cachingQueue.GetCachedCount(addr) + it->second.m_inflight;
+					const uint64_t total = m_cachingQueue.GetCurrentCachedCount() + m_inflightCount;
+					const size_t capacity = GetMaxOutConnection();
+
+					const size_t needed = ready < it->second.m_minReady ? it->second.m_minReady - ready : 0;
+					const size_t allowed = total < capacity ? static_cast<size_t>(capacity - total) : 0;
+					toCreate = needed < allowed ? needed : allowed;
+
+					it->second.m_inflight += toCreate;
+					m_inflightCount += toCreate;
+					runner = m_asyncRunner;
+					state = it->second.m_state;
+				}
+
+				for (size_t i = 0; i < toCreate; ++i)
+				{
+					try
+					{
+						runner([this, addr, state]()
+						{
+							try
+							{
+								if (!IsPreWarmStopped())
+								{
+									PutFresh(addr, GetNew(addr, *state));
+								}
+							}
+							catch (const std::exception&)
+							{} //Peer is not available for now; it will be retried in next replenishment.
+
+							FinishReplenish(addr);
+						});
+					}
+					catch (const std::exception&)
+					{
+						FinishReplenish(addr);
+					}
+				}
+			}
+
 		private:
-			Tools::CachingQueue<MapKeyType, CntPair> m_cachingQueue;
+			bool IsPreWarmStopped()
+			{
+				std::unique_lock<std::mutex> preWarmLock(m_preWarmMutex);
+				return m_isPreWarmStopped;
+			}
+
+			void FinishReplenish(const MapKeyType& addr)
+			{
+				std::unique_lock<std::mutex> preWarmLock(m_preWarmMutex);
+				auto it = m_hotPeers.find(addr);
+				if (it != m_hotPeers.end() && it->second.m_inflight > 0)
+				{
+					it->second.m_inflight--;
+				}
+				m_inflightCount--;
+				m_preWarmCond.notify_all();
+			}
+
+			Tools::CachingQueue<MapKeyType, PooledCntPair> m_cachingQueue;
+
+			std::mutex m_preWarmMutex;
+			std::condition_variable m_preWarmCond;
+			AsyncRunner m_asyncRunner;
+			std::map<MapKeyType, HotPeerInfo> m_hotPeers;
+			size_t m_inflightCount;
+			bool m_isPreWarmStopped;
 		};
 	}
 }
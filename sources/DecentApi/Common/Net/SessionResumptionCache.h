@@ -0,0 +1,147 @@
+#pragma once
+
+#include <ctime>
+#include <memory>
+
+#include "../Common.h"
+#include "../Tools/SharedCachingQueue.h"
+
+namespace Decent
+{
+	namespace Net
+	{
+		/**
+		 * \brief	A bounded cache of sessions that could be resumed later, where each session expires
+		 * 			after a fixed time-to-live. Once the cache is full, the least recently used session
+		 * 			is dropped. This class is thread-safe. It doesn't depend on any platform specific
+		 * 			type, so the session type could be anything that keeps the resumption secret and the
+		 * 			identity of the peer.
+		 *
+		 * 			Note: by default, the time is read from Decent::Tools::GetSystemTime, which is an
+		 * 			untrusted source inside an enclave. A host lying about the time could only extend
+		 * 			the lifetime of the resumption secrets, but never forge one.
+		 *
+		 * \tparam	KeyType	  	Type of the key used to look up the session.
+		 * \tparam	SessionType	Type of the session.
+		 */
+		template<typename KeyType, typename SessionType>
+		class SessionResumptionCache
+		{
+		public: //static members:
+			struct Entry
+			{
+				std::shared_ptr<const SessionType> m_session;
+				time_t m_expireTime;
+			};
+
+		public:
+			SessionResumptionCache() = delete;
+
+			/**
+			 * \brief	Constructor
+			 *
+			 * \param	maxCount	The maximum number of sessions kept in the cache. Zero disables the
+			 * 						cache.
+			 * \param	ttl			The time-to-live of each session, in seconds.
+			 */
+			SessionResumptionCache(size_t maxCount, time_t ttl) :
+				m_ttl(ttl),
+				m_queue(maxCount)
+			{}
+
+			SessionResumptionCache(const SessionResumptionCache& rhs) = delete;
+
+			SessionResumptionCache(SessionResumptionCache&& rhs) = delete;
+
+			virtual ~SessionResumptionCache()
+			{}
+
+			/**
+			 * \brief	Puts a session into the cache, replacing the one with the same key (if any).
+			 *
+			 * \param	key	   	The key.
+			 * \param	session	The session.
+			 */
+			virtual void Put(const KeyType& key, std::shared_ptr<const SessionType> session)
+			{
+				if (!session)
+				{
+					return;
+				}
+
+				std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+				entry->m_session = std::move(session);
+				entry->m_expireTime = GetCurrentTime() + m_ttl;
+
+				m_queue.RemoveAll(key);
+				m_queue.Put(key, std::shared_ptr<const Entry>(std::move(entry)), false);
+			}
+
+			/**
+			 * \brief	Gets a session that hasn't expired. An expired session found is removed from the
+			 * 			cache.
+			 *
+			 * \param	key	The key.
+			 *
+			 * \return	The session, or null if it's not found or expired.
+			 */
+			virtual std::shared_ptr<const SessionType> Get(const KeyType& key)
+			{
+				std::shared_ptr<const Entry> entry = m_queue.Get(key);
+				if (!entry)
+				{
+					return nullptr;
+				}
+
+				if (entry->m_expireTime <= GetCurrentTime())
+				{
+					m_queue.RemoveAll(key);
+					return nullptr;
+				}
+
+				return entry->m_session;
+			}
+
+			/**
+			 * \brief	Removes the session with the given key, e.g., when the resumption is failed.
+			 *
+			 * \param	key	The key.
+			 */
+			virtual void Remove(const KeyType& key)
+			{
+				m_queue.RemoveAll(key);
+			}
+
+			/** \brief	Removes all sessions. */
+			virtual void Clear()
+			{
+				m_queue.Clear();
+			}
+
+			/**
+			 * \brief	Gets the time-to-live of each session.
+			 *
+			 * \return	The time-to-live, in seconds.
+			 */
+			time_t GetTtl() const noexcept { return m_ttl; }
+
+		protected:
+
+			/**
+			 * \brief	Gets current time, in seconds. It can be overridden to use a different source.
+			 *
+			 * \return	The current time.
+			 */
+			virtual time_t GetCurrentTime() const
+			{
+				time_t res;
+				Tools::GetSystemTime(res);
+				return res;
+			}
+
+		private:
+			const time_t m_ttl;
+			Tools::SharedCachingQueue<KeyType, const Entry> m_queue;
+		};
+	}
+}
@@ -11,15 +11,31 @@
 
 #include "ServerX509Cert.h"
 #include "Internal/Cert.h"
+#include "WhiteList/LoadedList.h"
+#include "WhiteList/EncodedList.h"
 
 using namespace Decent::Ra;
 using namespace Decent::Tools;
 using namespace Decent::MbedTlsObj;
 
 AppX509CertWriter::AppX509CertWriter(EcPublicKeyBase & pubKey, const ServerX509Cert & svrCert, EcKeyPairBase & svrPrvKey,
-	const std::string & enclaveHash, const std::string & platformType, const std::string & appId, const std::string & whiteList) :
-	AppX509CertWriter(pubKey, static_cast<const X509Cert&>(svrCert), svrPrvKey, enclaveHash, platformType, appId, whiteList)
+	const std::string & enclaveHash, const std::string & platformType, const std::string & appId, const std::string & whiteList,
+	CertExtEncoding encoding) :
+	X509CertWriter(HashType::SHA256, svrCert, svrPrvKey, pubKey, ("CN=" + enclaveHash))
 {
+	SetAppCertFields(platformType, appId, whiteList,
+		encoding != CertExtEncoding::Json ?
+			WhiteList::LoadedList::EncodeWhiteListCompact(WhiteList::LoadedList::ParseWhiteListFromJson(whiteList)) :
+			std::string(),
+		encoding);
+}
+
+AppX509CertWriter::AppX509CertWriter(EcPublicKeyBase & pubKey, const ServerX509Cert & svrCert, EcKeyPairBase & svrPrvKey,
+	const std::string & enclaveHash, const std::string & platformType, const std::string & appId, const WhiteList::EncodedList & whiteList,
+	CertExtEncoding encoding) :
+	X509CertWriter(HashType::SHA256, svrCert, svrPrvKey, pubKey, ("CN=" + enclaveHash))
+{
+	SetAppCertFields(platformType, appId, whiteList.GetJson(), whiteList.GetCompact(), encoding);
 }
 
 AppX509CertWriter::~AppX509CertWriter()
@@ -27,8 +43,18 @@ AppX509CertWriter::~AppX509CertWriter()
 }
 
 AppX509CertWriter::AppX509CertWriter(EcPublicKeyBase & pubKey, const X509Cert & svrCert, EcKeyPairBase & svrPrvKey,
-	const std::string & enclaveHash, const std::string & platformType, const std::string & appId, const std::string & whiteList) :
+	const std::string & enclaveHash, const std::string & platformType, const std::string & appId, const WhiteList::WhiteListType & whiteList,
+	CertExtEncoding encoding) :
 	X509CertWriter(HashType::SHA256, svrCert, svrPrvKey, pubKey, ("CN=" + enclaveHash))
+{
+	SetAppCertFields(platformType, appId,
+		encoding != CertExtEncoding::Compact ? WhiteList::StaticList(whiteList).ToJsonString() : std::string(),
+		encoding != CertExtEncoding::Json ? WhiteList::LoadedList::EncodeWhiteListCompact(whiteList) : std::string(),
+		encoding);
+}
+
+void AppX509CertWriter::SetAppCertFields(const std::string & platformType, const std::string & appId,
+	const std::string & whiteListJson, const std::string & whiteListCompact, CertExtEncoding encoding)
 {
 	SetBasicConstraints(true, -1);
 	SetKeyUsage(MBEDTLS_X509_KU_NON_REPUDIATION | MBEDTLS_X509_KU_DIGITAL_SIGNATURE | MBEDTLS_X509_KU_KEY_AGREEMENT | MBEDTLS_X509_KU_KEY_CERT_SIGN | MBEDTLS_X509_KU_CRL_SIGN);
@@ -36,14 +62,20 @@ AppX509CertWriter::AppX509CertWriter(EcPublicKeyBase & pubKey, const X509Cert &
 
 	SetSerialNum(BigNumber::Rand<Drbg>(GENERAL_256BIT_32BYTE_SIZE));
 
-	SetV3Extensions(
-		std::map<std::string, std::pair<bool, std::string> >
+	std::map<std::string, std::pair<bool, std::string> > extMap
 	{
 		std::make_pair(detail::gsk_x509PlatformTypeOid, std::make_pair(false, platformType)),
-			std::make_pair(detail::gsk_x509LaIdOid, std::make_pair(false, appId)),
-			std::make_pair(detail::gsk_x509WhiteListOid, std::make_pair(false, whiteList)),
+		std::make_pair(detail::gsk_x509LaIdOid, std::make_pair(false, appId)),
+	};
+	if (encoding != CertExtEncoding::Compact)
+	{
+		extMap.insert(std::make_pair(detail::gsk_x509WhiteListOid, std::make_pair(false, whiteListJson)));
+	}
+	if (encoding != CertExtEncoding::Json)
+	{
+		extMap.insert(std::make_pair(detail::gsk_x509WhiteListBinOid, std::make_pair(false, whiteListCompact)));
 	}
-	);
+	SetV3Extensions(extMap);
 
 	time_t timerBegin;
 	GetSystemTime(timerBegin);
@@ -58,16 +90,24 @@ AppX509CertWriter::AppX509CertWriter(EcPublicKeyBase & pubKey, const X509Cert &
 }
 
 AppX509Cert::AppX509Cert(AppX509Cert && other) :
-	m_platformType(std::move(other.m_platformType)),
-	m_appId(std::move(other.m_appId)),
-	m_whiteList(std::move(other.m_whiteList))
-{}
+	X509Cert(std::forward<X509Cert>(other)),
+	m_platformType(other.m_platformType),
+	m_appId(other.m_appId),
+	m_whiteList(other.m_whiteList),
+	m_isWhiteListCompact(other.m_isWhiteListCompact)
+{
+	//Views still refer to the same certificate, which is now owned by this instance.
+	other.m_platformType = Tools::StrView();
+	other.m_appId = Tools::StrView();
+	other.m_whiteList = Tools::StrView();
+}
 
 AppX509Cert::AppX509Cert(const std::vector<uint8_t>& der) :
 	X509Cert(der),
 	m_platformType(),
 	m_appId(),
-	m_whiteList()
+	m_whiteList(),
+	m_isWhiteListCompact(false)
 {
 	ParseExtensions();
 }
@@ -76,7 +116,8 @@ AppX509Cert::AppX509Cert(const std::string & pem) :
 	X509Cert(pem),
 	m_platformType(),
 	m_appId(),
-	m_whiteList()
+	m_whiteList(),
+	m_isWhiteListCompact(false)
 {
 	ParseExtensions();
 }
@@ -85,7 +126,8 @@ AppX509Cert::AppX509Cert(mbedtls_x509_crt & cert) :
 	X509Cert(cert),
 	m_platformType(),
 	m_appId(),
-	m_whiteList()
+	m_whiteList(),
+	m_isWhiteListCompact(false)
 {
 	ParseExtensions();
 }
@@ -99,51 +141,59 @@ AppX509Cert & AppX509Cert::operator=(AppX509Cert && rhs)
 	X509Cert::operator=(std::forward<X509Cert>(rhs));
 	if (this != &rhs)
 	{
-		m_platformType = std::move(rhs.m_platformType);
-		m_appId = std::move(rhs.m_appId);
-		m_whiteList = std::move(rhs.m_whiteList);
+		m_platformType = rhs.m_platformType;
+		m_appId = rhs.m_appId;
+		m_whiteList = rhs.m_whiteList;
+		m_isWhiteListCompact = rhs.m_isWhiteListCompact;
+
+		rhs.m_platformType = Tools::StrView();
+		rhs.m_appId = Tools::StrView();
+		rhs.m_whiteList = Tools::StrView();
 	}
 	return *this;
 }
 
-const std::string & AppX509Cert::GetPlatformType() const
+const Decent::Tools::StrView & AppX509Cert::GetPlatformType() const
 {
 	return m_platformType;
 }
 
-const std::string & AppX509Cert::GetAppId() const
+const Decent::Tools::StrView & AppX509Cert::GetAppId() const
 {
 	return m_appId;
 }
 
-const std::string & AppX509Cert::GetWhiteList() const
+const Decent::Tools::StrView & AppX509Cert::GetWhiteList() const
 {
 	return m_whiteList;
 }
 
 void AppX509Cert::ParseExtensions()
 {
-	auto extMap = GetCurrV3Extensions();
-
-	auto it = extMap.find(detail::gsk_x509PlatformTypeOid);
-	if (it == extMap.end())
+	const V3ExtEntry* ext = FindCurrV3Extension(detail::gsk_x509PlatformTypeOid);
+	if (!ext)
 	{
 		throw RuntimeException("Invalid Server X509 certificate. Platform Type field is missing.");
 	}
+	m_platformType = ext->m_value;
 
-	m_platformType = std::move(it->second.second);
-
-	it = extMap.find(detail::gsk_x509LaIdOid);
-	if (it == extMap.end())
+	ext = FindCurrV3Extension(detail::gsk_x509LaIdOid);
+	if (!ext)
 	{
 		throw RuntimeException("Invalid Server X509 certificate. LA ID field is missing.");
 	}
-	m_appId = std::move(it->second.second);
+	m_appId = ext->m_value;
 
-	it = extMap.find(detail::gsk_x509WhiteListOid);
-	if (it == extMap.end())
+	//Prefer the compact encoding; the JSON one is kept for certificates issued by older versions.
+	ext = FindCurrV3Extension(detail::gsk_x509WhiteListBinOid);
+	m_isWhiteListCompact = (ext != nullptr);
+	if (!ext)
+	{
+		ext = FindCurrV3Extension(detail::gsk_x509WhiteListOid);
+	}
+	if (!ext)
 	{
 		throw RuntimeException("Invalid Server X509 certificate. Whitelist field is missing.");
 	}
-	m_whiteList = std::move(it->second.second);
+	m_whiteList = ext->m_value;
 }
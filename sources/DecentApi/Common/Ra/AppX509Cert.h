@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../MbedTls/X509Cert.h"
+#include "WhiteList/WhiteList.h"
+#include "CertExtEncoding.h"
 
 namespace Decent
 {
@@ -14,6 +16,11 @@ namespace Decent
 	{
 		class ServerX509Cert;
 
+		namespace WhiteList
+		{
+			class EncodedList;
+		}
+
 		/**
 		 * \brief	Get the default X509 verify profile used by DECENT RA (i.e. NSA suit B).
 		 *
@@ -36,10 +43,29 @@ namespace Decent
 			 * \param 		  	enclaveHash 	The hash of the DECENT App enclave.
 			 * \param 		  	platformType	Type of the platform.
 			 * \param 		  	appId			The identity of the DECENT App.
+			 * \param 		  	whiteList   	DECENT Whitelist in JSON.
+			 * \param 		  	encoding		The encoding(s) of the whitelist extension.
+			 */
+			AppX509CertWriter(MbedTlsObj::EcPublicKeyBase& pubKey, const ServerX509Cert& svrCert, MbedTlsObj::EcKeyPairBase& svrPrvKey,
+				const std::string& enclaveHash, const std::string& platformType, const std::string& appId, const std::string& whiteList,
+				CertExtEncoding encoding = CertExtEncoding::Both);
+
+			/**
+			 * \brief	Constructs DECENT App certificate, issued by DECENT Server, with a whitelist that
+			 * 			has been parsed and encoded already, so no parsing or encoding is done here.
+			 *
+			 * \param [in,out]	pubKey			The DECENT App's public key.
+			 * \param 		  	svrCert			The DECENT Server's certificate.
+			 * \param [in,out]	svrPrvKey   	The DECENT Server's key pair including the private key.
+			 * \param 		  	enclaveHash 	The hash of the DECENT App enclave.
+			 * \param 		  	platformType	Type of the platform.
+			 * \param 		  	appId			The identity of the DECENT App.
 			 * \param 		  	whiteList   	DECENT Whitelist.
+			 * \param 		  	encoding		The encoding(s) of the whitelist extension.
 			 */
 			AppX509CertWriter(MbedTlsObj::EcPublicKeyBase& pubKey, const ServerX509Cert& svrCert, MbedTlsObj::EcKeyPairBase& svrPrvKey,
-				const std::string& enclaveHash, const std::string& platformType, const std::string& appId, const std::string& whiteList);
+				const std::string& enclaveHash, const std::string& platformType, const std::string& appId, const WhiteList::EncodedList& whiteList,
+				CertExtEncoding encoding = CertExtEncoding::Both);
 
 			/** \brief	Destructor */
 			virtual ~AppX509CertWriter();
@@ -47,7 +73,22 @@ namespace Decent
 		protected:
 
 			AppX509CertWriter(MbedTlsObj::EcPublicKeyBase& pubKey, const MbedTlsObj::X509Cert& svrCert, MbedTlsObj::EcKeyPairBase& svrPrvKey,
-				const std::string& enclaveHash, const std::string& platformType, const std::string& appId, const std::string& whiteList);
+				const std::string& enclaveHash, const std::string& platformType, const std::string& appId, const WhiteList::WhiteListType& whiteList,
+				CertExtEncoding encoding = CertExtEncoding::Both);
+
+		private:
+			/**
+			 * \brief	Sets the fields of DECENT App certificate. Only the whitelist encoding(s) selected
+			 * 			are used, so the other one can be left empty.
+			 *
+			 * \param	platformType	 	Type of the platform.
+			 * \param	appId			 	The identity of the DECENT App.
+			 * \param	whiteListJson	 	The whitelist in JSON.
+			 * \param	whiteListCompact	The whitelist in the compact binary encoding.
+			 * \param	encoding		 	The encoding(s) of the whitelist extension.
+			 */
+			void SetAppCertFields(const std::string& platformType, const std::string& appId,
+				const std::string& whiteListJson, const std::string& whiteListCompact, CertExtEncoding encoding);
 		};
 
 		class AppX509Cert : public MbedTlsObj::X509Cert
@@ -71,19 +112,47 @@ namespace Decent
 
 			virtual AppX509Cert& operator=(AppX509Cert&& rhs);
 
-			const std::string& GetPlatformType() const;
+			/**
+			 * \brief	Gets platform type of the DECENT App. The view refers to the DER buffer of the
+			 * 			certificate, thus, it's valid as long as this instance.
+			 *
+			 * \return	The platform type.
+			 */
+			const Tools::StrView& GetPlatformType() const;
 
-			const std::string& GetAppId() const;
+			/**
+			 * \brief	Gets the identity of the DECENT App. The view refers to the DER buffer of the
+			 * 			certificate, thus, it's valid as long as this instance.
+			 *
+			 * \return	The App ID.
+			 */
+			const Tools::StrView& GetAppId() const;
 
-			const std::string& GetWhiteList() const;
+			/**
+			 * \brief	Gets DECENT Whitelist of the DECENT App, in JSON, or in the compact binary encoding
+			 * 			(see IsWhiteListCompact). The view refers to the DER buffer of the certificate, thus,
+			 * 			it's valid as long as this instance. WhiteList::LoadedList::ParseWhiteList decodes
+			 * 			either of them.
+			 *
+			 * \return	The whitelist.
+			 */
+			const Tools::StrView& GetWhiteList() const;
+
+			/**
+			 * \brief	Query if the whitelist is in the compact binary encoding, rather than JSON.
+			 *
+			 * \return	True if compact, false if JSON.
+			 */
+			bool IsWhiteListCompact() const { return m_isWhiteListCompact; }
 
 		private:
 
 			void ParseExtensions();
 
-			std::string m_platformType;
-			std::string m_appId;
-			std::string m_whiteList;
+			Tools::StrView m_platformType;
+			Tools::StrView m_appId;
+			Tools::StrView m_whiteList;
+			bool m_isWhiteListCompact;
 		};
 	}
 }
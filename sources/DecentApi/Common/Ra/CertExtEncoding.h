@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Decent
+{
+	namespace Ra
+	{
+		/**
+		 * \brief	The encoding of the large DECENT certificate extensions (i.e. the self-RA report and
+		 * 			the white list) written by ServerX509CertWriter and AppX509CertWriter. Each encoding
+		 * 			has its own OID. Readers accept either one, and prefer the compact one if both are
+		 * 			present; however, verifiers built before the compact encoding only understand the
+		 * 			JSON one. Thus, Both should be used while a deployment is being upgraded, and Compact
+		 * 			only once every verifier in it has been upgraded.
+		 */
+		enum class CertExtEncoding : uint8_t
+		{
+			Json    = 0,
+			Compact = 1,
+			Both    = 2,
+		};
+	}
+}
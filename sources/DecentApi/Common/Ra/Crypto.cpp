@@ -11,12 +11,12 @@
 using namespace Decent::Ra;
 using namespace Decent::Tools;
 
-std::string Decent::Ra::GetHashFromAppId(const std::string & platformType, const std::string & appIdStr)
+std::string Decent::Ra::GetHashFromAppId(const StrView & platformType, const StrView & appIdStr)
 {
 	if (platformType == RaReport::sk_ValueReportTypeSgx)
 	{
 		sgx_dh_session_enclave_identity_t appId;
-		DeserializeStruct(appId, appIdStr);
+		DeserializeStruct(appId, appIdStr.data(), appIdStr.size());
 
 		return SerializeStruct(appId.mr_enclave);
 	}
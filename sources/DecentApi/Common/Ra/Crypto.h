@@ -2,10 +2,12 @@
 
 #include <string>
 
+#include "../Tools/StrView.h"
+
 namespace Decent
 {
 	namespace Ra
 	{
-		std::string GetHashFromAppId(const std::string& platformType, const std::string& appIdStr);
+		std::string GetHashFromAppId(const Tools::StrView& platformType, const Tools::StrView& appIdStr);
 	}
 }
@@ -14,6 +14,12 @@ namespace Decent
 			constexpr char const gsk_x509LaIdOid[] = "2.25.128165920542469106824459777090692906263";
 			constexpr char const gsk_x509WhiteListOid[] = "2.25.219117063696833207876173044031738000021";
 
+			//Compact binary encodings of the extensions above; they take precedence over the JSON ones.
+			constexpr char const gsk_x509SelfRaReportBinOid[] = "2.25.320821108780419937839051341867961107124";
+			constexpr char const gsk_x509WhiteListBinOid[] = "2.25.230544969134197449033688603423596588036";
+
+			constexpr char const gsk_x509RevokedAppHashOid[] = "2.25.12813081876327051491789195600421433889";
+
 			constexpr int64_t gsk_x509ValidTime = 31536000; // 365 days in seconds.
 
 			inline std::string X509FormatTime(const std::tm& time)
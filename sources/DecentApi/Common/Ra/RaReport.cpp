@@ -1,5 +1,7 @@
 #include "RaReport.h"
 
+#include <cstring>
+
 #ifdef ENCLAVE_ENVIRONMENT
 #include <rapidjson/document.h>
 #else
@@ -15,6 +17,7 @@
 
 #include "../Tools/DataCoding.h"
 #include "../Tools/JsonTools.h"
+#include "../Tools/CompactCoding.h"
 
 #include "../MbedTls/Hasher.h"
 
@@ -49,12 +52,70 @@ bool RaReport::DecentReportDataVerifier(const std::string & pubSignKey, const ui
 #endif // SIMULATING_ENCLAVE
 }
 
+namespace
+{
+	struct SgxSelfRaReportFields
+	{
+		std::string m_iasReport;
+		std::string m_iasSign;
+		std::string m_iasCertChain;
+		sgx_report_data_t m_oriReportData;
+	};
+
+	void ParseSgxSelfRaReportJson(const std::string & raReport, SgxSelfRaReportFields & outFields)
+	{
+		using namespace Decent::Net;
+
+		//The document points into this buffer (in enclave build), so it's declared first.
+		std::string jsonBuf(raReport);
+		JsonDoc jsonDoc;
+		ParseStr2JsonInsitu(jsonDoc, jsonBuf);
+
+		if (!jsonDoc.JSON_HAS_MEMBER(RaReport::sk_LabelRoot) || !jsonDoc[RaReport::sk_LabelRoot].JSON_IS_OBJECT())
+		{
+			throw Decent::RuntimeException("Process SGX Self-RA Report failed: invalid JSON format.");
+		}
+		JsonValue& jsonRoot = jsonDoc[RaReport::sk_LabelRoot];
+
+		outFields.m_iasReport = CommonJsonMsg::ParseValue<std::string>(jsonRoot, RaReport::sk_LabelIasReport);
+		outFields.m_iasSign = CommonJsonMsg::ParseValue<std::string>(jsonRoot, RaReport::sk_LabelIasSign);
+		outFields.m_iasCertChain = CommonJsonMsg::ParseValue<std::string>(jsonRoot, RaReport::sk_LabelIasCertChain);
+		std::string oriRDB64 = CommonJsonMsg::ParseValue<std::string>(jsonRoot, RaReport::sk_LabelOriRepData);
+
+		DeserializeStruct(outFields.m_oriReportData, oriRDB64);
+	}
+
+	void ParseSgxSelfRaReportCompact(const std::string & raReport, SgxSelfRaReportFields & outFields)
+	{
+		CompactReader reader(raReport, RaReport::sk_compactVersionSgx);
+
+		outFields.m_iasReport = reader.GetBytes().ToString();
+		const StrView iasSign = reader.GetBytes();
+		outFields.m_iasCertChain = reader.GetBytes().ToString();
+		const StrView oriReportData = reader.GetBytes();
+
+		if (!reader.IsEnd() || oriReportData.size() != sizeof(sgx_report_data_t))
+		{
+			throw Decent::RuntimeException("Process SGX Self-RA Report failed: invalid compact format.");
+		}
+
+		//The signature is kept in Base64 by the IAS report verifier.
+		outFields.m_iasSign = SerializeStruct(iasSign.data(), iasSign.size());
+		std::memcpy(&outFields.m_oriReportData, oriReportData.data(), sizeof(sgx_report_data_t));
+	}
+}
+
 bool RaReport::ProcessSelfRaReport(const std::string & platformType, const std::string & pubKeyPem, const std::string & raReport, std::string & outHashStr, report_timestamp_t& outTimestamp)
+{
+	return ProcessSelfRaReport(platformType, pubKeyPem, raReport, false, outHashStr, outTimestamp);
+}
+
+bool RaReport::ProcessSelfRaReport(const std::string & platformType, const std::string & pubKeyPem, const std::string & raReport, bool isCompact, std::string & outHashStr, report_timestamp_t& outTimestamp)
 {
 	if (platformType == sk_ValueReportTypeSgx)
 	{
 		sgx_ias_report_t outIasReport;
-		bool verifyRes = ProcessSgxSelfRaReport(pubKeyPem, raReport, outIasReport);
+		bool verifyRes = ProcessSgxSelfRaReport(pubKeyPem, raReport, isCompact, outIasReport);
 
 		outTimestamp = outIasReport.m_timestamp;
 
@@ -66,38 +127,58 @@ bool RaReport::ProcessSelfRaReport(const std::string & platformType, const std::
 	throw RuntimeException("Process Self-RA Report failed: Unrecognized enclave platform.");
 }
 
+std::string RaReport::ConvertSelfRaReportToCompact(const std::string & platformType, const std::string & raReport)
+{
+	if (platformType == sk_ValueReportTypeSgx)
+	{
+		SgxSelfRaReportFields fields;
+		ParseSgxSelfRaReportJson(raReport, fields);
+
+		std::vector<uint8_t> iasSign;
+		DeserializeStruct(iasSign, fields.m_iasSign);
+
+		CompactWriter writer(sk_compactVersionSgx);
+		writer.PutBytes(fields.m_iasReport);
+		writer.PutBytes(iasSign.data(), iasSign.size());
+		writer.PutBytes(fields.m_iasCertChain);
+		writer.PutBytes(&fields.m_oriReportData, sizeof(fields.m_oriReportData));
+
+		return writer.Release();
+	}
+
+	throw RuntimeException("Convert Self-RA Report failed: Unrecognized enclave platform.");
+}
+
 bool RaReport::ProcessSgxSelfRaReport(const std::string& pubKeyPem, const std::string & raReport, sgx_ias_report_t & outIasReport)
 {
-	using namespace Decent::Net;
+	return ProcessSgxSelfRaReport(pubKeyPem, raReport, false, outIasReport);
+}
+
+bool RaReport::ProcessSgxSelfRaReport(const std::string& pubKeyPem, const std::string & raReport, bool isCompact, sgx_ias_report_t & outIasReport)
+{
 	if (raReport.size() == 0)
 	{
 		return false;
 	}
 
-	JsonDoc jsonDoc;
-	ParseStr2Json(jsonDoc, raReport);
-
-	if (!jsonDoc.JSON_HAS_MEMBER(RaReport::sk_LabelRoot) || !jsonDoc[RaReport::sk_LabelRoot].JSON_IS_OBJECT())
+	SgxSelfRaReportFields fields;
+	if (isCompact)
 	{
-		throw RuntimeException("Process SGX Self-RA Report failed: invalid JSON format.");
+		ParseSgxSelfRaReportCompact(raReport, fields);
+	}
+	else
+	{
+		ParseSgxSelfRaReportJson(raReport, fields);
 	}
-	JsonValue& jsonRoot = jsonDoc[RaReport::sk_LabelRoot];
-
-	std::string iasReportStr = CommonJsonMsg::ParseValue<std::string>(jsonRoot, RaReport::sk_LabelIasReport);
-	std::string iasSign = CommonJsonMsg::ParseValue<std::string>(jsonRoot, RaReport::sk_LabelIasSign);
-	std::string iasCertChain = CommonJsonMsg::ParseValue<std::string>(jsonRoot, RaReport::sk_LabelIasCertChain);
-	std::string oriRDB64 = CommonJsonMsg::ParseValue<std::string>(jsonRoot, RaReport::sk_LabelOriRepData);
-
-	sgx_report_data_t oriReportData;
-	DeserializeStruct(oriReportData, oriRDB64);
 
+	const sgx_report_data_t& oriReportData = fields.m_oriReportData;
 	auto quoteVerifier = [&pubKeyPem, &oriReportData](const sgx_ias_report_t & iasReport) -> bool
 	{
 		return DecentReportDataVerifier(pubKeyPem, oriReportData.d, iasReport.m_quote.report_body.report_data.d, 
 			sizeof(sgx_report_data_t) / 2);
 	};
 
-	bool reportVerifyRes = Decent::Ias::ParseAndVerifyIasReport(outIasReport, iasReportStr, iasCertChain, iasSign, nullptr, sk_sgxDecentRaConfig, quoteVerifier);
+	bool reportVerifyRes = Decent::Ias::ParseAndVerifyIasReport(outIasReport, fields.m_iasReport, fields.m_iasCertChain, fields.m_iasSign, nullptr, sk_sgxDecentRaConfig, quoteVerifier);
 
 	return reportVerifyRes;
 }
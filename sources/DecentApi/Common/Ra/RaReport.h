@@ -30,6 +30,13 @@ namespace Decent
 
 			constexpr char const sk_ValueReportTypeSgx[] = "SGX";
 
+			/**
+			 * \brief	Version of the compact binary encoding of the SGX Self-RA report, i.e. a version
+			 * 			byte, and then the length-prefixed IAS report, raw IAS signature, IAS certificate
+			 * 			chain, and raw original report data.
+			 */
+			constexpr uint8_t sk_compactVersionSgx = 1;
+
 			/**
 			 * \brief	Decent RA's default RA configuration for SGX platform. These SGX related stuffs may
 			 * 			be used for Self-RA report verification in other platform.
@@ -73,6 +80,37 @@ namespace Decent
 			 */
 			bool ProcessSelfRaReport(const std::string& platformType, const std::string& pubKeyPem, const std::string& raReport, std::string& outHashStr, report_timestamp_t& outTimestamp);
 
+			/**
+			 * \brief	Process the Decent Self-RA report, in JSON or in the compact binary encoding.
+			 * 			Verifying if the report is valid or not.
+			 *
+			 * \exception	Decent::RuntimeException	Unrecognized enclave platform. Or parse error from
+			 * 											underlying calls.
+			 *
+			 * \param 		  	platformType	Type of the enclave platform.
+			 * \param 		  	pubKeyPem   	The public key in PEM.
+			 * \param 		  	raReport		The RA report.
+			 * \param 		  	isCompact   	True if the report is in the compact binary encoding.
+			 * \param [in,out]	outHashStr  	The out enclave's hash string.
+			 * \param [in,out]	outTimestamp	The out timestamp.
+			 *
+			 * \return	True if it is valid, false if not.
+			 */
+			bool ProcessSelfRaReport(const std::string& platformType, const std::string& pubKeyPem, const std::string& raReport, bool isCompact, std::string& outHashStr, report_timestamp_t& outTimestamp);
+
+			/**
+			 * \brief	Converts the Decent Self-RA report in JSON into the compact binary encoding.
+			 *
+			 * \exception	Decent::RuntimeException	Unrecognized enclave platform. Or parse error from
+			 * 											underlying calls.
+			 *
+			 * \param	platformType	Type of the enclave platform.
+			 * \param	raReport		The RA report in JSON.
+			 *
+			 * \return	The RA report in the compact binary encoding.
+			 */
+			std::string ConvertSelfRaReportToCompact(const std::string& platformType, const std::string& raReport);
+
 			/**
 			 * \brief	Process the Decent Self-RA report produced in SGX platform. Verifying if the report
 			 * 			is valid or not.
@@ -87,6 +125,21 @@ namespace Decent
 			 * \return	True if it is valid, false if not.
 			 */
 			bool ProcessSgxSelfRaReport(const std::string& pubKeyPem, const std::string& raReport, sgx_ias_report_t& outIasReport);
+
+			/**
+			 * \brief	Process the Decent Self-RA report produced in SGX platform, in JSON or in the
+			 * 			compact binary encoding. Verifying if the report is valid or not.
+			 *
+			 * \exception	Decent::RuntimeException	Parse error from underlying calls.
+			 *
+			 * \param 		  	pubKeyPem   	The public key in PEM.
+			 * \param 		  	raReport		The RA report.
+			 * \param 		  	isCompact   	True if the report is in the compact binary encoding.
+			 * \param [in,out]	outIasReport	The output parsed IAS report.
+			 *
+			 * \return	True if it is valid, false if not.
+			 */
+			bool ProcessSgxSelfRaReport(const std::string& pubKeyPem, const std::string& raReport, bool isCompact, sgx_ias_report_t& outIasReport);
 		}
 	}
 }
@@ -7,6 +7,7 @@ namespace Decent
 		namespace RequestCategory
 		{
 			constexpr char const sk_loadWhiteList[] = "Decent::Ra::LoadWhiteList";
+			constexpr char const sk_loadWhiteLists[] = "Decent::Ra::LoadWhiteLists";
 			constexpr char const sk_requestAppCert[] = "Decent::Ra::RequestAppCert";
 		}
 	}
@@ -0,0 +1,260 @@
+#include "RevocationStore.h"
+
+#include <ctime>
+#include <cstring>
+
+#include <mbedtls/md.h>
+#include <mbedtls/asn1.h>
+#include <mbedtls/x509_crt.h>
+#include <mbedtls/x509_crl.h>
+
+#include "../Common.h"
+#include "../RuntimeException.h"
+#include "../MbedTls/X509Crl.h"
+#include "../MbedTls/X509Cert.h"
+#include "../MbedTls/MbedTlsException.h"
+
+#include "Crypto.h"
+#include "AppX509Cert.h"
+#include "Internal/Cert.h"
+
+using namespace Decent::Ra;
+using namespace Decent::Tools;
+using namespace Decent::MbedTlsObj;
+
+namespace
+{
+	inline std::string BufToStr(const mbedtls_x509_buf& buf)
+	{
+		return std::string(reinterpret_cast<const char*>(buf.p), buf.len);
+	}
+
+	/**
+	 * \brief	Gets the whole extension sequence of a CRL entry. mbedTLS only gives the pointer to the
+	 * 			tag, and the length of the content.
+	 */
+	void GetCrlEntryExtensions(const mbedtls_x509_crl_entry& entry, std::vector<X509Cert::V3ExtEntry>& out)
+	{
+		if (entry.entry_ext.p == nullptr || entry.entry_ext.len == 0)
+		{
+			return;
+		}
+
+		unsigned char* p = entry.entry_ext.p;
+		const unsigned char* end = entry.raw.p + entry.raw.len;
+		size_t len = 0;
+		CALL_MBEDTLS_C_FUNC(mbedtls_asn1_get_tag, &p, end, &len, MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE);
+
+		X509Cert::ParseV3Extensions(entry.entry_ext.p, (p - entry.entry_ext.p) + len, out);
+	}
+
+	/**
+	 * \brief	Compares an X.509 time with a broken-down UTC time. mbedTLS's own time checks are no-ops
+	 * 			when it's built without MBEDTLS_HAVE_TIME_DATE (e.g. inside the enclave), thus, the time
+	 * 			given by Decent::Tools is used instead.
+	 *
+	 * \param	lhs	The X.509 time.
+	 * \param	rhs	The broken-down UTC time.
+	 *
+	 * \return	Negative if lhs is earlier, zero if they are the same, or positive if lhs is later.
+	 */
+	int CompareX509Time(const mbedtls_x509_time& lhs, const struct tm& rhs)
+	{
+		const int lhsFields[] = { lhs.year, lhs.mon, lhs.day, lhs.hour, lhs.min, lhs.sec };
+		const int rhsFields[] = { rhs.tm_year + 1900, rhs.tm_mon + 1, rhs.tm_mday, rhs.tm_hour, rhs.tm_min, rhs.tm_sec };
+		for (size_t i = 0; i < sizeof(lhsFields) / sizeof(lhsFields[0]); ++i)
+		{
+			if (lhsFields[i] != rhsFields[i])
+			{
+				return lhsFields[i] < rhsFields[i] ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+}
+
+RevocationIndex::RevocationIndex() :
+	m_serials(),
+	m_serialCount(0),
+	m_appHashes()
+{
+}
+
+RevocationIndex::~RevocationIndex()
+{
+}
+
+void RevocationIndex::AddCrl(const X509Crl & crl)
+{
+	crl.NullCheck();
+
+	for (const mbedtls_x509_crl* curr = crl.Get(); curr != nullptr && curr->version != 0; curr = curr->next)
+	{
+		AddCrlEntries(*curr);
+	}
+}
+
+void RevocationIndex::AddSerial(const std::string & issuer, const std::string & serial)
+{
+	if (m_serials[issuer].insert(serial).second)
+	{
+		++m_serialCount;
+	}
+}
+
+void RevocationIndex::AddAppHash(const std::string & appHash)
+{
+	m_appHashes.insert(appHash);
+}
+
+bool RevocationIndex::IsSerialRevoked(const mbedtls_x509_crt & cert) const
+{
+	if (m_serialCount == 0)
+	{
+		return false;
+	}
+
+	auto it = m_serials.find(BufToStr(cert.issuer_raw));
+	return it != m_serials.end() && it->second.find(BufToStr(cert.serial)) != it->second.end();
+}
+
+bool RevocationIndex::IsAppHashRevoked(const std::string & appHash) const
+{
+	return m_appHashes.find(appHash) != m_appHashes.end();
+}
+
+void RevocationIndex::AddCrlEntries(const mbedtls_x509_crl & crl)
+{
+	const StrView appHashOid(detail::gsk_x509RevokedAppHashOid);
+
+	std::unordered_set<std::string>& issuerSerials = m_serials[BufToStr(crl.issuer_raw)];
+	std::vector<X509Cert::V3ExtEntry> exts;
+
+	for (const mbedtls_x509_crl_entry* entry = &crl.entry; entry != nullptr && entry->serial.len != 0; entry = entry->next)
+	{
+		if (issuerSerials.insert(BufToStr(entry->serial)).second)
+		{
+			++m_serialCount;
+		}
+
+		exts.clear();
+		GetCrlEntryExtensions(*entry, exts);
+		for (const X509Cert::V3ExtEntry& ext : exts)
+		{
+			if (ext.m_oid == appHashOid)
+			{
+				m_appHashes.insert(ext.m_value.ToString());
+			}
+		}
+	}
+}
+
+RevocationStore & RevocationStore::GetDefault()
+{
+	static RevocationStore inst;
+	return inst;
+}
+
+RevocationStore::RevocationStore() :
+	m_indexMutex(),
+	m_index()
+{
+}
+
+RevocationStore::~RevocationStore()
+{
+}
+
+void RevocationStore::Reload(std::shared_ptr<const RevocationIndex> index)
+{
+	//Swap under the lock, but release the old index (which could be large) outside of it.
+	{
+		std::unique_lock<std::mutex> indexLock(m_indexMutex);
+		m_index.swap(index);
+	}
+}
+
+void RevocationStore::Reload(const X509Crl & crl, const X509Cert & issuers)
+{
+	VerifyCrl(crl, issuers);
+
+	std::shared_ptr<RevocationIndex> index = std::make_shared<RevocationIndex>();
+	index->AddCrl(crl);
+
+	Reload(std::shared_ptr<const RevocationIndex>(std::move(index)));
+}
+
+void RevocationStore::VerifyCrl(const X509Crl & crl, const X509Cert & issuers)
+{
+	crl.NullCheck();
+	issuers.NullCheck();
+
+	time_t nowTimer;
+	struct tm now;
+	GetSystemTime(nowTimer);
+	GetSystemUtcTime(nowTimer, now);
+
+	for (const mbedtls_x509_crl* curr = crl.Get(); curr != nullptr && curr->version != 0; curr = curr->next)
+	{
+		const mbedtls_x509_crt* issuer = issuers.Get();
+		while (issuer != nullptr &&
+			(issuer->subject_raw.len != curr->issuer_raw.len ||
+				std::memcmp(issuer->subject_raw.p, curr->issuer_raw.p, curr->issuer_raw.len) != 0))
+		{
+			issuer = issuer->next;
+		}
+		if (issuer == nullptr || !mbedtls_pk_can_do(&issuer->pk, curr->sig_pk))
+		{
+			throw Decent::RuntimeException("The CRL is not issued by any of the given certificates.");
+		}
+
+		//An absent next update field is left all zero by mbedTLS.
+		if (CompareX509Time(curr->this_update, now) > 0 ||
+			(curr->next_update.year != 0 && CompareX509Time(curr->next_update, now) < 0))
+		{
+			throw Decent::RuntimeException("The CRL is not current.");
+		}
+
+		const mbedtls_md_info_t* mdInfo = mbedtls_md_info_from_type(curr->sig_md);
+		if (mdInfo == nullptr)
+		{
+			throw Decent::RuntimeException("The CRL is signed with an unsupported hash algorithm.");
+		}
+
+		uint8_t hash[MBEDTLS_MD_MAX_SIZE];
+		CALL_MBEDTLS_C_FUNC(mbedtls_md, mdInfo, curr->tbs.p, curr->tbs.len, hash);
+		CALL_MBEDTLS_C_FUNC(mbedtls_pk_verify_ext, curr->sig_pk, curr->sig_opts, const_cast<mbedtls_pk_context*>(&issuer->pk),
+			curr->sig_md, hash, mbedtls_md_get_size(mdInfo), curr->sig.p, curr->sig.len);
+	}
+}
+
+std::shared_ptr<const RevocationIndex> RevocationStore::GetIndex() const
+{
+	std::unique_lock<std::mutex> indexLock(m_indexMutex);
+	return m_index;
+}
+
+bool RevocationStore::IsRevoked(const mbedtls_x509_crt & cert) const
+{
+	std::shared_ptr<const RevocationIndex> index = GetIndex();
+
+	return index && index->IsSerialRevoked(cert);
+}
+
+bool RevocationStore::IsRevoked(const mbedtls_x509_crt & cert, const AppX509Cert & appCert) const
+{
+	std::shared_ptr<const RevocationIndex> index = GetIndex();
+
+	if (!index)
+	{
+		return false;
+	}
+
+	if (index->IsSerialRevoked(cert))
+	{
+		return true;
+	}
+
+	return index->GetAppHashCount() > 0 &&
+		index->IsAppHashRevoked(GetHashFromAppId(appCert.GetPlatformType(), appCert.GetAppId()));
+}
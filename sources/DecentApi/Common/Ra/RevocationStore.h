@@ -0,0 +1,185 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+typedef struct mbedtls_x509_crt mbedtls_x509_crt;
+typedef struct mbedtls_x509_crl mbedtls_x509_crl;
+
+namespace Decent
+{
+	namespace MbedTlsObj
+	{
+		class X509Crl;
+		class X509Cert;
+	}
+
+	namespace Ra
+	{
+		class AppX509Cert;
+
+		/**
+		 * \brief	The index of revoked certificates (by issuer and serial number) and revoked DECENT
+		 * 			Apps (by enclave hash). Lookups are done in hash sets, thus, they don't depend on the
+		 * 			number of revoked entries. Once it's given to the RevocationStore, it's immutable.
+		 */
+		class RevocationIndex
+		{
+		public:
+			RevocationIndex();
+
+			virtual ~RevocationIndex();
+
+			/**
+			 * \brief	Adds all entries of the given CRL (and the CRLs chained after it). Entries carrying
+			 * 			the DECENT revoked-app-hash extension also revoke the enclave hash in it.
+			 *
+			 * \exception	Decent::MbedTlsObj::MbedTlsException	Thrown when an entry extension is malformed.
+			 *
+			 * \param	crl	The CRL.
+			 */
+			void AddCrl(const MbedTlsObj::X509Crl& crl);
+
+			/**
+			 * \brief	Adds a revoked certificate.
+			 *
+			 * \param	issuer	The DER encoded issuer name.
+			 * \param	serial	The serial number.
+			 */
+			void AddSerial(const std::string& issuer, const std::string& serial);
+
+			/**
+			 * \brief	Adds a revoked DECENT App.
+			 *
+			 * \param	appHash	The enclave hash of the App, in the format given by GetHashFromAppId.
+			 */
+			void AddAppHash(const std::string& appHash);
+
+			/**
+			 * \brief	Query if the given certificate is revoked by its issuer and serial number.
+			 *
+			 * \param	cert	The certificate.
+			 *
+			 * \return	True if revoked, false if not.
+			 */
+			bool IsSerialRevoked(const mbedtls_x509_crt& cert) const;
+
+			/**
+			 * \brief	Query if the given DECENT App is revoked by its enclave hash.
+			 *
+			 * \param	appHash	The enclave hash of the App.
+			 *
+			 * \return	True if revoked, false if not.
+			 */
+			bool IsAppHashRevoked(const std::string& appHash) const;
+
+			size_t GetSerialCount() const noexcept { return m_serialCount; }
+
+			size_t GetAppHashCount() const noexcept { return m_appHashes.size(); }
+
+		private:
+			void AddCrlEntries(const mbedtls_x509_crl& crl);
+
+			std::unordered_map<std::string, std::unordered_set<std::string> > m_serials;
+			size_t m_serialCount;
+			std::unordered_set<std::string> m_appHashes;
+		};
+
+		/**
+		 * \brief	A store of revoked certificates and DECENT Apps, which is consulted during TLS
+		 * 			certificate verification. The index can be hot reloaded at any time; the new index is
+		 * 			built by the caller beforehand, and then swapped in, thus, handshakes in progress keep
+		 * 			using the index they have already got, and they are never blocked by the reload.
+		 */
+		class RevocationStore
+		{
+		public: //static members:
+
+			/**
+			 * \brief	Gets the store used by all DECENT TLS configurations in this process.
+			 *
+			 * \return	The default store.
+			 */
+			static RevocationStore& GetDefault();
+
+		public:
+			/** \brief	Constructs an empty store that revokes nothing. */
+			RevocationStore();
+
+			RevocationStore(const RevocationStore& rhs) = delete;
+
+			RevocationStore(RevocationStore&& rhs) = delete;
+
+			virtual ~RevocationStore();
+
+			/**
+			 * \brief	Replaces the current index with the given one.
+			 *
+			 * \param	index	The new index. Null clears the store.
+			 */
+			virtual void Reload(std::shared_ptr<const RevocationIndex> index);
+
+			/**
+			 * \brief	Verifies the given CRL (and the CRLs chained after it), builds a new index from it,
+			 * 			and replaces the current index with it. Each CRL must be signed by one of the given
+			 * 			issuer certificates, and must be current (i.e. its next update is not in the past).
+			 *
+			 * \exception	Decent::RuntimeException				Thrown when a CRL is not issued by any of the
+			 * 													given certificates, or is not current. In this
+			 * 													case, the current index is kept.
+			 * \exception	Decent::MbedTlsObj::MbedTlsException	Thrown when the signature of a CRL is invalid, or
+			 * 													an entry extension is malformed. In this case,
+			 * 													the current index is kept.
+			 *
+			 * \param	crl	   	The CRL.
+			 * \param	issuers	The certificates of the CRL issuers (e.g. the DECENT Server certificate).
+			 */
+			virtual void Reload(const MbedTlsObj::X509Crl& crl, const MbedTlsObj::X509Cert& issuers);
+
+			/**
+			 * \brief	Verifies the given CRL (and the CRLs chained after it). See Reload.
+			 *
+			 * \exception	Decent::RuntimeException				See Reload.
+			 * \exception	Decent::MbedTlsObj::MbedTlsException	See Reload.
+			 *
+			 * \param	crl	   	The CRL.
+			 * \param	issuers	The certificates of the CRL issuers.
+			 */
+			static void VerifyCrl(const MbedTlsObj::X509Crl& crl, const MbedTlsObj::X509Cert& issuers);
+
+			/**
+			 * \brief	Gets the current index.
+			 *
+			 * \return	The index, which could be null if nothing has been loaded.
+			 */
+			virtual std::shared_ptr<const RevocationIndex> GetIndex() const;
+
+			/**
+			 * \brief	Query if the given certificate is revoked by its issuer and serial number.
+			 *
+			 * \param	cert	The certificate.
+			 *
+			 * \return	True if revoked, false if not.
+			 */
+			virtual bool IsRevoked(const mbedtls_x509_crt& cert) const;
+
+			/**
+			 * \brief	Query if the given DECENT App certificate is revoked, either by its issuer and
+			 * 			serial number, or by the enclave hash of the App.
+			 *
+			 * \param	cert   	The certificate given by mbedTLS.
+			 * \param	appCert	The parsed DECENT App certificate of the same certificate.
+			 *
+			 * \return	True if revoked, false if not.
+			 */
+			virtual bool IsRevoked(const mbedtls_x509_crt& cert, const AppX509Cert& appCert) const;
+
+		private:
+			mutable std::mutex m_indexMutex;
+			std::shared_ptr<const RevocationIndex> m_index;
+		};
+	}
+}
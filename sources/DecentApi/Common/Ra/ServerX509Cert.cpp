@@ -9,6 +9,7 @@
 #include "../MbedTls/EcKey.h"
 #include "../MbedTls/BigNumber.h"
 
+#include "RaReport.h"
 #include "Internal/Cert.h"
 
 using namespace Decent::Ra;
@@ -20,7 +21,8 @@ const mbedtls_x509_crt_profile & Decent::Ra::GetX509Profile()
 	return mbedtls_x509_crt_profile_suiteb;
 }
 
-ServerX509CertWriter::ServerX509CertWriter(EcKeyPairBase & prvKey, const std::string & enclaveHash, const std::string & platformType, const std::string & selfRaReport) :
+ServerX509CertWriter::ServerX509CertWriter(EcKeyPairBase & prvKey, const std::string & enclaveHash, const std::string & platformType, const std::string & selfRaReport,
+	CertExtEncoding encoding) :
 	X509CertWriter(HashType::SHA256, prvKey, ("CN=" + enclaveHash))
 {
 	SetBasicConstraints(true, -1);
@@ -29,13 +31,19 @@ ServerX509CertWriter::ServerX509CertWriter(EcKeyPairBase & prvKey, const std::st
 
 	SetSerialNum(BigNumber::Rand<Drbg>(GENERAL_256BIT_32BYTE_SIZE));
 
-	SetV3Extensions(
-		std::map<std::string, std::pair<bool, std::string> >
+	std::map<std::string, std::pair<bool, std::string> > extMap
 	{
 		std::make_pair(detail::gsk_x509PlatformTypeOid, std::make_pair(false, platformType)),
-		std::make_pair(detail::gsk_x509SelfRaReportOid, std::make_pair(false, selfRaReport)),
+	};
+	if (encoding != CertExtEncoding::Compact)
+	{
+		extMap.insert(std::make_pair(detail::gsk_x509SelfRaReportOid, std::make_pair(false, selfRaReport)));
+	}
+	if (encoding != CertExtEncoding::Json)
+	{
+		extMap.insert(std::make_pair(detail::gsk_x509SelfRaReportBinOid, std::make_pair(false, RaReport::ConvertSelfRaReportToCompact(platformType, selfRaReport))));
 	}
-	);
+	SetV3Extensions(extMap);
 
 	time_t timerBegin;
 	GetSystemTime(timerBegin);
@@ -56,20 +64,23 @@ ServerX509CertWriter::~ServerX509CertWriter()
 ServerX509Cert::ServerX509Cert(const ServerX509Cert & rhs) :
 	X509Cert(rhs),
 	m_platformType(rhs.m_platformType),
-	m_selfRaReport(rhs.m_selfRaReport)
+	m_selfRaReport(rhs.m_selfRaReport),
+	m_isSelfRaReportCompact(rhs.m_isSelfRaReportCompact)
 {
 }
 
 ServerX509Cert::ServerX509Cert(ServerX509Cert && rhs) :
 	X509Cert(std::forward<X509Cert>(rhs)),
 	m_platformType(std::move(rhs.m_platformType)),
-	m_selfRaReport(std::move(rhs.m_selfRaReport))
+	m_selfRaReport(std::move(rhs.m_selfRaReport)),
+	m_isSelfRaReportCompact(rhs.m_isSelfRaReportCompact)
 {}
 
 ServerX509Cert::ServerX509Cert(const std::vector<uint8_t>& der) :
 	X509Cert(der),
 	m_platformType(),
-	m_selfRaReport()
+	m_selfRaReport(),
+	m_isSelfRaReportCompact(false)
 {
 	ParseExtensions();
 }
@@ -77,7 +88,8 @@ ServerX509Cert::ServerX509Cert(const std::vector<uint8_t>& der) :
 ServerX509Cert::ServerX509Cert(const std::string & pem) :
 	X509Cert(pem),
 	m_platformType(),
-	m_selfRaReport()
+	m_selfRaReport(),
+	m_isSelfRaReportCompact(false)
 {
 	ParseExtensions();
 }
@@ -85,7 +97,8 @@ ServerX509Cert::ServerX509Cert(const std::string & pem) :
 ServerX509Cert::ServerX509Cert(mbedtls_x509_crt & ref) :
 	X509Cert(ref),
 	m_platformType(),
-	m_selfRaReport()
+	m_selfRaReport(),
+	m_isSelfRaReportCompact(false)
 {
 	ParseExtensions();
 }
@@ -101,6 +114,7 @@ ServerX509Cert & ServerX509Cert::operator=(ServerX509Cert && rhs)
 	{
 		m_platformType = std::move(rhs.m_platformType);
 		m_selfRaReport = std::move(rhs.m_selfRaReport);
+		m_isSelfRaReportCompact = rhs.m_isSelfRaReportCompact;
 	}
 	return *this;
 }
@@ -117,20 +131,23 @@ const std::string & Decent::Ra::ServerX509Cert::GetSelfRaReport() const
 
 void ServerX509Cert::ParseExtensions()
 {
-	auto extMap = GetCurrV3Extensions();
-
-	auto it = extMap.find(detail::gsk_x509PlatformTypeOid);
-	if (it == extMap.end())
+	const V3ExtEntry* ext = FindCurrV3Extension(detail::gsk_x509PlatformTypeOid);
+	if (!ext)
 	{
 		throw RuntimeException("Invalid Server X509 certificate. Platform Type field is missing.");
 	}
+	m_platformType = ext->m_value.ToString();
 
-	m_platformType = std::move(it->second.second);
-
-	it = extMap.find(detail::gsk_x509SelfRaReportOid);
-	if (it == extMap.end())
+	//Prefer the compact encoding; the JSON one is kept for certificates issued by older versions.
+	ext = FindCurrV3Extension(detail::gsk_x509SelfRaReportBinOid);
+	m_isSelfRaReportCompact = (ext != nullptr);
+	if (!ext)
+	{
+		ext = FindCurrV3Extension(detail::gsk_x509SelfRaReportOid);
+	}
+	if (!ext)
 	{
 		throw RuntimeException("Invalid Server X509 certificate. Self RA Report field is missing.");
 	}
-	m_selfRaReport = std::move(it->second.second);
+	m_selfRaReport = ext->m_value.ToString();
 }
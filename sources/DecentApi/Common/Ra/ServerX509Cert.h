@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../MbedTls/X509Cert.h"
+#include "CertExtEncoding.h"
 
 namespace Decent
 {
@@ -31,9 +32,11 @@ namespace Decent
 			 * \param	prvKey			The key pair including private key.
 			 * \param	enclaveHash 	The hash of the enclave.
 			 * \param	platformType	Type of the platform.
-			 * \param	selfRaReport	The self RA report.
+			 * \param	selfRaReport	The self RA report in JSON.
+			 * \param	encoding		The encoding(s) of the self RA report extension.
 			 */
-			ServerX509CertWriter(MbedTlsObj::EcKeyPairBase& prvKey, const std::string& enclaveHash, const std::string& platformType, const std::string& selfRaReport);
+			ServerX509CertWriter(MbedTlsObj::EcKeyPairBase& prvKey, const std::string& enclaveHash, const std::string& platformType, const std::string& selfRaReport,
+				CertExtEncoding encoding = CertExtEncoding::Both);
 
 			/** \brief	Destructor */
 			virtual ~ServerX509CertWriter();
@@ -69,18 +72,27 @@ namespace Decent
 			const std::string& GetPlatformType() const;
 
 			/**
-			 * \brief	Gets self RA report embedded in the certificate.
+			 * \brief	Gets self RA report embedded in the certificate, in JSON, or in the compact binary
+			 * 			encoding (see IsSelfRaReportCompact).
 			 *
 			 * \return	The self RA report.
 			 */
 			const std::string& GetSelfRaReport() const;
 
+			/**
+			 * \brief	Query if the self RA report is in the compact binary encoding, rather than JSON.
+			 *
+			 * \return	True if compact, false if JSON.
+			 */
+			bool IsSelfRaReportCompact() const { return m_isSelfRaReportCompact; }
+
 		private:
 
 			void ParseExtensions();
 
 			std::string m_platformType;
 			std::string m_selfRaReport;
+			bool m_isSelfRaReportCompact;
 		};
 	}
 }
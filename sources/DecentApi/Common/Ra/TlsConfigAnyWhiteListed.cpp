@@ -29,7 +29,7 @@ int TlsConfigAnyWhiteListed::VerifyDecentAppCert(const AppX509Cert & cert, int d
 	}
 
 	//Check Loaded Lists are equivalent
-	StaticList peerLoadedList(LoadedList::ParseWhiteListFromJson(cert.GetWhiteList()));
+	StaticList peerLoadedList(LoadedList::ParseWhiteList(cert));
 	if (peerLoadedList != GetState().GetLoadedWhiteList())
 	{
 		flag = MBEDTLS_X509_BADCERT_NOT_TRUSTED;
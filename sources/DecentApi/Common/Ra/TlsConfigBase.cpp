@@ -9,6 +9,8 @@
 #include "States.h"
 #include "AppX509Cert.h"
 #include "ServerX509Cert.h"
+#include "X509CertCache.h"
+#include "RevocationStore.h"
 #include "KeyContainer.h"
 #include "CertContainer.h"
 #include "WhiteList/DecentServer.h"
@@ -41,15 +43,14 @@ int TlsConfigBase::VerifyCert(mbedtls_x509_crt& cert, int depth, uint32_t& flag)
 	{
 	case 0: //Decent App Cert
 	{
-		AppX509Cert appCert(cert);
+		std::shared_ptr<const AppX509Cert> appCert = X509CertCache::GetDefault().GetAppCert(cert);
+		CheckRevocation(cert, *appCert, flag);
 
-		return VerifyDecentAppCert(appCert, depth, flag);
+		return VerifyDecentAppCert(*appCert, depth, flag);
 	}
 	case 1: //Decent Server Cert
 	{
-		const ServerX509Cert serverCert(cert);
-
-		return VerifyDecentServerCert(serverCert, depth, flag);
+		return CheckAndVerifyDecentServerCert(cert, depth, flag);
 	}
 	default:
 		return MBEDTLS_ERR_X509_FATAL_ERROR;
@@ -62,3 +63,32 @@ int TlsConfigBase::VerifyDecentServerCert(const ServerX509Cert & cert, int depth
 	flag = verifyRes ? MBEDTLS_SUCCESS_RET : MBEDTLS_X509_BADCERT_NOT_TRUSTED;
 	return MBEDTLS_SUCCESS_RET;
 }
+
+int TlsConfigBase::CheckAndVerifyDecentServerCert(const mbedtls_x509_crt & cert, int depth, uint32_t & flag) const
+{
+	CheckRevocation(cert, flag);
+	if (flag & MBEDTLS_X509_BADCERT_REVOKED)
+	{//A revoked server must not be added to the trusted nodes.
+		return MBEDTLS_SUCCESS_RET;
+	}
+
+	std::shared_ptr<const ServerX509Cert> serverCert = X509CertCache::GetDefault().GetServerCert(cert);
+
+	return VerifyDecentServerCert(*serverCert, depth, flag);
+}
+
+void TlsConfigBase::CheckRevocation(const mbedtls_x509_crt & cert, uint32_t & flag) const
+{
+	if (RevocationStore::GetDefault().IsRevoked(cert))
+	{
+		flag |= MBEDTLS_X509_BADCERT_REVOKED;
+	}
+}
+
+void TlsConfigBase::CheckRevocation(const mbedtls_x509_crt & cert, const AppX509Cert & appCert, uint32_t & flag) const
+{
+	if (RevocationStore::GetDefault().IsRevoked(cert, appCert))
+	{
+		flag |= MBEDTLS_X509_BADCERT_REVOKED;
+	}
+}
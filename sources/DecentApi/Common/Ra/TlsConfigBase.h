@@ -41,8 +41,40 @@ namespace Decent
 
 			virtual int VerifyDecentServerCert(const ServerX509Cert& cert, int depth, uint32_t& flag) const;
 
+			/**
+			 * \brief	Checks the DECENT Server certificate against the revocation store first, and only
+			 * 			if it's not revoked, verifies it by VerifyDecentServerCert (which records it as a
+			 * 			trusted node in the states). A revoked certificate is marked as revoked in the flag.
+			 *
+			 * \param 		  	cert 	The certificate given by mbedTLS.
+			 * \param 		  	depth	The depth of the certificate in the chain.
+			 * \param [in,out]	flag 	The verification flag.
+			 *
+			 * \return	An int. The mbedTLS error code.
+			 */
+			int CheckAndVerifyDecentServerCert(const mbedtls_x509_crt& cert, int depth, uint32_t& flag) const;
+
 			virtual int VerifyDecentAppCert(const AppX509Cert& cert, int depth, uint32_t& flag) const = 0;
 
+			/**
+			 * \brief	Checks the certificate against the revocation store, and marks it as revoked in
+			 * 			the flag if it's found.
+			 *
+			 * \param 		  	cert	The certificate.
+			 * \param [in,out]	flag	The verification flag.
+			 */
+			virtual void CheckRevocation(const mbedtls_x509_crt& cert, uint32_t& flag) const;
+
+			/**
+			 * \brief	Checks the DECENT App certificate (by serial number and by enclave hash) against
+			 * 			the revocation store, and marks it as revoked in the flag if it's found.
+			 *
+			 * \param 		  	cert   	The certificate given by mbedTLS.
+			 * \param 		  	appCert	The parsed DECENT App certificate of the same certificate.
+			 * \param [in,out]	flag   	The verification flag.
+			 */
+			virtual void CheckRevocation(const mbedtls_x509_crt& cert, const AppX509Cert& appCert, uint32_t& flag) const;
+
 		private:
 			States& m_state;
 		};
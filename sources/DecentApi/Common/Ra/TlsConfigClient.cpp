@@ -4,6 +4,7 @@
 
 #include "ClientX509Cert.h"
 #include "ServerX509Cert.h"
+#include "X509CertCache.h"
 
 using namespace Decent::Ra;
 using namespace Decent::MbedTlsObj;
@@ -24,20 +25,20 @@ int TlsConfigClient::VerifyCert(mbedtls_x509_crt & cert, int depth, uint32_t & f
 	case 0: //Client Cert
 	{
 		ClientX509Cert certObj(cert);
+		CheckRevocation(cert, flag);
 
 		return VerifyClientCert(certObj, depth, flag);
 	}
 	case 1: //Decent App Cert
 	{
-		AppX509Cert certObj(cert);
+		std::shared_ptr<const AppX509Cert> certObj = X509CertCache::GetDefault().GetAppCert(cert);
+		CheckRevocation(cert, *certObj, flag);
 
-		return VerifyDecentAppCert(certObj, depth, flag);
+		return VerifyDecentAppCert(*certObj, depth, flag);
 	}
 	case 2: //Decent Server Cert
 	{
-		const ServerX509Cert serverCert(cert);
-
-		return VerifyDecentServerCert(serverCert, depth, flag);
+		return CheckAndVerifyDecentServerCert(cert, depth, flag);
 	}
 	default:
 		return MBEDTLS_ERR_X509_FATAL_ERROR;
@@ -47,10 +47,11 @@ int TlsConfigWithName::VerifyDecentAppCert(const AppX509Cert & cert, int depth,
 	}
 
 	//Check Loaded Lists are equivalent
-	StaticList peerLoadedList(LoadedList::ParseWhiteListFromJson(cert.GetWhiteList()));
+	StaticList peerLoadedList(LoadedList::ParseWhiteList(cert));
 	if (peerLoadedList != GetState().GetLoadedWhiteList())
 	{
-		PRINT_I("Peer's AuthList does not match.\n\tPeer's AuthList %s.\n\tOur AuthList: %s.", cert.GetWhiteList().c_str(), m_expectedAppName.c_str());
+		const std::string peerListStr = cert.IsWhiteListCompact() ? "(compact encoding)" : cert.GetWhiteList().ToString();
+		PRINT_I("Peer's AuthList does not match.\n\tPeer's AuthList %s.\n\tOur AuthList: %s.", peerListStr.c_str(), m_expectedAppName.c_str());
 		flag = MBEDTLS_X509_BADCERT_NOT_TRUSTED;
 		return MBEDTLS_SUCCESS_RET;
 	}
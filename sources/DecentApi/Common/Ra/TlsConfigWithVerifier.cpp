@@ -6,6 +6,7 @@
 #include "Crypto.h"
 #include "ServerX509Cert.h"
 #include "VerifiedAppX509Cert.h"
+#include "X509CertCache.h"
 #include "WhiteList/LoadedList.h"
 
 using namespace Decent::Ra;
@@ -33,21 +34,21 @@ int TlsConfigWithVerifier::VerifyCert(mbedtls_x509_crt& cert, int depth, uint32_
 	{
 	case 0: //Decent App Cert
 	{
-		VerifiedAppX509Cert appCert(cert);
+		std::shared_ptr<const VerifiedAppX509Cert> appCert = X509CertCache::GetDefault().GetVerifiedAppCert(cert);
+		CheckRevocation(cert, *appCert, flag);
 
-		return VerifyDecentVerifiedAppCert(appCert, depth, flag);
+		return VerifyDecentVerifiedAppCert(*appCert, depth, flag);
 	}
 	case 1: //Decent Verifier Cert
 	{
-		AppX509Cert verifierCert(cert);
+		std::shared_ptr<const AppX509Cert> verifierCert = X509CertCache::GetDefault().GetAppCert(cert);
+		CheckRevocation(cert, *verifierCert, flag);
 
-		return VerifyDecentAppCert(verifierCert, depth, flag);
+		return VerifyDecentAppCert(*verifierCert, depth, flag);
 	}
 	case 2: //Decent Server Cert
 	{
-		const ServerX509Cert serverCert(cert);
-
-		return VerifyDecentServerCert(serverCert, depth, flag);
+		return CheckAndVerifyDecentServerCert(cert, depth, flag);
 	}
 	default:
 		return MBEDTLS_ERR_X509_FATAL_ERROR;
@@ -73,7 +74,7 @@ int TlsConfigWithVerifier::VerifyDecentAppCert(const AppX509Cert & cert, int dep
 	}
 
 	//Check Loaded Lists are equivalent
-	StaticList peerLoadedList(LoadedList::ParseWhiteListFromJson(cert.GetWhiteList()));
+	StaticList peerLoadedList(LoadedList::ParseWhiteList(cert));
 	if (peerLoadedList <= GetState().GetLoadedWhiteList())
 	{
 		flag = MBEDTLS_X509_BADCERT_NOT_TRUSTED;
@@ -94,7 +95,7 @@ int TlsConfigWithVerifier::VerifyDecentVerifiedAppCert(const VerifiedAppX509Cert
 	}
 
 	//Check Loaded Lists are equivalent
-	StaticList peerLoadedList(LoadedList::ParseWhiteListFromJson(cert.GetWhiteList()));
+	StaticList peerLoadedList(LoadedList::ParseWhiteList(cert));
 	if (GetState().GetLoadedWhiteList() != peerLoadedList)
 	{
 		flag = MBEDTLS_X509_BADCERT_NOT_TRUSTED;
@@ -5,6 +5,8 @@
 
 #include "../MbedTls/EcKey.h"
 
+#include "WhiteList/LoadedList.h"
+
 using namespace Decent::Ra;
 using namespace Decent::MbedTlsObj;
 
@@ -20,7 +22,7 @@ VerifiedAppX509CertWriter::VerifiedAppX509CertWriter(const AppX509Cert & oriCert
 Decent::Ra::VerifiedAppX509CertWriter::VerifiedAppX509CertWriter(const AppX509Cert & oriCert, EcPublicKeyBase pubKey, const AppX509Cert & verifierCert,
 	EcKeyPairBase & verifierPrvKey, const std::string & appName) :
 	AppX509CertWriter(pubKey, verifierCert, verifierPrvKey,
-		appName, oriCert.GetPlatformType(), oriCert.GetAppId(), oriCert.GetWhiteList())
+		appName, oriCert.GetPlatformType().ToString(), oriCert.GetAppId().ToString(), WhiteList::LoadedList::ParseWhiteList(oriCert))
 {
 }
 
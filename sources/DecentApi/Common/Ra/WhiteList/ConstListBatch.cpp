@@ -0,0 +1,85 @@
+#include "ConstListBatch.h"
+
+#include "../../RuntimeException.h"
+#include "../../Tools/CompactCoding.h"
+
+using namespace Decent::Tools;
+using namespace Decent::Ra::WhiteList;
+
+constexpr uint8_t ConstListBatch::sk_version;
+
+std::vector<ConstListBatch::Entry> ConstListBatch::Unpack(const StrView & packed)
+{
+	CompactReader reader(packed, sk_version);
+	const uint64_t count = reader.GetUInt();
+
+	std::vector<Entry> res;
+	//Each entry takes at least 2 bytes, so a bogus count can't make us reserve too much memory.
+	res.reserve(static_cast<size_t>(count < packed.size() / 2 ? count : packed.size() / 2));
+	for (uint64_t i = 0; i < count; ++i)
+	{
+		const uint64_t op = reader.GetUInt();
+		const StrView key = reader.GetBytes();
+		switch (op)
+		{
+		case static_cast<uint64_t>(Operation::Add):
+			res.push_back(Entry{ Operation::Add, key, reader.GetBytes() });
+			break;
+		case static_cast<uint64_t>(Operation::Remove):
+			res.push_back(Entry{ Operation::Remove, key, StrView() });
+			break;
+		default:
+			throw Decent::RuntimeException("Failed to unpack const white list batch: unknown operation.");
+		}
+	}
+
+	if (!reader.IsEnd())
+	{
+		throw Decent::RuntimeException("Failed to unpack const white list batch: unexpected trailing data.");
+	}
+	return res;
+}
+
+ConstListBatch::ConstListBatch() :
+	m_entries()
+{
+}
+
+ConstListBatch::~ConstListBatch()
+{
+}
+
+void ConstListBatch::Add(const std::string & key, const std::string & listJson)
+{
+	m_entries.push_back(std::make_pair(Operation::Add, std::make_pair(key, listJson)));
+}
+
+void ConstListBatch::Add(const std::map<std::string, std::string>& lists)
+{
+	m_entries.reserve(m_entries.size() + lists.size());
+	for (auto it = lists.begin(); it != lists.end(); ++it)
+	{
+		Add(it->first, it->second);
+	}
+}
+
+void ConstListBatch::Remove(const std::string & key)
+{
+	m_entries.push_back(std::make_pair(Operation::Remove, std::make_pair(key, std::string())));
+}
+
+std::string ConstListBatch::Pack() const
+{
+	CompactWriter writer(sk_version);
+	writer.PutUInt(m_entries.size());
+	for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+	{
+		writer.PutUInt(static_cast<uint64_t>(it->first));
+		writer.PutBytes(it->second.first);
+		if (it->first == Operation::Add)
+		{
+			writer.PutBytes(it->second.second);
+		}
+	}
+	return writer.Release();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../Tools/StrView.h"
+
+namespace Decent
+{
+	namespace Ra
+	{
+		namespace WhiteList
+		{
+			/**
+			 * \brief	A batch of changes to the const white lists loaded into the Decent Server, so that a
+			 * 			large number of white lists can be given to the enclave in one ECALL. It's packed in
+			 * 			the compact binary encoding, i.e. a version byte, the number of entries, and then
+			 * 			the operation, the length-prefixed key, and (for additions) the length-prefixed
+			 * 			white list of each entry.
+			 */
+			class ConstListBatch
+			{
+			public: //static members:
+				/** \brief	Version of the compact binary encoding of the batch. */
+				static constexpr uint8_t sk_version = 1;
+
+				enum class Operation : uint8_t
+				{
+					Add = 0,
+					Remove = 1,
+				};
+
+				/** \brief	An entry of the batch. The key and the white list are views into the packed data. */
+				struct Entry
+				{
+					Operation m_op;
+					Tools::StrView m_key;
+					Tools::StrView m_listJson;
+				};
+
+				/**
+				 * \brief	Unpacks a batch. Only the format is checked here; the content of the white lists
+				 * 			are not checked.
+				 *
+				 * \exception	Decent::RuntimeException	Thrown when the data is malformed.
+				 *
+				 * \param	packed	The packed batch. It must outlive the returned entries.
+				 *
+				 * \return	The entries, in the order they are packed.
+				 */
+				static std::vector<Entry> Unpack(const Tools::StrView& packed);
+
+			public:
+				ConstListBatch();
+
+				virtual ~ConstListBatch();
+
+				/**
+				 * \brief	Adds (or replaces) a white list.
+				 *
+				 * \param	key			The key (i.e. index).
+				 * \param	listJson	The white list in JSON.
+				 */
+				void Add(const std::string& key, const std::string& listJson);
+
+				/**
+				 * \brief	Adds (or replaces) white lists.
+				 *
+				 * \param	lists	The white lists, in the format of Map[Key] = List_JSON.
+				 */
+				void Add(const std::map<std::string, std::string>& lists);
+
+				/**
+				 * \brief	Removes a white list.
+				 *
+				 * \param	key	The key (i.e. index).
+				 */
+				void Remove(const std::string& key);
+
+				/**
+				 * \brief	Gets the number of entries in the batch.
+				 *
+				 * \return	The number of entries.
+				 */
+				size_t GetSize() const noexcept { return m_entries.size(); }
+
+				/**
+				 * \brief	Packs the batch.
+				 *
+				 * \return	The packed batch.
+				 */
+				std::string Pack() const;
+
+			private:
+				std::vector<std::pair<Operation, std::pair<std::string, std::string> > > m_entries;
+			};
+		}
+	}
+}
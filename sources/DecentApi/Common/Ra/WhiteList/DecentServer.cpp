@@ -73,7 +73,7 @@ bool DecentServer::GetAcceptedTimestamp(const std::string & key, report_timestam
 bool DecentServer::VerifyCertFirstTime(States& decentState, const ServerX509Cert & cert, const std::string& pubKeyPem, std::string& serverHash, report_timestamp_t& timestamp)
 {
 	bool verifyRes = RaReport::ProcessSelfRaReport(cert.GetPlatformType(), pubKeyPem,
-		cert.GetSelfRaReport(), serverHash, timestamp);
+		cert.GetSelfRaReport(), cert.IsSelfRaReportCompact(), serverHash, timestamp);
 
 #ifndef DEBUG
 	return verifyRes &&
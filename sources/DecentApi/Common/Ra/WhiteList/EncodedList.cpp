@@ -0,0 +1,35 @@
+#include "EncodedList.h"
+
+using namespace Decent::Ra::WhiteList;
+
+EncodedList::EncodedList() :
+	LoadedList(),
+	m_json(),
+	m_compact(EncodeWhiteListCompact(GetMap()))
+{
+}
+
+EncodedList::EncodedList(const std::string & whiteListJson) :
+	LoadedList(whiteListJson),
+	m_json(whiteListJson),
+	m_compact(EncodeWhiteListCompact(GetMap()))
+{
+}
+
+EncodedList::EncodedList(const EncodedList & rhs) :
+	LoadedList(rhs),
+	m_json(rhs.m_json),
+	m_compact(rhs.m_compact)
+{
+}
+
+EncodedList::EncodedList(EncodedList && rhs) :
+	LoadedList(std::forward<LoadedList>(rhs)),
+	m_json(std::forward<std::string>(rhs.m_json)),
+	m_compact(std::forward<std::string>(rhs.m_compact))
+{
+}
+
+EncodedList::~EncodedList()
+{
+}
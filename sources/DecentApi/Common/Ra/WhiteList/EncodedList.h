@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+
+#include "LoadedList.h"
+
+namespace Decent
+{
+	namespace Ra
+	{
+		namespace WhiteList
+		{
+			/**
+			 * \brief	A loaded white list, together with its JSON and its compact binary encoding, so that
+			 * 			the white list is parsed and encoded only once, when it's loaded, rather than every
+			 * 			time it's embedded in a DECENT App certificate. It's immutable, thus, it can be
+			 * 			shared among threads without locking.
+			 */
+			class EncodedList : public LoadedList
+			{
+			public:
+				/** \brief	Constructs an empty white list. */
+				EncodedList();
+
+				/**
+				 * \brief	Constructor
+				 *
+				 * \exception	Decent::RuntimeException	Thrown when the JSON is not a valid white list.
+				 *
+				 * \param	whiteListJson	The white list in JSON.
+				 */
+				explicit EncodedList(const std::string& whiteListJson);
+
+				EncodedList(const EncodedList& rhs);
+
+				EncodedList(EncodedList&& rhs);
+
+				virtual ~EncodedList();
+
+				/**
+				 * \brief	Gets the white list in JSON, as it's loaded.
+				 *
+				 * \return	The white list in JSON.
+				 */
+				const std::string& GetJson() const noexcept { return m_json; }
+
+				/**
+				 * \brief	Gets the white list in the compact binary encoding (see
+				 * 			LoadedList::EncodeWhiteListCompact).
+				 *
+				 * \return	The white list in the compact binary encoding.
+				 */
+				const std::string& GetCompact() const noexcept { return m_compact; }
+
+			private:
+				std::string m_json;
+				std::string m_compact;
+			};
+		}
+	}
+}
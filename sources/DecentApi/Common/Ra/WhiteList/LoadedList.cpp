@@ -12,6 +12,7 @@
 #include "../../RuntimeException.h"
 #include "../../GeneralKeyTypes.h"
 #include "../../Tools/JsonTools.h"
+#include "../../Tools/CompactCoding.h"
 #include "../../MbedTls/Hasher.h"
 
 #include "../AppX509Cert.h"
@@ -26,21 +27,30 @@ namespace
 	{
 		using namespace Decent::MbedTlsObj;
 
-		std::string whiteListStr = "DecentWhiteList{";
+		//Entries are fed to the hasher directly; the result is the same as hashing the string
+		//"DecentWhiteList{<hash1>::<name1><hash2>::<name2>...}".
+		static constexpr char sk_prefix[] = "DecentWhiteList{";
+		static constexpr char sk_separator[] = "::";
+		static constexpr char sk_suffix[] = "}";
+
+		Hasher<HashType::SHA256> hasher;
+		hasher.Update(sk_prefix, sizeof(sk_prefix) - 1);
 		for (auto it = whiteList.begin(); it != whiteList.end(); ++it)
 		{
-			whiteListStr += (it->first + "::" + it->second);
+			hasher.Update(it->first);
+			hasher.Update(sk_separator, sizeof(sk_separator) - 1);
+			hasher.Update(it->second);
 		}
-		whiteListStr += "}";
+		hasher.Update(sk_suffix, sizeof(sk_suffix) - 1);
 
 		Decent::General256Hash hash;
-		Hasher<HashType::SHA256>().Calc(hash, whiteListStr);
+		hasher.Finish(hash);
 
 		return cppcodec::base64_rfc4648::encode(hash);
 	}
 }
 
-WhiteListType LoadedList::ParseWhiteListFromJson(const std::string & whiteListJson)
+WhiteListType LoadedList::ParseWhiteListFromJson(const StrView & whiteListJson)
 {
 	WhiteListType res;
 	if (whiteListJson.size() == 0)
@@ -48,8 +58,10 @@ WhiteListType LoadedList::ParseWhiteListFromJson(const std::string & whiteListJs
 		return res;
 	}
 
+	//The document points into this buffer (in enclave build), so it's declared first.
+	std::string jsonBuf = whiteListJson.ToString();
 	JsonDoc doc;
-	ParseStr2Json(doc, whiteListJson);
+	ParseStr2JsonInsitu(doc, jsonBuf);
 	if (!doc.JSON_IS_OBJECT())
 	{
 		throw Decent::RuntimeException("Failed to parse white list from JSON.");
@@ -61,11 +73,51 @@ WhiteListType LoadedList::ParseWhiteListFromJson(const std::string & whiteListJs
 		{
 			throw Decent::RuntimeException("Failed to parse white list from JSON.");
 		}
-		res[JSON_IT_GETKEY(it).JSON_AS_STRING()] = JSON_IT_GETVALUE(it).JSON_AS_STRING();
+		const JsonStrView appName = JsonAsStrView(JSON_IT_GETVALUE(it));
+		res[JSON_IT_GETKEY(it).JSON_AS_STRING()].assign(appName.data(), appName.size());
+	}
+	return res;
+}
+
+WhiteListType LoadedList::ParseWhiteListFromCompact(const StrView & whiteListBin)
+{
+	WhiteListType res;
+
+	CompactReader reader(whiteListBin, LoadedCompact::sk_version);
+	const uint64_t count = reader.GetUInt();
+	for (uint64_t i = 0; i < count; ++i)
+	{
+		const StrView hash = reader.GetBytes();
+		const StrView appName = reader.GetBytes();
+		res.emplace_hint(res.end(), hash.ToString(), appName.ToString());
+	}
+
+	if (!reader.IsEnd())
+	{
+		throw Decent::RuntimeException("Failed to parse white list from compact binary data.");
 	}
 	return res;
 }
 
+std::string LoadedList::EncodeWhiteListCompact(const WhiteListType & whiteList)
+{
+	CompactWriter writer(LoadedCompact::sk_version);
+	writer.PutUInt(whiteList.size());
+	for (auto it = whiteList.begin(); it != whiteList.end(); ++it)
+	{
+		writer.PutBytes(it->first);
+		writer.PutBytes(it->second);
+	}
+	return writer.Release();
+}
+
+WhiteListType LoadedList::ParseWhiteList(const AppX509Cert & cert)
+{
+	return cert.IsWhiteListCompact() ?
+		ParseWhiteListFromCompact(cert.GetWhiteList()) :
+		ParseWhiteListFromJson(cert.GetWhiteList());
+}
+
 LoadedList::LoadedList() :
 	StaticList(WhiteListType()),
 	m_listHash(ConstructWhiteListHashString(StaticList::GetMap()))
@@ -96,7 +148,7 @@ LoadedList::LoadedList(LoadedList&& rhs) :
 {}
 
 LoadedList::LoadedList(const AppX509Cert& certPtr) :
-	LoadedList(certPtr.GetWhiteList())
+	LoadedList(ParseWhiteList(certPtr))
 {
 }
 
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <cstdint>
+
 #include "StaticList.h"
 
+#include "../../Tools/StrView.h"
+
 namespace Decent
 {
 	namespace Ra
@@ -16,10 +20,46 @@ namespace Decent
 				constexpr char const sk_LabelList[] = "List";
 			}
 
+			namespace LoadedCompact
+			{
+				/** \brief	Version of the compact binary encoding of the whitelist. */
+				constexpr uint8_t sk_version = 1;
+			}
+
 			class LoadedList : public StaticList
 			{
 			public: //static member:
-				static WhiteListType ParseWhiteListFromJson(const std::string & whiteListJson);
+				static WhiteListType ParseWhiteListFromJson(const Tools::StrView & whiteListJson);
+
+				/**
+				 * \brief	Parses the whitelist in the compact binary encoding, i.e. a version byte, the
+				 * 			number of entries, and then the length-prefixed hash and app name of each entry.
+				 *
+				 * \exception	Decent::RuntimeException	Thrown when the data is malformed.
+				 *
+				 * \param	whiteListBin	The whitelist in the compact binary encoding.
+				 *
+				 * \return	The whitelist.
+				 */
+				static WhiteListType ParseWhiteListFromCompact(const Tools::StrView & whiteListBin);
+
+				/**
+				 * \brief	Encodes the whitelist in the compact binary encoding.
+				 *
+				 * \param	whiteList	The whitelist.
+				 *
+				 * \return	The whitelist in the compact binary encoding.
+				 */
+				static std::string EncodeWhiteListCompact(const WhiteListType & whiteList);
+
+				/**
+				 * \brief	Parses the whitelist embedded in the DECENT App certificate, in either encoding.
+				 *
+				 * \param	cert	The DECENT App certificate.
+				 *
+				 * \return	The whitelist.
+				 */
+				static WhiteListType ParseWhiteList(const Ra::AppX509Cert & cert);
 
 			public:
 				LoadedList();
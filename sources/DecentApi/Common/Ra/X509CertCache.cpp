@@ -0,0 +1,79 @@
+#include "X509CertCache.h"
+
+#include <mbedtls/x509_crt.h>
+
+#include "../MbedTls/Hasher.h"
+
+#include "AppX509Cert.h"
+#include "ServerX509Cert.h"
+#include "VerifiedAppX509Cert.h"
+
+using namespace Decent;
+using namespace Decent::Ra;
+using namespace Decent::Tools;
+using namespace Decent::MbedTlsObj;
+
+namespace
+{
+	template<typename CertType>
+	std::shared_ptr<const CertType> GetOrParse(SharedCachingQueue<General256Hash, const CertType>& queue, const mbedtls_x509_crt& cert)
+	{
+		General256Hash derHash;
+		Hasher<HashType::SHA256> hasher;
+		hasher.Update(cert.raw.p, cert.raw.len);
+		hasher.Finish(derHash);
+
+		std::shared_ptr<const CertType> res = queue.Get(derHash);
+		if (res)
+		{
+			return res;
+		}
+
+		//Parse a private copy of the DER, so that the cached object doesn't depend on mbedTLS's buffer.
+		res = std::make_shared<const CertType>(std::vector<uint8_t>(cert.raw.p, cert.raw.p + cert.raw.len));
+		queue.Put(derHash, res, false);
+
+		return res;
+	}
+}
+
+constexpr size_t X509CertCache::sk_defaultCacheSize;
+
+X509CertCache & X509CertCache::GetDefault()
+{
+	static X509CertCache inst(sk_defaultCacheSize);
+	return inst;
+}
+
+X509CertCache::X509CertCache(size_t cacheSize) :
+	m_appCerts(cacheSize),
+	m_serverCerts(cacheSize),
+	m_verifiedAppCerts(cacheSize)
+{
+}
+
+X509CertCache::~X509CertCache()
+{
+}
+
+std::shared_ptr<const AppX509Cert> X509CertCache::GetAppCert(const mbedtls_x509_crt & cert)
+{
+	return GetOrParse(m_appCerts, cert);
+}
+
+std::shared_ptr<const ServerX509Cert> X509CertCache::GetServerCert(const mbedtls_x509_crt & cert)
+{
+	return GetOrParse(m_serverCerts, cert);
+}
+
+std::shared_ptr<const VerifiedAppX509Cert> X509CertCache::GetVerifiedAppCert(const mbedtls_x509_crt & cert)
+{
+	return GetOrParse(m_verifiedAppCerts, cert);
+}
+
+void X509CertCache::Clear()
+{
+	m_appCerts.Clear();
+	m_serverCerts.Clear();
+	m_verifiedAppCerts.Clear();
+}
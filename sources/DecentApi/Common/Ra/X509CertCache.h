@@ -0,0 +1,100 @@
+#pragma once
+
+#include <memory>
+
+#include "../GeneralKeyTypes.h"
+#include "../Tools/SharedCachingQueue.h"
+
+typedef struct mbedtls_x509_crt mbedtls_x509_crt;
+
+namespace Decent
+{
+	namespace Ra
+	{
+		class AppX509Cert;
+		class ServerX509Cert;
+		class VerifiedAppX509Cert;
+
+		/**
+		 * \brief	A bounded, thread-safe LRU cache of parsed DECENT certificates, keyed by the SHA-256
+		 * 			hash of the DER encoding. Peers that reconnect often present the same certificate
+		 * 			chain, thus, the ASN.1 parsing and extension extraction can be done only once per
+		 * 			certificate. Only the parsing result is cached; the trust decision is still made by
+		 * 			the caller on every handshake.
+		 * 			Cached objects are shared and immutable, thus, they must not be modified (e.g. by
+		 * 			moving the cursor along the chain).
+		 */
+		class X509CertCache
+		{
+		public: //static members:
+			static constexpr size_t sk_defaultCacheSize = 64;
+
+			/**
+			 * \brief	Gets the cache shared by all DECENT TLS configurations in this process.
+			 *
+			 * \return	The default cache.
+			 */
+			static X509CertCache& GetDefault();
+
+		public:
+			X509CertCache() = delete;
+
+			/**
+			 * \brief	Constructor
+			 *
+			 * \param	cacheSize	Maximum number of certificates cached for each certificate type.
+			 */
+			X509CertCache(size_t cacheSize);
+
+			X509CertCache(const X509CertCache& rhs) = delete;
+
+			X509CertCache(X509CertCache&& rhs) = delete;
+
+			virtual ~X509CertCache();
+
+			/**
+			 * \brief	Gets the parsed DECENT App certificate for the given certificate. It's parsed and
+			 * 			cached if it is not in the cache yet.
+			 *
+			 * \exception	Decent::MbedTlsObj::MbedTlsException	Thrown when the certificate can't be parsed.
+			 *
+			 * \param	cert	The certificate given by mbedTLS.
+			 *
+			 * \return	The parsed certificate.
+			 */
+			std::shared_ptr<const AppX509Cert> GetAppCert(const mbedtls_x509_crt& cert);
+
+			/**
+			 * \brief	Gets the parsed DECENT Server certificate for the given certificate. It's parsed and
+			 * 			cached if it is not in the cache yet.
+			 *
+			 * \exception	Decent::MbedTlsObj::MbedTlsException	Thrown when the certificate can't be parsed.
+			 *
+			 * \param	cert	The certificate given by mbedTLS.
+			 *
+			 * \return	The parsed certificate.
+			 */
+			std::shared_ptr<const ServerX509Cert> GetServerCert(const mbedtls_x509_crt& cert);
+
+			/**
+			 * \brief	Gets the parsed DECENT Verified App certificate for the given certificate. It's
+			 * 			parsed and cached if it is not in the cache yet.
+			 *
+			 * \exception	Decent::MbedTlsObj::MbedTlsException	Thrown when the certificate can't be parsed.
+			 *
+			 * \param	cert	The certificate given by mbedTLS.
+			 *
+			 * \return	The parsed certificate.
+			 */
+			std::shared_ptr<const VerifiedAppX509Cert> GetVerifiedAppCert(const mbedtls_x509_crt& cert);
+
+			/** \brief	Removes all cached certificates. */
+			virtual void Clear();
+
+		private:
+			Tools::SharedCachingQueue<General256Hash, const AppX509Cert> m_appCerts;
+			Tools::SharedCachingQueue<General256Hash, const ServerX509Cert> m_serverCerts;
+			Tools::SharedCachingQueue<General256Hash, const VerifiedAppX509Cert> m_verifiedAppCerts;
+		};
+	}
+}
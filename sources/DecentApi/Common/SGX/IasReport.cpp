@@ -216,8 +216,10 @@ static uint8_t ParsePseStatus(const std::string& str)
 
 void Ias::ParseIasReport(sgx_ias_report_t & outReport, std::string& outId, std::string& outNonce, const std::string & inStr)
 {
+	//The document points into this buffer (in enclave build), so it's declared first.
+	std::string jsonBuf(inStr);
 	JsonDoc jsonDoc;
-	ParseStr2Json(jsonDoc, inStr);
+	ParseStr2JsonInsitu(jsonDoc, jsonBuf);
 
 	//ID: (Mandatory)
 	if (!jsonDoc.JSON_HAS_MEMBER(gsk_repLblId) || !jsonDoc[gsk_repLblId].JSON_IS_STRING())
@@ -267,8 +269,8 @@ void Ias::ParseIasReport(sgx_ias_report_t & outReport, std::string& outId, std::
 	//PSE Hash: (Optional)
 	if (jsonDoc.JSON_HAS_MEMBER(gsk_repLblPseHash) && jsonDoc[gsk_repLblPseHash].JSON_IS_STRING())
 	{
-		std::string psehashHex(jsonDoc[gsk_repLblPseHash].JSON_AS_STRING());
-		cppcodec::hex_upper::decode(reinterpret_cast<uint8_t*>(&outReport.m_pse_hash), sizeof(outReport.m_pse_hash), psehashHex.c_str(), psehashHex.size());
+		const JsonStrView psehashHex = JsonAsStrView(jsonDoc[gsk_repLblPseHash]);
+		cppcodec::hex_upper::decode(reinterpret_cast<uint8_t*>(&outReport.m_pse_hash), sizeof(outReport.m_pse_hash), psehashHex.data(), psehashHex.size());
 	}
 
 	//Info Blob: (Optional)
@@ -279,16 +281,19 @@ void Ias::ParseIasReport(sgx_ias_report_t & outReport, std::string& outId, std::
 		{
 			THROW_REPORT_PARSE_ERROR("Failed to parse info blob.");
 		}
-		std::string infoBlobHex = jsonDoc[gsk_repLblInfoBlob].JSON_AS_STRING();
-		uint16_t size = static_cast<uint16_t>(std::stoi(infoBlobHex.substr(4, 4), nullptr, 16));
+		const JsonStrView infoBlobHex = JsonAsStrView(jsonDoc[gsk_repLblInfoBlob]);
+		if (infoBlobHex.size() < 8)
+		{
+			THROW_REPORT_PARSE_ERROR("Failed to parse info blob.");
+		}
+		uint16_t size = static_cast<uint16_t>(std::stoi(std::string(infoBlobHex.data() + 4, 4), nullptr, 16));
 		if (size != sizeof(outReport.m_info_blob))
 		{
 			THROW_REPORT_PARSE_ERROR("Failed to parse info blob.");
 		}
-		//uint16_t typeCode = static_cast<uint16_t>(std::stoi(infoBlobHex.substr(0, 4), nullptr, 16)); //Not in use for now.
+		//uint16_t typeCode = static_cast<uint16_t>(std::stoi(std::string(infoBlobHex.data(), 4), nullptr, 16)); //Not in use for now.
 
-		infoBlobHex = infoBlobHex.substr(8);
-		cppcodec::hex_upper::decode(reinterpret_cast<uint8_t*>(&outReport.m_info_blob), sizeof(outReport.m_info_blob), infoBlobHex.data(), infoBlobHex.size());
+		cppcodec::hex_upper::decode(reinterpret_cast<uint8_t*>(&outReport.m_info_blob), sizeof(outReport.m_info_blob), infoBlobHex.data() + 8, infoBlobHex.size() - 8);
 	}
 	
 	//Nonce: (Optional)
@@ -301,8 +306,8 @@ void Ias::ParseIasReport(sgx_ias_report_t & outReport, std::string& outId, std::
 	if (jsonDoc.JSON_HAS_MEMBER(gsk_repLblEpidPsy) && jsonDoc[gsk_repLblEpidPsy].JSON_IS_STRING())
 	{
 		outReport.m_is_epid_pse_valid = 1;
-		std::string epidPseHex(jsonDoc[gsk_repLblEpidPsy].JSON_AS_STRING());
-		DeserializeStruct(outReport.m_epidPseudonym, epidPseHex);
+		const JsonStrView epidPseB64 = JsonAsStrView(jsonDoc[gsk_repLblEpidPsy]);
+		DeserializeStruct(outReport.m_epidPseudonym, epidPseB64.data(), epidPseB64.size());
 	}
 
 	//Quote Body:
@@ -310,7 +315,8 @@ void Ias::ParseIasReport(sgx_ias_report_t & outReport, std::string& outId, std::
 	{
 		THROW_REPORT_PARSE_ERROR("Failed to parse quote body.");
 	}
-	DeserializeStruct(outReport.m_quote, jsonDoc[gsk_repLblQuoteBody].JSON_AS_STRING());
+	const JsonStrView quoteBodyB64 = JsonAsStrView(jsonDoc[gsk_repLblQuoteBody]);
+	DeserializeStruct(outReport.m_quote, quoteBodyB64.data(), quoteBodyB64.size());
 }
 
 bool Ias::ParseIasReportAndCheckSignature(sgx_ias_report_t & outIasReport, const std::string & iasReportStr, const std::string & reportCert, const std::string & reportSign, const char * nonce)
@@ -0,0 +1,333 @@
+#include "RaSpHandshake.h"
+
+#include <sgx_key_exchange.h>
+
+#include "../Net/RpcWriter.h"
+#include "../Net/RpcParser.h"
+#include "../Net/NetworkException.h"
+
+#include "../MbedTls/Kdf.h"
+#include "../MbedTls/Drbg.h"
+#include "../MbedTls/Hasher.h"
+#include "../MbedTls/SafeWrappers.h"
+#include "../MbedTls/TlsPrf.h"
+
+#include "../make_unique.h"
+#include "../consttime_memequal.h"
+#include "RaTicket.h"
+#include "RaProcessorSp.h"
+
+using namespace Decent::Net;
+using namespace Decent::Sgx;
+using namespace Decent::Tools;
+using namespace Decent::MbedTlsObj;
+
+namespace
+{
+	static constexpr uint8_t gsk_resumeSucc = 1;
+	static constexpr uint8_t gsk_resumeFail = 0;
+
+	static constexpr uint8_t gsk_hasNewTicket = 1;
+	static constexpr uint8_t gsk_noNewTicket = 0;
+
+	static constexpr char const gsk_keyDerLabel[] = "new_session_keys";
+	static constexpr char const gsk_finishLabel[] = "finished";
+	static constexpr size_t gsk_defPrfResSize = 12;
+
+	static RaSpHandshake::OutMsg RpcToOutMsg(const RpcWriter& rpc)
+	{
+		//Same as ConnectionBase::SendRpc.
+		return RaSpHandshake::OutMsg{ !rpc.HasSizeAtFront(), rpc.GetFullBinary() };
+	}
+
+	static RaSpHandshake::OutMsg GenerateTicket(const RaSession& session, const RaSpHandshake::TicketSealer& sealFunc)
+	{
+		std::vector<uint8_t> neTicket;
+
+		try
+		{
+			std::vector<uint8_t> sessionBin(session.GetSize());
+			session.ToBinary(sessionBin.begin(), sessionBin.end());
+			neTicket = sealFunc(sessionBin);
+
+			ZeroizeContainer(sessionBin);
+		}
+		catch (const std::exception&)
+		{
+			//Failed to seal the data, and tells client there is no ticket.
+			RpcWriter rpcNoTicket(RpcWriter::CalcSizePrim<uint8_t>(),
+				1);
+			rpcNoTicket.AddPrimitiveArg<uint8_t>() = gsk_noNewTicket;
+
+			return RpcToOutMsg(rpcNoTicket);
+		}
+
+		RpcWriter rpcNewTicket(RpcWriter::CalcSizePrim<uint8_t>() +
+			RpcWriter::CalcSizeBin(neTicket.size()), 2);
+		rpcNewTicket.AddPrimitiveArg<uint8_t>() = gsk_hasNewTicket;
+		rpcNewTicket.AddBinaryArg(neTicket.size()).Set(neTicket);
+
+		return RpcToOutMsg(rpcNewTicket);
+	}
+}
+
+constexpr size_t RaSpHandshake::sk_packed;
+
+RaSpHandshake::RaSpHandshake(std::unique_ptr<RaProcessorSp> raProcessor, TicketSealer sealFunc, TicketSealer unsealFunc) :
+	m_raProcessor(std::move(raProcessor)),
+	m_sealFunc(sealFunc),
+	m_unsealFunc(unsealFunc),
+	m_state(State::RecvTicketRpc),
+	m_isResumed(false),
+	m_session(),
+	m_nonces{ 0, 0 },
+	m_selfMsgHash(),
+	m_peerMsgHash()
+{
+	if (!m_raProcessor)
+	{
+		throw Exception("Null pointer is given to the RA Processor SP handshake.");
+	}
+}
+
+RaSpHandshake::RaSpHandshake(RaSpHandshake && rhs) :
+	m_raProcessor(std::move(rhs.m_raProcessor)),
+	m_sealFunc(std::move(rhs.m_sealFunc)),
+	m_unsealFunc(std::move(rhs.m_unsealFunc)),
+	m_state(rhs.m_state),
+	m_isResumed(rhs.m_isResumed),
+	m_session(std::move(rhs.m_session)),
+	m_nonces(rhs.m_nonces),
+	m_selfMsgHash(rhs.m_selfMsgHash),
+	m_peerMsgHash(rhs.m_peerMsgHash)
+{
+	rhs.m_state = State::Failed;
+}
+
+RaSpHandshake::~RaSpHandshake()
+{
+}
+
+size_t RaSpHandshake::GetExpectedSize() const
+{
+	switch (m_state)
+	{
+	case State::RecvMsg0s:
+		return sizeof(sgx_ra_msg0s_t);
+	case State::RecvMsg1:
+		return sizeof(sgx_ra_msg1_t);
+	default:
+		return sk_packed;
+	}
+}
+
+void RaSpHandshake::Process(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs)
+{
+	try
+	{
+		switch (m_state)
+		{
+		case State::RecvTicketRpc:
+			ProcessTicketRpc(inMsg, outMsgs);
+			break;
+		case State::RecvResumeVrfy:
+			ProcessResumeVrfy(inMsg, outMsgs);
+			break;
+		case State::RecvMsg0s:
+			ProcessMsg0s(inMsg, outMsgs);
+			break;
+		case State::RecvMsg1:
+			ProcessMsg1(inMsg, outMsgs);
+			break;
+		case State::RecvMsg3:
+			ProcessMsg3(inMsg, outMsgs);
+			break;
+		default:
+			throw Exception("Decent::Sgx::RaSpHandshake is not expecting any message.");
+		}
+	}
+	catch (const std::exception&)
+	{
+		m_state = State::Failed;
+		m_session.reset();
+		throw;
+	}
+}
+
+std::unique_ptr<RaSession> RaSpHandshake::ReleaseSession()
+{
+	return m_state == State::Done ? std::move(m_session) : nullptr;
+}
+
+// Server steps of the session resumption:
+//     1. <--- Recv client RPC, ("HasTicket" || Ticket || Nonce) OR ("NoTicket")
+//     If no ticket:
+//        FALL BACK to standard RA...
+//     Else if failed to unseal ticket:
+//        2. ---> Send "NotAccepted" RPC, ("NotAccepted")
+//        FALL BACK to standard RA...
+//     Else:
+//        2. ---> Send "Accepted" RPC, ("Accepted" || Nonce)
+//        3. Recv verification message, TLS-PRF(key=secret_key, gsk_finishLabel, Hash(Accepted_RPC))
+//        4. Send verification message, TLS-PRF(key=secret_key, gsk_finishLabel, Hash(RPC_from_client))
+//        5. Derive new set of keys: new_secret_key = HKDF(secret_key, label="new_session_keys", salt=(client_nonce || Nonce))
+//                                   new_masking_key = HKDF(masking_key, label="new_session_keys", salt=(client_nonce || Nonce))
+void RaSpHandshake::ProcessTicketRpc(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs)
+{
+	uint64_t& peerNonce = m_nonces[0];
+	uint64_t& selfNonce = m_nonces[1];
+
+	// 1. Recv client's RPC
+	{
+		RpcParser rpcResuTicket(inMsg);
+
+		uint8_t hasTicket = rpcResuTicket.GetPrimitiveArg<uint8_t>();
+
+		if (!hasTicket)
+		{
+			StartRa(); // Client doesn't have ticket.
+			return;
+		}
+
+		try
+		{
+			Hasher<HashType::SHA256>().Calc(m_peerMsgHash, rpcResuTicket.GetFullBinary());
+
+			auto ticketSpace = rpcResuTicket.GetBinaryArg();
+			std::vector<uint8_t> sessionBin = m_unsealFunc(std::vector<uint8_t>(ticketSpace.first, ticketSpace.second));
+			peerNonce = rpcResuTicket.GetPrimitiveArg<uint64_t>();
+
+			m_session = Decent::Tools::make_unique<RaSession>(sessionBin.cbegin(), sessionBin.cend());
+		}
+		catch (const std::exception&)
+		{
+			//Failed to unseal the ticket, inform the client, and go ahead and generate a new session.
+
+			RpcWriter rpcFailedResu(RpcWriter::CalcSizePrim<uint8_t>(), 1);
+			rpcFailedResu.AddPrimitiveArg<uint8_t>() = gsk_resumeFail;
+			outMsgs.push_back(RpcToOutMsg(rpcFailedResu));
+
+			StartRa();
+			return;
+		}
+	}
+
+	// 2. Generate a nonce:
+	Drbg drbg;
+	drbg.RandStruct(selfNonce);
+
+	// 3. Send resume result:
+	{
+		RpcWriter rpcSuccResu(RpcWriter::CalcSizePrim<uint8_t>() +
+			RpcWriter::CalcSizePrim<uint64_t>(), 2, false);
+
+		rpcSuccResu.AddPrimitiveArg<uint8_t>() = gsk_resumeSucc;
+		rpcSuccResu.AddPrimitiveArg<uint64_t>() = selfNonce;
+		outMsgs.push_back(RpcToOutMsg(rpcSuccResu));
+
+		Hasher<HashType::SHA256>().Calc(m_selfMsgHash, rpcSuccResu.GetFullBinary());
+	}
+
+	m_state = State::RecvResumeVrfy;
+}
+
+void RaSpHandshake::ProcessResumeVrfy(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs)
+{
+	// 4. Recv client's verification message:
+	{
+		std::array<uint8_t, gsk_defPrfResSize> selfPrfRes;
+		TlsPrf<HashType::SHA256>(m_session->m_secretKey, gsk_finishLabel, m_selfMsgHash, selfPrfRes);
+
+		if (inMsg.size() != selfPrfRes.size() ||
+			!consttime_memequal(inMsg.data(), selfPrfRes.data(), selfPrfRes.size()))
+		{
+			// At this step, we don't fall back to RA process.
+			throw Exception("Failed to verify ticket resume message from client.");
+		}
+	}
+
+	// 5. Send server's verification message:
+	{
+		std::array<uint8_t, gsk_defPrfResSize> peerPrfRes;
+		TlsPrf<HashType::SHA256>(m_session->m_secretKey, gsk_finishLabel, m_peerMsgHash, peerPrfRes);
+
+		outMsgs.push_back(OutMsg{ true, std::vector<uint8_t>(peerPrfRes.begin(), peerPrfRes.end()) });
+	}
+
+	// 6. Derive new keys to prevent replay attack:
+	RaSession currSession;
+	HKDF<HashType::SHA256>(m_session->m_secretKey.m_key, gsk_keyDerLabel, m_nonces, currSession.m_secretKey.m_key);
+	HKDF<HashType::SHA256>(m_session->m_maskingKey.m_key, gsk_keyDerLabel, m_nonces, currSession.m_maskingKey.m_key);
+
+	m_session->m_secretKey = currSession.m_secretKey;
+	m_session->m_maskingKey = currSession.m_maskingKey;
+
+	m_isResumed = true;
+	m_state = State::Done;
+}
+
+// SP side steps of the standard RA:
+//     2. <--- Recv RA MSG 0 Send
+//     3. ---> Send RA MSG 0 Resp
+//     4. <--- Recv RA MSG 1
+//     5. ---> Send RA MSG 2
+//     6. <--- Recv RA MSG 3
+//     7. ---> Send RA MSG 4
+//     8. ---> Send new ticket
+void RaSpHandshake::StartRa()
+{
+	m_session.reset();
+	m_raProcessor->Init();
+	m_state = State::RecvMsg0s;
+}
+
+void RaSpHandshake::ProcessMsg0s(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs)
+{
+	if (inMsg.size() != sizeof(sgx_ra_msg0s_t))
+	{
+		throw Exception("Decent::Sgx::RaSpHandshake received invalid RA MSG 0.");
+	}
+
+	std::vector<uint8_t> msg0r(sizeof(sgx_ra_msg0r_t));
+	m_raProcessor->ProcessMsg0(*reinterpret_cast<const sgx_ra_msg0s_t*>(inMsg.data()), *reinterpret_cast<sgx_ra_msg0r_t*>(msg0r.data()));
+
+	outMsgs.push_back(OutMsg{ false, std::move(msg0r) });
+	m_state = State::RecvMsg1;
+}
+
+void RaSpHandshake::ProcessMsg1(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs)
+{
+	if (inMsg.size() != sizeof(sgx_ra_msg1_t))
+	{
+		throw Exception("Decent::Sgx::RaSpHandshake received invalid RA MSG 1.");
+	}
+
+	std::vector<uint8_t> msg2;
+	m_raProcessor->ProcessMsg1(*reinterpret_cast<const sgx_ra_msg1_t*>(inMsg.data()), msg2);
+
+	outMsgs.push_back(OutMsg{ true, std::move(msg2) });
+	m_state = State::RecvMsg3;
+}
+
+void RaSpHandshake::ProcessMsg3(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs)
+{
+	if (inMsg.size() < sizeof(sgx_ra_msg3_t))
+	{
+		throw Exception("Decent::Sgx::RaProcessorSp DoHandShake Failed.");
+	}
+
+	std::vector<uint8_t> msg4;
+	m_raProcessor->ProcessMsg3(*reinterpret_cast<const sgx_ra_msg3_t*>(inMsg.data()), inMsg.size(), msg4, nullptr);
+
+	outMsgs.push_back(OutMsg{ true, std::move(msg4) });
+
+	m_session = Decent::Tools::make_unique<RaSession>();
+
+	m_session->m_secretKey = m_raProcessor->GetSK();
+	m_session->m_maskingKey = m_raProcessor->GetMK();
+	m_session->m_iasReport = *m_raProcessor->ReleaseIasReport();
+
+	outMsgs.push_back(GenerateTicket(*m_session, m_sealFunc));
+
+	m_state = State::Done;
+}
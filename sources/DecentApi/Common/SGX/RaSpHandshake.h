@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <functional>
+
+#include "../GeneralKeyTypes.h"
+
+namespace Decent
+{
+	namespace Sgx
+	{
+		class RaProcessorSp;
+		struct RaSession;
+
+		/**
+		 * \brief	The SP side of the RA handshake (i.e. the session resumption from the ticket, the RA
+		 * 			messages 0 to 4, and the new ticket), in the form of a state machine that is driven by
+		 * 			the arrival of each message from the client. Thus, it doesn't hold any thread or
+		 * 			connection between the rounds, and many handshakes can be parked at the same time (see
+		 * 			RaSpSessionPool). The messages produced are the same as the ones of RaSpCommLayer,
+		 * 			which is a blocking driver of this class.
+		 */
+		class RaSpHandshake
+		{
+		public: //static members:
+			typedef std::function<std::vector<uint8_t>(const std::vector<uint8_t>&)> TicketSealer;
+
+			/** \brief	The expected size of a message sent as a package (i.e. with its size at front). */
+			static constexpr size_t sk_packed = 0;
+
+			enum class State
+			{
+				RecvTicketRpc,  //Waiting for the client's RPC, with or without a ticket.
+				RecvResumeVrfy, //Waiting for the client's verification message of the session resumption.
+				RecvMsg0s,
+				RecvMsg1,
+				RecvMsg3,
+				Done,
+				Failed,
+			};
+
+			/** \brief	A message to be sent to the client. */
+			struct OutMsg
+			{
+				bool m_isPacked; //True if it should be sent as a package (e.g. by SendPack); false if it's raw.
+				std::vector<uint8_t> m_data;
+			};
+
+		public:
+			RaSpHandshake() = delete;
+
+			/**
+			 * \brief	Constructor
+			 *
+			 * \exception	Decent::RuntimeException	Thrown when the RA processor is null.
+			 *
+			 * \param	raProcessor	The SGX RA processor for SP side.
+			 * \param	sealFunc   	The seal function. See RaSpCommLayer.
+			 * \param	unsealFunc 	The unseal function. See RaSpCommLayer.
+			 */
+			RaSpHandshake(std::unique_ptr<RaProcessorSp> raProcessor, TicketSealer sealFunc, TicketSealer unsealFunc);
+
+			RaSpHandshake(const RaSpHandshake&) = delete;
+
+			RaSpHandshake(RaSpHandshake&& rhs);
+
+			virtual ~RaSpHandshake();
+
+			/**
+			 * \brief	Gets the size of the message expected next.
+			 *
+			 * \return	The size of the raw message expected, or sk_packed if it's a package.
+			 */
+			size_t GetExpectedSize() const;
+
+			/**
+			 * \brief	Process a message received from the client, and moves to the next state. If the
+			 * 			handshake fails, the state becomes State::Failed, and the exception is re-thrown.
+			 *
+			 * \exception	Decent::Net::Exception	Thrown when the message is invalid, or the handshake
+			 * 										is not expecting any message.
+			 *
+			 * \param 		  	inMsg  	The message received.
+			 * \param [in,out]	outMsgs	The messages to be sent to the client, in order, which are
+			 * 							appended to the vector.
+			 */
+			virtual void Process(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs);
+
+			State GetState() const noexcept { return m_state; }
+
+			bool IsDone() const noexcept { return m_state == State::Done; }
+
+			/**
+			 * \brief	Query if the session is resumed from the client's ticket.
+			 *
+			 * \return	True if resumed, false if not.
+			 */
+			bool IsResumed() const noexcept { return m_isResumed; }
+
+			/**
+			 * \brief	Releases the session established.
+			 *
+			 * \return	The session, or null if the handshake is not done.
+			 */
+			std::unique_ptr<RaSession> ReleaseSession();
+
+		protected:
+			void ProcessTicketRpc(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs);
+
+			void ProcessResumeVrfy(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs);
+
+			void ProcessMsg0s(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs);
+
+			void ProcessMsg1(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs);
+
+			void ProcessMsg3(const std::vector<uint8_t>& inMsg, std::vector<OutMsg>& outMsgs);
+
+			/** \brief	Falls back to the standard RA. */
+			void StartRa();
+
+		private:
+			std::unique_ptr<RaProcessorSp> m_raProcessor;
+			TicketSealer m_sealFunc;
+			TicketSealer m_unsealFunc;
+
+			State m_state;
+			bool m_isResumed;
+			std::unique_ptr<RaSession> m_session;
+
+			//States of the session resumption:
+			std::array<uint64_t, 2> m_nonces; //Client nonce is at first position; server's is at second.
+			General256Hash m_selfMsgHash;
+			General256Hash m_peerMsgHash;
+		};
+	}
+}
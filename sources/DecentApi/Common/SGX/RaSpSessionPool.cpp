@@ -0,0 +1,148 @@
+#include "RaSpSessionPool.h"
+
+#include "../Common.h"
+#include "../RuntimeException.h"
+#include "../Net/NetworkException.h"
+
+#include "RaTicket.h"
+
+using namespace Decent::Net;
+using namespace Decent::Sgx;
+
+RaSpSessionPool::RaSpSessionPool(size_t maxSessions, time_t timeout) :
+	m_maxSessions(maxSessions),
+	m_timeout(timeout),
+	m_sessionsMutex(),
+	m_sessions()
+{
+}
+
+RaSpSessionPool::~RaSpSessionPool()
+{
+}
+
+bool RaSpSessionPool::Start(uint64_t id, std::unique_ptr<RaSpHandshake> handshake)
+{
+	if (!handshake)
+	{
+		throw Decent::RuntimeException("Null pointer is given to RaSpSessionPool::Start.");
+	}
+
+	const time_t expireTime = GetCurrentTime() + m_timeout;
+
+	std::unique_lock<std::mutex> sessionsLock(m_sessionsMutex);
+	if (m_sessions.find(id) != m_sessions.end())
+	{
+		throw Decent::RuntimeException("The ID given to RaSpSessionPool::Start is in use.");
+	}
+	if (m_sessions.size() >= m_maxSessions)
+	{
+		return false;
+	}
+
+	m_sessions.insert(std::make_pair(id, Item{ std::move(handshake), expireTime }));
+	return true;
+}
+
+std::unique_ptr<RaSession> RaSpSessionPool::OnMessage(uint64_t id, const std::vector<uint8_t>& inMsg,
+	std::vector<RaSpHandshake::OutMsg>& outMsgs, size_t & expectedSize)
+{
+	const time_t now = GetCurrentTime();
+
+	std::unique_ptr<RaSpHandshake> handshake;
+	{
+		std::unique_lock<std::mutex> sessionsLock(m_sessionsMutex);
+		auto it = m_sessions.find(id);
+		if (it == m_sessions.end() || !it->second.m_handshake)
+		{
+			throw Exception("RaSpSessionPool received a message for a session that doesn't exist, or is busy.");
+		}
+		if (it->second.m_expireTime <= now)
+		{
+			m_sessions.erase(it);
+			throw Exception("RaSpSessionPool received a message for a session timed out.");
+		}
+
+		//Take the handshake out, so the lock is not held while processing it.
+		handshake = std::move(it->second.m_handshake);
+	}
+
+	try
+	{
+		handshake->Process(inMsg, outMsgs);
+	}
+	catch (const std::exception&)
+	{
+		std::unique_lock<std::mutex> sessionsLock(m_sessionsMutex);
+		m_sessions.erase(id);
+		throw;
+	}
+
+	expectedSize = handshake->GetExpectedSize();
+
+	if (handshake->IsDone())
+	{
+		{
+			std::unique_lock<std::mutex> sessionsLock(m_sessionsMutex);
+			m_sessions.erase(id);
+		}
+		return handshake->ReleaseSession();
+	}
+
+	const time_t expireTime = GetCurrentTime() + m_timeout;
+	std::unique_lock<std::mutex> sessionsLock(m_sessionsMutex);
+	auto it = m_sessions.find(id);
+	if (it != m_sessions.end())
+	{
+		it->second.m_handshake = std::move(handshake);
+		it->second.m_expireTime = expireTime;
+	}
+	return nullptr;
+}
+
+bool RaSpSessionPool::Cancel(uint64_t id)
+{
+	std::unique_lock<std::mutex> sessionsLock(m_sessionsMutex);
+	auto it = m_sessions.find(id);
+	if (it == m_sessions.end() || !it->second.m_handshake)
+	{
+		return false;
+	}
+
+	m_sessions.erase(it);
+	return true;
+}
+
+size_t RaSpSessionPool::DropExpired()
+{
+	const time_t now = GetCurrentTime();
+	size_t res = 0;
+
+	std::unique_lock<std::mutex> sessionsLock(m_sessionsMutex);
+	for (auto it = m_sessions.begin(); it != m_sessions.end(); )
+	{
+		if (it->second.m_handshake && it->second.m_expireTime <= now)
+		{
+			it = m_sessions.erase(it);
+			++res;
+		}
+		else
+		{
+			++it;
+		}
+	}
+	return res;
+}
+
+size_t RaSpSessionPool::GetSessionCount() const
+{
+	std::unique_lock<std::mutex> sessionsLock(m_sessionsMutex);
+	return m_sessions.size();
+}
+
+time_t RaSpSessionPool::GetCurrentTime() const
+{
+	time_t res;
+	Tools::GetSystemTime(res);
+	return res;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <vector>
+
+#include "RaSpHandshake.h"
+
+namespace Decent
+{
+	namespace Sgx
+	{
+		/**
+		 * \brief	A pool of the SP side RA handshakes in progress, which are parked between the rounds,
+		 * 			so that a server attesting many clients at once doesn't need a thread per client for
+		 * 			the whole exchange. Each message arrived is given to OnMessage, by any thread, with the
+		 * 			ID of its session (e.g. the ID of the connection). The number of sessions is capped,
+		 * 			and a session is dropped if the client doesn't send the next message in time. Note that
+		 * 			processing RA MSG 1 and 3 still blocks on IAS. This class is thread-safe; different
+		 * 			sessions are processed concurrently.
+		 *
+		 * 			Note: by default, the time is read from Decent::Tools::GetSystemTime, which is an
+		 * 			untrusted source inside an enclave. A host lying about the time could only keep or drop
+		 * 			the pending handshakes, which it could do anyway by holding or closing the connections.
+		 */
+		class RaSpSessionPool
+		{
+		public:
+			RaSpSessionPool() = delete;
+
+			/**
+			 * \brief	Constructor
+			 *
+			 * \param	maxSessions	The maximum number of sessions in progress.
+			 * \param	timeout	   	The time allowed for the client to send each message, in seconds.
+			 */
+			RaSpSessionPool(size_t maxSessions, time_t timeout);
+
+			RaSpSessionPool(const RaSpSessionPool&) = delete;
+
+			RaSpSessionPool(RaSpSessionPool&&) = delete;
+
+			virtual ~RaSpSessionPool();
+
+			/**
+			 * \brief	Starts a session.
+			 *
+			 * \exception	Decent::RuntimeException	Thrown when the handshake is null, or the ID is in use.
+			 *
+			 * \param	id		 	The ID of the session.
+			 * \param	handshake	The handshake.
+			 *
+			 * \return	True if it's started, false if the pool is full (i.e. the client should retry later).
+			 */
+			virtual bool Start(uint64_t id, std::unique_ptr<RaSpHandshake> handshake);
+
+			/**
+			 * \brief	Process a message arrived for a session. The session is removed once the handshake is
+			 * 			done or failed.
+			 *
+			 * \exception	Decent::Net::Exception	Thrown when the session doesn't exist (e.g. timed out), is
+			 * 										processing another message, or the handshake fails.
+			 *
+			 * \param 		  	id				The ID of the session.
+			 * \param 		  	inMsg			The message arrived.
+			 * \param [in,out]	outMsgs			The messages to be sent to the client, in order, which are
+			 * 									appended to the vector.
+			 * \param [out]	  	expectedSize	The size of the message expected next (see
+			 * 									RaSpHandshake::GetExpectedSize).
+			 *
+			 * \return	The session established if the handshake is done, otherwise, null.
+			 */
+			virtual std::unique_ptr<RaSession> OnMessage(uint64_t id, const std::vector<uint8_t>& inMsg,
+				std::vector<RaSpHandshake::OutMsg>& outMsgs, size_t& expectedSize);
+
+			/**
+			 * \brief	Cancels a session, e.g. when the connection is closed.
+			 *
+			 * \param	id	The ID of the session.
+			 *
+			 * \return	True if it's cancelled, false if it doesn't exist, or it's processing a message.
+			 */
+			virtual bool Cancel(uint64_t id);
+
+			/**
+			 * \brief	Drops the sessions timed out. Sessions processing a message are not dropped. This
+			 * 			should be called periodically.
+			 *
+			 * \return	The number of sessions dropped.
+			 */
+			virtual size_t DropExpired();
+
+			/**
+			 * \brief	Gets the number of sessions in progress, including the ones processing a message.
+			 *
+			 * \return	The number of sessions.
+			 */
+			size_t GetSessionCount() const;
+
+		protected:
+			struct Item
+			{
+				std::unique_ptr<RaSpHandshake> m_handshake; //Null while it's processing a message.
+				time_t m_expireTime;
+			};
+
+			virtual time_t GetCurrentTime() const;
+
+		private:
+			const size_t m_maxSessions;
+			const time_t m_timeout;
+
+			mutable std::mutex m_sessionsMutex;
+			std::map<uint64_t, Item> m_sessions;
+		};
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Decent
+{
+	namespace Sgx
+	{
+		/**
+		 * \brief	Groups of hot OCALLs that have a switchless variant. The variants are named with the
+		 * 			suffix "_swl", and declared at the end of the untrusted section in decent_tools.edl
+		 * 			and decent_net.edl (and their "_swl.edl" copies). Whether the switchless variant is
+		 * 			used is decided at runtime for each group, based on the call rate observed by the
+		 * 			untrusted side.
+		 */
+		enum class SwitchlessOcall : uint8_t
+		{
+			NetSend = 0,
+			NetRecv = 1,
+			Time    = 2,
+			Print   = 3,
+		};
+
+		constexpr size_t gsk_switchlessOcallCount = 4;
+	}
+}
@@ -161,6 +161,21 @@ namespace Decent
 			 */
 			uint64_t GetCurrentCachedCount() const noexcept { return m_itemCount; }
 
+			/**
+			 * \brief	Gets number of items cached under the given key
+			 *
+			 * \param	key	The key.
+			 *
+			 * \return	The number of items cached under the given key.
+			 */
+			size_t GetCachedCount(const KeyType& key)
+			{
+				std::unique_lock<std::mutex> queueLock(m_queueMutex);
+
+				auto idxIt = m_index.find(key);
+				return idxIt == m_index.end() ? 0 : idxIt->second.size();
+			}
+
 		protected:
 			virtual void PutNew(const KeyType& key, std::unique_ptr<ItemType>&& item)
 			{
@@ -0,0 +1,84 @@
+#include "CompactCoding.h"
+
+#include "../RuntimeException.h"
+
+using namespace Decent::Tools;
+
+#define THROW_MALFORMED_EXCEPTION throw Decent::RuntimeException("Failed to decode compact binary data: the data is malformed.")
+
+CompactWriter::CompactWriter(uint8_t version) :
+	m_buffer(1, static_cast<char>(version))
+{
+}
+
+CompactWriter::~CompactWriter()
+{
+}
+
+void CompactWriter::PutUInt(uint64_t val)
+{
+	do
+	{
+		uint8_t byte = static_cast<uint8_t>(val & 0x7F);
+		val >>= 7;
+		if (val != 0)
+		{
+			byte |= 0x80;
+		}
+		m_buffer.push_back(static_cast<char>(byte));
+	} while (val != 0);
+}
+
+void CompactWriter::PutBytes(const void * ptr, size_t size)
+{
+	PutUInt(size);
+	m_buffer.append(static_cast<const char*>(ptr), size);
+}
+
+CompactReader::CompactReader(const StrView & data, uint8_t version) :
+	m_data(data),
+	m_pos(1)
+{
+	if (m_data.size() < 1 || static_cast<uint8_t>(m_data.data()[0]) != version)
+	{
+		throw Decent::RuntimeException("Failed to decode compact binary data: unsupported version.");
+	}
+}
+
+CompactReader::~CompactReader()
+{
+}
+
+uint64_t CompactReader::GetUInt()
+{
+	uint64_t res = 0;
+	for (unsigned int shift = 0; shift < 64; shift += 7)
+	{
+		if (m_pos >= m_data.size())
+		{
+			THROW_MALFORMED_EXCEPTION;
+		}
+
+		const uint8_t byte = static_cast<uint8_t>(m_data.data()[m_pos++]);
+		res |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return res;
+		}
+	}
+
+	THROW_MALFORMED_EXCEPTION;
+}
+
+StrView CompactReader::GetBytes()
+{
+	const uint64_t size = GetUInt();
+	if (size > m_data.size() - m_pos)
+	{
+		THROW_MALFORMED_EXCEPTION;
+	}
+
+	StrView res(m_data.data() + m_pos, static_cast<size_t>(size));
+	m_pos += static_cast<size_t>(size);
+	return res;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <utility>
+
+#include "StrView.h"
+
+namespace Decent
+{
+	namespace Tools
+	{
+		/**
+		 * \brief	Writer of the compact binary encoding: a version byte, followed by fields. Integers
+		 * 			are unsigned LEB128 encoded, and byte strings are prefixed with their lengths.
+		 */
+		class CompactWriter
+		{
+		public:
+			CompactWriter() = delete;
+
+			/**
+			 * \brief	Constructor
+			 *
+			 * \param	version	The version of the encoding, which is written as the first byte.
+			 */
+			CompactWriter(uint8_t version);
+
+			virtual ~CompactWriter();
+
+			/**
+			 * \brief	Writes an unsigned integer.
+			 *
+			 * \param	val	The value.
+			 */
+			void PutUInt(uint64_t val);
+
+			/**
+			 * \brief	Writes a length-prefixed byte string.
+			 *
+			 * \param	ptr 	The pointer to the bytes.
+			 * \param	size	The number of bytes.
+			 */
+			void PutBytes(const void* ptr, size_t size);
+
+			void PutBytes(const StrView& data)
+			{
+				PutBytes(data.data(), data.size());
+			}
+
+			/**
+			 * \brief	Gets the encoded data.
+			 *
+			 * \return	The encoded data.
+			 */
+			const std::string& Get() const noexcept { return m_buffer; }
+
+			/**
+			 * \brief	Moves the encoded data out of this writer.
+			 *
+			 * \return	The encoded data.
+			 */
+			std::string Release() { return std::move(m_buffer); }
+
+		private:
+			std::string m_buffer;
+		};
+
+		/**
+		 * \brief	Reader of the compact binary encoding written by CompactWriter. Byte strings are
+		 * 			returned as views into the given data, without copying.
+		 */
+		class CompactReader
+		{
+		public:
+			CompactReader() = delete;
+
+			/**
+			 * \brief	Constructor
+			 *
+			 * \exception	Decent::RuntimeException	Thrown when the version doesn't match.
+			 *
+			 * \param	data   	The encoded data. It must outlive this reader and the views it returns.
+			 * \param	version	The expected version of the encoding.
+			 */
+			CompactReader(const StrView& data, uint8_t version);
+
+			virtual ~CompactReader();
+
+			/**
+			 * \brief	Reads an unsigned integer.
+			 *
+			 * \exception	Decent::RuntimeException	Thrown when the data is truncated or malformed.
+			 *
+			 * \return	The value.
+			 */
+			uint64_t GetUInt();
+
+			/**
+			 * \brief	Reads a length-prefixed byte string.
+			 *
+			 * \exception	Decent::RuntimeException	Thrown when the data is truncated or malformed.
+			 *
+			 * \return	A view of the bytes.
+			 */
+			StrView GetBytes();
+
+			/**
+			 * \brief	Query if all data has been read.
+			 *
+			 * \return	True if it's the end of the data, false if not.
+			 */
+			bool IsEnd() const noexcept { return m_pos == m_data.size(); }
+
+		private:
+			StrView m_data;
+			size_t m_pos;
+		};
+	}
+}
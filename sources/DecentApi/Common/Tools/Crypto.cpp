@@ -1,12 +1,15 @@
 #include "Crypto.h"
 
 #include <cmath>
+#include <cstring>
 
 #include "../Common.h"
+#include "../make_unique.h"
 #include "../RuntimeException.h"
 #include "../consttime_memequal.h"
 #include "../GeneralKeyTypes.h"
 
+#include "../MbedTls/Gcm.h"
 #include "../MbedTls/Drbg.h"
 #include "../MbedTls/SafeWrappers.h"
 
@@ -44,6 +47,8 @@ namespace
 
 	constexpr size_t gsk_sealPkgAllKnownSize = gsk_sealMetaSize + sizeof(uint64_t) + sizeof(uint64_t);
 
+	constexpr uint8_t gsk_zeroPadding[256] = { 0 };
+
 	size_t GetTotalSealedBlockSize(const size_t inSealedBlockSize, const size_t inKeyMetaSize, const size_t inMetaSize, const size_t inDataSize, size_t& addSize, size_t& sealedSize)
 	{
 		const size_t totalDataSize = gsk_sealPkgAllKnownSize + inKeyMetaSize + inMetaSize + inDataSize;
@@ -74,21 +79,46 @@ namespace
 	}
 }
 
-std::vector<uint8_t> detail::QuickAesGcmPack(const void * keyPtr, const size_t keySize,
-	const void * inKeyMeta, const size_t inKeyMetaSize,
+GcmPacker::GcmPacker(const void * keyPtr, const size_t keySize) :
+	m_gcm()
+{
+	if (!keyPtr)
+	{
+		throw RuntimeException("Invalid argument(s) is given to function GcmPacker::GcmPacker");
+	}
+	m_gcm = Tools::make_unique<MbedTlsObj::GcmBase>(keyPtr, keySize, MbedTlsObj::GcmBase::Cipher::AES);
+}
+
+GcmPacker::GcmPacker(GcmPacker && rhs) :
+	m_gcm(std::move(rhs.m_gcm))
+{}
+
+GcmPacker::~GcmPacker()
+{}
+
+GcmPacker & GcmPacker::operator=(GcmPacker && rhs)
+{
+	if (this != &rhs)
+	{
+		m_gcm = std::move(rhs.m_gcm);
+	}
+	return *this;
+}
+
+std::vector<uint8_t> GcmPacker::Pack(const void * inKeyMeta, const size_t inKeyMetaSize,
 	const void * inMeta,    const size_t inMetaSize,
 	const void * inData,    const size_t inDataSize,
 	const void * addData,   const size_t addDataSize,
 	Decent::General128Tag* outTag,
 	const size_t sealedBlockSize)
 {
-	if (!keyPtr ||
+	if (!m_gcm ||
 		!inData ||
 		(inKeyMetaSize > 0 && !inKeyMeta) ||
 		(inMetaSize > 0 && !inMeta) ||
 		(addDataSize > 0 && !addData))
 	{
-		throw RuntimeException("Invalid argument(s) is given to function detail::QuickAesGcmPack");
+		throw RuntimeException("Invalid argument(s) is given to function GcmPacker::Pack");
 	}
 
 	size_t defAddSize = 0;
@@ -98,20 +128,6 @@ std::vector<uint8_t> detail::QuickAesGcmPack(const void * keyPtr, const size_t k
 
 	uint8_t* sealedResPtr = sealedRes.data();
 
-	//Construct plain text input package:
-	std::vector<uint8_t> inputPkg(sealedSize, 0);
-
-	uint8_t* inputPkgPtr = inputPkg.data();
-	uint64_t& inputPkgMetaSize = *reinterpret_cast<uint64_t*>(inputPkgPtr);
-	uint64_t& inputPkgDataSize = *reinterpret_cast<uint64_t*>(inputPkgPtr += sizeof(uint64_t));
-	uint8_t* inputPkgMeta = (inputPkgPtr += sizeof(uint64_t));
-	uint8_t* inputPkgData = (inputPkgPtr += inMetaSize);
-
-	inputPkgMetaSize = inMetaSize;
-	inputPkgDataSize = inDataSize;
-	std::memcpy(inputPkgMeta, inMeta, inMetaSize);
-	std::memcpy(inputPkgData, inData, inDataSize);
-
 	//Construct output package:
 	//    Metadata Label:
 	std::memcpy(&sealedRes[0], gsk_sealedDataLabel, sizeof(gsk_sealedDataLabel));
@@ -127,25 +143,43 @@ std::vector<uint8_t> detail::QuickAesGcmPack(const void * keyPtr, const size_t k
 	//    Sealed Part:
 	uint8_t* sealedResOutputPtr = (sealedResPtr += inKeyMetaSize);
 
-	EXCEPTION_ASSERT((&sealedRes[sealedRes.size() - 1] - sealedResOutputPtr + 1) == inputPkg.size(),
-		"In function DataSealer::detail::QuickAesGcmPack, the free space in the sealed result does not match the size of input package.");
+	if (static_cast<size_t>(&sealedRes[sealedRes.size() - 1] - sealedResOutputPtr + 1) != sealedSize)
+	{
+		throw RuntimeException("In function GcmPacker::Pack, the free space in the sealed result does not match the size of input package.");
+	}
 
 	MbedTlsObj::Drbg().Rand(sealedResIvPtr, sizeof(IVType));
 	sealedResPayloadSize = sealedSize;
 	sealedResKeyMetaSize = inKeyMetaSize;
 	std::copy(static_cast<const uint8_t*>(inKeyMeta), static_cast<const uint8_t*>(inKeyMeta) + inKeyMetaSize, sealedResKeyMetaPtr);
 
-	//Build Full Add Data:
-	std::vector<uint8_t> fullAddData(defAddSize + addDataSize);
-	std::memcpy(fullAddData.data(), sealedResIvPtr, defAddSize);
-	std::memcpy(fullAddData.data() + defAddSize, addData, addDataSize);
-
 	//Encrypt!!:
-	PlatformAesGcmEncrypt(keyPtr, keySize,
-		inputPkg.data(), inputPkg.size(), sealedResOutputPtr,
-		sealedResIvPtr, sizeof(IVType),
-		fullAddData.data(), fullAddData.size(),
-		sealedResMacPtr, sizeof(general_128bit_tag));
+	//    Each part of the plain text package is encrypted directly from the caller's buffer into the
+	//    result, thus, there is no temporary copy of the secret.
+	const uint64_t inputPkgSizes[2] = { inMetaSize, inDataSize };
+	const size_t padSize = sealedSize - sizeof(inputPkgSizes) - inMetaSize - inDataSize;
+
+	MbedTlsObj::GcmBase& gcm = *m_gcm;
+	gcm.BeginEncrypt(sealedResIvPtr, sizeof(IVType));
+	gcm.UpdateAad(sealedResIvPtr, defAddSize);
+	gcm.UpdateAad(addData, addDataSize);
+
+	size_t written = 0;
+	written += gcm.Update(inputPkgSizes, sizeof(inputPkgSizes), sealedResOutputPtr + written, sealedSize - written);
+	written += gcm.Update(inMeta, inMetaSize, sealedResOutputPtr + written, sealedSize - written);
+	written += gcm.Update(inData, inDataSize, sealedResOutputPtr + written, sealedSize - written);
+	for (size_t padLeft = padSize; padLeft > 0; )
+	{
+		const size_t padStep = padLeft < sizeof(gsk_zeroPadding) ? padLeft : sizeof(gsk_zeroPadding);
+		written += gcm.Update(gsk_zeroPadding, padStep, sealedResOutputPtr + written, sealedSize - written);
+		padLeft -= padStep;
+	}
+	written += gcm.FinishEncrypt(sealedResOutputPtr + written, sealedSize - written, sealedResMacPtr, sizeof(general_128bit_tag));
+
+	if (written != sealedSize)
+	{
+		throw RuntimeException("In function GcmPacker::Pack, the size of the encrypted data is wrong.");
+	}
 
 	if (outTag)
 	{
@@ -154,13 +188,21 @@ std::vector<uint8_t> detail::QuickAesGcmPack(const void * keyPtr, const size_t k
 		std::copy(sealedResMacPtr, sealedResMacPtr + sizeof(general_128bit_tag), outTag->begin());
 	}
 
-	//Clear the temp memory used to hold sensitive data:
-	MbedTlsObj::ZeroizeContainer(fullAddData);
-	MbedTlsObj::ZeroizeContainer(inputPkg);
-
 	return sealedRes;
 }
 
+std::vector<uint8_t> detail::QuickAesGcmPack(const void * keyPtr, const size_t keySize,
+	const void * inKeyMeta, const size_t inKeyMetaSize,
+	const void * inMeta,    const size_t inMetaSize,
+	const void * inData,    const size_t inDataSize,
+	const void * addData,   const size_t addDataSize,
+	Decent::General128Tag* outTag,
+	const size_t sealedBlockSize)
+{
+	return GcmPacker(keyPtr, keySize).Pack(inKeyMeta, inKeyMetaSize, inMeta, inMetaSize, inData, inDataSize,
+		addData, addDataSize, outTag, sealedBlockSize);
+}
+
 std::vector<uint8_t> detail::GetKeyMetaFromPack(const void * inEncData, const size_t inEncDataSize)
 {
 	if (!inEncData)
@@ -189,21 +231,20 @@ std::vector<uint8_t> detail::GetKeyMetaFromPack(const void * inEncData, const si
 	return std::vector<uint8_t>(sealedKeyMetaPtr, sealedKeyMetaPtr + sealedKeyMetaSize);
 }
 
-void detail::QuickAesGcmUnpack(const void * keyPtr, const size_t keySize,
-	const void * inEncData, const size_t inEncDataSize,
+void GcmPacker::Unpack(const void * inEncData, const size_t inEncDataSize,
 	const void * addData,   const size_t addDataSize,
 	std::vector<uint8_t>& outMeta, std::vector<uint8_t>& outData,
 	const Decent::General128Tag* inTag,
 	const size_t sealedBlockSize)
 {
-	if (!keyPtr ||
+	if (!m_gcm ||
 		!inEncData)
 	{
-		throw RuntimeException("Invalid argument(s) is given to detail::QuickAesGcmUnpack");
+		throw RuntimeException("Invalid argument(s) is given to GcmPacker::Unpack");
 	}
 	if (!consttime_memequal(inEncData, gsk_sealedDataLabel, sizeof(gsk_sealedDataLabel)))
 	{
-		throw RuntimeException("The data given to detail::QuickAesGcmUnpack doesn't match the pre-defined format.");
+		throw RuntimeException("The data given to GcmPacker::Unpack doesn't match the pre-defined format.");
 	}
 
 	//Sealed package:
@@ -225,7 +266,7 @@ void detail::QuickAesGcmUnpack(const void * keyPtr, const size_t keySize,
 	if (sealedPayloadSize < (sizeof(uint64_t) + sizeof(uint64_t)) ||
 		(inEncDataSize - allMetaSize) != sealedPayloadSize)
 	{
-		throw RuntimeException("Sealed data with invalid size is given to function detail::QuickAesGcmUnpack.");
+		throw RuntimeException("Sealed data with invalid size is given to function GcmPacker::Unpack.");
 	}
 
 	if (inTag)
@@ -234,24 +275,36 @@ void detail::QuickAesGcmUnpack(const void * keyPtr, const size_t keySize,
 		if (inTag->size() != sizeof(general_128bit_tag) ||
 			!consttime_memequal(inTag->data(), sealedMacPtr, inTag->size()))
 		{
-			throw RuntimeException("Invalid sealed data is given to function detail::QuickAesGcmUnpack.");
+			throw RuntimeException("Invalid sealed data is given to function GcmPacker::Unpack.");
 		}
 	}
 
-	//Build Full Add Data:
 	const size_t defAddSize = gsk_knownAddSize + sealedKeyMetaSize;
-	std::vector<uint8_t> fullAddData(defAddSize + addDataSize);
-	std::memcpy(fullAddData.data(), sealedIvPtr, defAddSize);
-	std::memcpy(fullAddData.data() + defAddSize, addData, addDataSize);
 
 	std::vector<uint8_t> unsealedPkg(sealedPayloadSize);
 
 	//Decrypt!!:
-	PlatformAesGcmDecrypt(keyPtr, keySize,
-		sealedOutputPtr, sealedPayloadSize, unsealedPkg.data(),
-		sealedIvPtr, sizeof(IVType),
-		fullAddData.data(), fullAddData.size(),
-		sealedMacPtr, sizeof(general_128bit_tag));
+	//    The plain text is only used after the tag is verified by FinishDecrypt.
+	MbedTlsObj::GcmBase& gcm = *m_gcm;
+	gcm.BeginDecrypt(sealedIvPtr, sizeof(IVType));
+	gcm.UpdateAad(sealedIvPtr, defAddSize);
+	gcm.UpdateAad(addData, addDataSize);
+
+	size_t written = gcm.Update(sealedOutputPtr, sealedPayloadSize, unsealedPkg.data(), unsealedPkg.size());
+	try
+	{
+		written += gcm.FinishDecrypt(unsealedPkg.data() + written, unsealedPkg.size() - written, sealedMacPtr, sizeof(general_128bit_tag));
+	}
+	catch (const std::exception&)
+	{
+		MbedTlsObj::ZeroizeContainer(unsealedPkg);
+		throw;
+	}
+	if (written != unsealedPkg.size())
+	{
+		MbedTlsObj::ZeroizeContainer(unsealedPkg);
+		throw RuntimeException("In function GcmPacker::Unpack, the size of the decrypted data is wrong.");
+	}
 
 	//Parse unsealed package:
 	std::vector<uint8_t>::iterator pkgIt = unsealedPkg.begin();
@@ -259,7 +312,7 @@ void detail::QuickAesGcmUnpack(const void * keyPtr, const size_t keySize,
 	uint64_t& pkgDataSize = reinterpret_cast<uint64_t&>(*(pkgIt += sizeof(uint64_t)));
 	if (sizeof(uint64_t) + sizeof(uint64_t) + pkgMetaSize + pkgDataSize > unsealedPkg.size())
 	{
-		throw RuntimeException("Invalid sealed data is given to function detail::QuickAesGcmUnpack.");
+		throw RuntimeException("Invalid sealed data is given to function GcmPacker::Unpack.");
 	}
 	std::vector<uint8_t>::iterator pkgMetaIt = (pkgIt += sizeof(uint64_t));
 	std::vector<uint8_t>::iterator pkgDataIt = (pkgIt += pkgMetaSize);
@@ -301,10 +354,23 @@ void detail::QuickAesGcmUnpack(const void * keyPtr, const size_t keySize,
 
 	outData.insert(pos, pkgDataIt, pkgDataEndIt);
 
-	EXCEPTION_ASSERT(outMeta.size() == pkgMetaSize, "In function detail::QuickAesGcmUnpack, the final metadata size is different from the sealed value.");
-	EXCEPTION_ASSERT(outData.size() == pkgDataSize, "In function detail::QuickAesGcmUnpack, the final data size is different from the sealed value.");
+	if (outMeta.size() != pkgMetaSize || outData.size() != pkgDataSize)
+	{
+		MbedTlsObj::ZeroizeContainer(unsealedPkg);
+		throw RuntimeException("In function GcmPacker::Unpack, the final metadata or data size is different from the sealed value.");
+	}
 
 	//Clear the temp memory used to hold sensitive data:
-	MbedTlsObj::ZeroizeContainer(fullAddData);
 	MbedTlsObj::ZeroizeContainer(unsealedPkg);
 }
+
+void detail::QuickAesGcmUnpack(const void * keyPtr, const size_t keySize,
+	const void * inEncData, const size_t inEncDataSize,
+	const void * addData,   const size_t addDataSize,
+	std::vector<uint8_t>& outMeta, std::vector<uint8_t>& outData,
+	const Decent::General128Tag* inTag,
+	const size_t sealedBlockSize)
+{
+	GcmPacker(keyPtr, keySize).Unpack(inEncData, inEncDataSize, addData, addDataSize,
+		outMeta, outData, inTag, sealedBlockSize);
+}
@@ -3,12 +3,18 @@
 #include <cstdint>
 
 #include <vector>
+#include <memory>
 
 #include "../GeneralKeyTypes.h"
 #include "../ArrayPtrAndSize.h"
 
 namespace Decent
 {
+	namespace MbedTlsObj
+	{
+		class GcmBase;
+	}
+
 	namespace Tools
 	{
 		namespace detail
@@ -43,6 +49,102 @@ namespace Decent
 				const size_t sealedBlockSize);
 		}
 
+		/**
+		 * \brief	An AES-GCM packer bound to a single key. The AES key schedule is expanded once at
+		 * 			construction, and then reused by every Pack and Unpack call, thus, it should be
+		 * 			used instead of QuickAesGcmPack and QuickAesGcmUnpack when many packages are
+		 * 			processed with the same key. The package format is the same as QuickAesGcmPack.
+		 * 			This class is not thread-safe.
+		 */
+		class GcmPacker
+		{
+		public:
+			GcmPacker() = delete;
+
+			/**
+			 * \brief	Constructor
+			 *
+			 * \exception	Decent::RuntimeException	Thrown when the key is invalid.
+			 *
+			 * \param	keyPtr 	The pointer to the key.
+			 * \param	keySize	Size of the key.
+			 */
+			GcmPacker(const void* keyPtr, const size_t keySize);
+
+			/**
+			 * \brief	Constructor
+			 *
+			 * \tparam	KeyType	Type of the key.
+			 * \param	key	The key.
+			 */
+			template<typename KeyType>
+			explicit GcmPacker(const KeyType& key) :
+				GcmPacker(ArrayPtrAndSize::GetPtr(key), ArrayPtrAndSize::GetSize(key))
+			{}
+
+			GcmPacker(const GcmPacker& rhs) = delete;
+
+			GcmPacker(GcmPacker&& rhs);
+
+			/** \brief	Destructor. The expanded key is zeroized. */
+			virtual ~GcmPacker();
+
+			GcmPacker& operator=(const GcmPacker& rhs) = delete;
+
+			GcmPacker& operator=(GcmPacker&& rhs);
+
+			/**
+			 * \brief	Encrypt secret and pack all necessary data together. See QuickAesGcmPack for
+			 * 			details.
+			 *
+			 * \exception	Decent::RuntimeException
+			 */
+			virtual std::vector<uint8_t> Pack(const void* inKeyMeta, const size_t inKeyMetaSize,
+				const void* inMeta,    const size_t inMetaSize,
+				const void* inData,    const size_t inDataSize,
+				const void* addData,   const size_t addDataSize,
+				General128Tag* outTag,
+				const size_t sealedBlockSize);
+
+			/**
+			 * \brief	Unpack and decrypt the package. See QuickAesGcmUnpack for details.
+			 *
+			 * \exception	Decent::RuntimeException
+			 */
+			virtual void Unpack(const void* inEncData, const size_t inEncDataSize,
+				const void* addData,   const size_t addDataSize,
+				std::vector<uint8_t>& outMeta, std::vector<uint8_t>& outData,
+				const General128Tag* inTag,
+				const size_t sealedBlockSize);
+
+			template<typename KeyMetaType, typename MetaType, typename DataType, typename AddDataType>
+			std::vector<uint8_t> Pack(const KeyMetaType& keyMeta, const MetaType& meta, const DataType& data, const AddDataType& addData,
+				General128Tag* outTag, const size_t sealedBlockSize)
+			{
+				using namespace ArrayPtrAndSize;
+				return Pack(GetPtr(keyMeta), GetSize(keyMeta),
+					GetPtr(meta),    GetSize(meta),
+					GetPtr(data),    GetSize(data),
+					GetPtr(addData), GetSize(addData),
+					outTag,
+					sealedBlockSize);
+			}
+
+			template<typename DataType, typename AddDataType>
+			void Unpack(const DataType& encData, const AddDataType& addData,
+				std::vector<uint8_t>& outMeta, std::vector<uint8_t>& outData,
+				const General128Tag* inTag, const size_t sealedBlockSize)
+			{
+				using namespace ArrayPtrAndSize;
+				return Unpack(GetPtr(encData), GetSize(encData),
+					GetPtr(addData), GetSize(addData),
+					outMeta, outData, inTag, sealedBlockSize);
+			}
+
+		private:
+			std::unique_ptr<MbedTlsObj::GcmBase> m_gcm;
+		};
+
 		/**
 		 * \brief	Quickly encrypt secret with AES-GCM and pack all necessary data together
 		 *
@@ -18,9 +18,14 @@ std::string Tools::SerializeStruct(const void * ptr, size_t size)
 }
 
 void Tools::DeserializeStruct(void* bufferPtr, size_t bufferSize, const std::string& inStr)
+{
+	DeserializeStruct(bufferPtr, bufferSize, inStr.data(), inStr.size());
+}
+
+void Tools::DeserializeStruct(void* bufferPtr, size_t bufferSize, const char* inStr, size_t inSize)
 {
 	std::vector<uint8_t> buffer(bufferSize, 0);
-	cppcodec::base64_rfc4648::decode(buffer, inStr);
+	cppcodec::base64_rfc4648::decode(buffer, inStr, inSize);
 	
 	const size_t neededSize = bufferSize <= buffer.size() ? bufferSize : buffer.size();
 	memcpy(bufferPtr, buffer.data(), neededSize);
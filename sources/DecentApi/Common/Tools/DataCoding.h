@@ -19,11 +19,17 @@ namespace Decent
 		}
 
 		void DeserializeStruct(void* bufferPtr, size_t bufferSize, const std::string& inStr);
+		void DeserializeStruct(void* bufferPtr, size_t bufferSize, const char* inStr, size_t inSize);
 		void DeserializeStruct(std::vector<uint8_t>& outData, const std::string& inStr);
 		template<typename T>
 		inline void DeserializeStruct(T& outData, const std::string& inStr)
 		{
 			DeserializeStruct(static_cast<void*>(&outData), sizeof(T), inStr);
 		}
+		template<typename T>
+		inline void DeserializeStruct(T& outData, const char* inStr, size_t inSize)
+		{
+			DeserializeStruct(static_cast<void*>(&outData), sizeof(T), inStr, inSize);
+		}
 	}
 }
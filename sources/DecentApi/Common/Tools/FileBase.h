@@ -79,6 +79,40 @@ namespace Decent
 				return ReadBlockRaw(&buffer[0], buffer.size());
 			}
 
+			/**
+			 * \brief	Reads from the current position to the end of the file. The buffer will be resized to
+			 * 			the number of bytes actually read.
+			 *
+			 * \param [out]	buffer	The buffer.
+			 *
+			 * \return	The number of bytes read.
+			 */
+			virtual size_t ReadFileToEnd(std::vector<uint8_t>& buffer)
+			{
+				const size_t pos = FTell();
+				const size_t size = GetFileSize();
+				buffer.resize(size > pos ? size - pos : 0);
+				buffer.resize(ReadBlock(buffer));
+				return buffer.size();
+			}
+
+			/**
+			 * \brief	Reads from the current position to the end of the file. The buffer will be resized to
+			 * 			the number of bytes actually read.
+			 *
+			 * \param [out]	buffer	The buffer.
+			 *
+			 * \return	The number of bytes read.
+			 */
+			virtual size_t ReadFileToEnd(std::string& buffer)
+			{
+				const size_t pos = FTell();
+				const size_t size = GetFileSize();
+				buffer.resize(size > pos ? size - pos : 0);
+				buffer.resize(ReadBlock(buffer));
+				return buffer.size();
+			}
+
 		protected:
 			static const char* InterpretMode(const Mode mode);
 			static const wchar_t* InterpretModeW(const Mode mode);
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 
+#include "StrView.h"
 #include "JsonForwardDeclare.h"
 
 #ifdef ENCLAVE_ENVIRONMENT
@@ -82,6 +83,47 @@ namespace Decent
 		 */
 		void ParseStr2Json(JsonDoc& outDoc, const char* inStr);
 
+		/**
+		 * \brief	Parse string to JSON document
+		 *
+		 * \exception	Decent::RuntimeException	Failed to parse the string. There is some format
+		 * 											error.
+		 *
+		 * \param [in,out]	outDoc	The output JSON document.
+		 * \param 		  	inStr 	The input string, which doesn't need to be null-terminated.
+		 * \param 		  	size  	The size of the input string.
+		 */
+		void ParseStr2Json(JsonDoc& outDoc, const char* inStr, size_t size);
+
+		/**
+		 * \brief	Parse string to JSON document in-situ. In enclave build, the input buffer is
+		 * 			modified during parsing, and the strings in the output document point into it;
+		 * 			thus, the buffer must out-live the document, and must not be modified afterwards.
+		 * 			In app build, this is the same as ParseStr2Json.
+		 *
+		 * \exception	Decent::RuntimeException	Failed to parse the string. There is some format
+		 * 											error.
+		 *
+		 * \param [in,out]	outDoc	The output JSON document.
+		 * \param [in,out]	inStr 	The input string.
+		 */
+		void ParseStr2JsonInsitu(JsonDoc& outDoc, std::string& inStr);
+
+		/** \brief	A read-only view of a string held by a JSON document, without copying it. */
+		typedef StrView JsonStrView;
+
+		/**
+		 * \brief	Gets a view of the string held by a JSON value. The view is valid as long as the
+		 * 			value (and, for in-situ parsed documents, the source buffer) is not changed.
+		 *
+		 * \exception	Decent::RuntimeException	The value is not a string.
+		 *
+		 * \param	val	The JSON value.
+		 *
+		 * \return	The view of the string.
+		 */
+		JsonStrView JsonAsStrView(const JsonValue& val);
+
 		std::string Json2StyledString(const JsonValue& inJson);
 
 		std::string Json2String(const JsonValue& inJson);
@@ -43,6 +43,7 @@ namespace Decent
 
 				if (!duplicate)
 				{
+					std::unique_lock<std::mutex> queueLock(m_queueMutex);
 					auto idxIt = m_index.find(key);
 					if (idxIt != m_index.end() && idxIt->second.size() > 0)
 					{
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstring>
+
+#include <string>
+
+namespace Decent
+{
+	namespace Tools
+	{
+		/**
+		 * \brief	A read-only view of a string (or a binary blob) owned by someone else, without copying
+		 * 			it. The view is valid only as long as the owner keeps the data unchanged.
+		 */
+		class StrView
+		{
+		public:
+			StrView() noexcept :
+				m_ptr(""),
+				m_size(0)
+			{}
+
+			StrView(const char* ptr, size_t size) noexcept :
+				m_ptr(ptr),
+				m_size(size)
+			{}
+
+			StrView(const std::string& str) noexcept :
+				m_ptr(str.data()),
+				m_size(str.size())
+			{}
+
+			/**
+			 * \brief	Constructs a view of a string literal (or a constant C string array). The
+			 * 			terminating null character is excluded.
+			 *
+			 * \tparam	arrSize	Size of the array, including the terminating null character.
+			 * \param	str	The string literal.
+			 */
+			template<size_t arrSize>
+			StrView(const char(&str)[arrSize]) noexcept :
+				m_ptr(str),
+				m_size(arrSize - 1)
+			{}
+
+			const char* data() const noexcept { return m_ptr; }
+
+			size_t size() const noexcept { return m_size; }
+
+			bool empty() const noexcept { return m_size == 0; }
+
+			const char* begin() const noexcept { return m_ptr; }
+
+			const char* end() const noexcept { return m_ptr + m_size; }
+
+			std::string ToString() const { return std::string(m_ptr, m_size); }
+
+			bool operator==(const StrView& rhs) const noexcept
+			{
+				return m_size == rhs.m_size && (m_size == 0 || std::memcmp(m_ptr, rhs.m_ptr, m_size) == 0);
+			}
+
+			bool operator!=(const StrView& rhs) const noexcept { return !(*this == rhs); }
+
+		private:
+			const char* m_ptr;
+			size_t m_size;
+		};
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <atomic>
+
+namespace Decent
+{
+	namespace Tools
+	{
+		/**
+		 * \brief	The header in front of each slot of an untrusted arena. The arena lives in untrusted
+		 * 			memory, and it's shared by both sides; the untrusted side marks a slot as owned when
+		 * 			it hands the slot to the enclave, and the enclave marks it as free once the data
+		 * 			is read, so that no exit is needed to recycle the slot.
+		 */
+		struct UntrustedArenaSlotHeader
+		{
+			std::atomic<uint32_t> m_generation;
+			std::atomic<uint32_t> m_isOwned;
+		};
+
+		static_assert(sizeof(UntrustedArenaSlotHeader) == 8, "The layout of the arena slot header must be the same on both sides.");
+
+		/**
+		 * \brief	An ownership token of a slot in an untrusted arena. It's packed into an uint64_t, so
+		 * 			that it can be passed through the EDL as it is. A token of zero means the buffer is
+		 * 			not in an arena, but allocated by new[] in untrusted side.
+		 */
+		struct UntrustedArenaToken
+		{
+			static constexpr uint64_t sk_heapBuffer = 0;
+
+			uint16_t m_arenaId;
+			uint16_t m_slot;
+			uint32_t m_generation;
+
+			static UntrustedArenaToken Unpack(uint64_t token) noexcept
+			{
+				return UntrustedArenaToken{
+					static_cast<uint16_t>(token >> 48),
+					static_cast<uint16_t>(token >> 32),
+					static_cast<uint32_t>(token) };
+			}
+
+			uint64_t Pack() const noexcept
+			{
+				return (static_cast<uint64_t>(m_arenaId) << 48) | (static_cast<uint64_t>(m_slot) << 32) | m_generation;
+			}
+		};
+
+		/**
+		 * \brief	Gets the distance between two adjacent slots in an arena, i.e., the size of the
+		 * 			header plus the size of the slot, rounded up to the alignment of the header.
+		 *
+		 * \param	slotSize	Size of each slot.
+		 *
+		 * \return	The stride.
+		 */
+		inline constexpr size_t GetUntrustedArenaStride(size_t slotSize) noexcept
+		{
+			return sizeof(UntrustedArenaSlotHeader) +
+				((slotSize + alignof(UntrustedArenaSlotHeader) - 1) / alignof(UntrustedArenaSlotHeader)) * alignof(UntrustedArenaSlotHeader);
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#include "UtcTime.h"
+
+#include <cstdint>
+
+using namespace Decent::Tools;
+
+void Decent::Tools::EpochToUtcTime(const time_t & timer, tm & outTime)
+{
+	static constexpr int64_t sk_secPerDay = 86400;
+
+	//Days since 1970-01-01, and seconds into the day, both rounded toward negative infinity.
+	int64_t days = static_cast<int64_t>(timer) / sk_secPerDay;
+	int64_t secOfDay = static_cast<int64_t>(timer) % sk_secPerDay;
+	if (secOfDay < 0)
+	{
+		secOfDay += sk_secPerDay;
+		--days;
+	}
+
+	outTime.tm_hour = static_cast<int>(secOfDay / 3600);
+	outTime.tm_min = static_cast<int>((secOfDay % 3600) / 60);
+	outTime.tm_sec = static_cast<int>(secOfDay % 60);
+
+	//1970-01-01 is a Thursday.
+	outTime.tm_wday = static_cast<int>(((days % 7) + 11) % 7);
+
+	//Civil date from days; eras are 400-year cycles starting from 0000-03-01.
+	const int64_t z = days + 719468;
+	const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+	const int64_t doe = z - era * 146097;                                 // [0, 146096]
+	const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+	const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);           // [0, 365], from March 1st
+	const int64_t mp = (5 * doy + 2) / 153;                                // [0, 11], from March
+	const int64_t mday = doy - (153 * mp + 2) / 5 + 1;                     // [1, 31]
+	const int64_t mon = mp < 10 ? mp + 3 : mp - 9;                         // [1, 12]
+	const int64_t year = yoe + era * 400 + (mon <= 2 ? 1 : 0);
+
+	const bool isLeap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+	static constexpr int sk_daysBeforeMon[] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+
+	outTime.tm_year = static_cast<int>(year - 1900);
+	outTime.tm_mon = static_cast<int>(mon - 1);
+	outTime.tm_mday = static_cast<int>(mday);
+	outTime.tm_yday = sk_daysBeforeMon[mon - 1] + static_cast<int>(mday) - 1 + ((isLeap && mon > 2) ? 1 : 0);
+	outTime.tm_isdst = 0;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <ctime>
+
+namespace Decent
+{
+	namespace Tools
+	{
+		/**
+		 * \brief	Converts a POSIX time to a broken-down UTC time, in the same way as gmtime_r. It's
+		 * 			computed locally, so it doesn't need to leave the enclave.
+		 *
+		 * \param 	   	timer  	The time (seconds since 1970-01-01 00:00:00 UTC).
+		 * \param [out]	outTime	The broken-down UTC time.
+		 */
+		void EpochToUtcTime(const time_t& timer, struct tm& outTime);
+	}
+}
@@ -89,3 +89,17 @@ int MbedTls::mbedtls_mutex_unlock(mbedtls_threading_mutex_t *mutex)
 
 	return 0;
 }
+
+#ifdef MBEDTLS_PLATFORM_TIME_ALT
+mbedtls_time_t MbedTls::mbedtls_time_func(mbedtls_time_t *timer)
+{
+	time_t res;
+	Tools::GetSystemTime(res);
+
+	if (timer)
+	{
+		*timer = static_cast<mbedtls_time_t>(res);
+	}
+	return static_cast<mbedtls_time_t>(res);
+}
+#endif // MBEDTLS_PLATFORM_TIME_ALT
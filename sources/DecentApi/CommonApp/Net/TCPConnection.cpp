@@ -1,6 +1,20 @@
 #include "TCPConnection.h"
 
 #include <array>
+#include <chrono>
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#endif // _WIN32
+
+#include <boost/container/small_vector.hpp>
 
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/io_service.hpp>
@@ -12,6 +26,63 @@ using namespace Decent::Net;
 
 namespace
 {
+#ifdef _WIN32
+	typedef WSAPOLLFD PollFdType;
+	typedef int SockOptLenType;
+
+	int PollSockets(PollFdType* fds, size_t count, int timeout)
+	{
+		return WSAPoll(fds, static_cast<ULONG>(count), timeout);
+	}
+
+	int GetLastSocketError()
+	{
+		return WSAGetLastError();
+	}
+
+	bool IsConnectInProgress(int err)
+	{
+		return err == WSAEWOULDBLOCK || err == WSAEINPROGRESS;
+	}
+
+	bool IsInterrupted(int err)
+	{
+		return err == WSAEINTR;
+	}
+#else
+	typedef pollfd PollFdType;
+	typedef socklen_t SockOptLenType;
+
+	int PollSockets(PollFdType* fds, size_t count, int timeout)
+	{
+		return ::poll(fds, static_cast<nfds_t>(count), timeout);
+	}
+
+	int GetLastSocketError()
+	{
+		return errno;
+	}
+
+	bool IsConnectInProgress(int err)
+	{
+		return err == EINPROGRESS || err == EWOULDBLOCK || err == EAGAIN;
+	}
+
+	bool IsInterrupted(int err)
+	{
+		return err == EINTR;
+	}
+#endif // _WIN32
+
+	std::string GetSocketErrorMsg(int err)
+	{
+		return boost::system::error_code(err, boost::system::system_category()).message();
+	}
+
+	std::atomic<uint32_t> gs_defConnectTimeout(10000);
+	std::atomic<uint32_t> gs_defSendTimeout(0);
+	std::atomic<uint32_t> gs_defRecvTimeout(0);
+
 	static std::unique_ptr<ip::tcp::socket> AcceptConnection(TCPConnection::TcpAcceptorType & acceptor)
 	{
 		try
@@ -21,23 +92,257 @@ namespace
 		RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at TCP accept.")
 	}
 
-	static std::unique_ptr<io_service> ConstrIoContext()
+	/**
+	 * \brief	Starts a non-blocking connect to the given endpoint.
+	 *
+	 * \param 		  	ioCtx   	The i/o context.
+	 * \param 		  	endpoint	The endpoint.
+	 * \param [out]	isConnected	True if the connection is established immediately.
+	 * \param [out]	errMsg		The error message, if it's failed.
+	 *
+	 * \return	The socket if the connect is in progress or established, otherwise, nullptr.
+	 */
+	std::unique_ptr<ip::tcp::socket> StartConnect(io_service& ioCtx, const ip::tcp::endpoint& endpoint, bool& isConnected, std::string& errMsg)
+	{
+		isConnected = false;
+		boost::system::error_code ec;
+
+		std::unique_ptr<ip::tcp::socket> socket;
+		try
+		{
+			socket = std::make_unique<ip::tcp::socket>(ioCtx);
+		}
+		RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at tcp socket constrcution.")
+
+		socket->open(endpoint.protocol(), ec);
+		if (!ec)
+		{
+			socket->non_blocking(true, ec);
+		}
+		if (ec)
+		{
+			errMsg = ec.message();
+			return nullptr;
+		}
+
+		//Synchronous connect in boost::asio always blocks, regardless of the non-blocking mode, thus,
+		//connect is called on the native handle here.
+		if (::connect(socket->native_handle(), endpoint.data(), static_cast<int>(endpoint.size())) == 0)
+		{
+			isConnected = true;
+			return socket;
+		}
+
+		const int err = GetLastSocketError();
+		if (IsConnectInProgress(err))
+		{
+			return socket;
+		}
+
+		errMsg = GetSocketErrorMsg(err);
+		return nullptr;
+	}
+
+	/**
+	 * \brief	Order the endpoints by alternating address families, starting with the family of the first
+	 * 			endpoint (RFC 8305, section 4).
+	 */
+	std::vector<ip::tcp::endpoint> InterleaveEndpoints(const std::vector<ip::tcp::endpoint>& endpoints)
+	{
+		std::vector<ip::tcp::endpoint> first;
+		std::vector<ip::tcp::endpoint> second;
+		for (const ip::tcp::endpoint& endpoint : endpoints)
+		{
+			(endpoint.address().is_v6() == endpoints.front().address().is_v6() ? first : second).push_back(endpoint);
+		}
+
+		std::vector<ip::tcp::endpoint> res;
+		res.reserve(endpoints.size());
+		for (size_t i = 0; i < first.size() || i < second.size(); ++i)
+		{
+			if (i < first.size())
+			{
+				res.push_back(first[i]);
+			}
+			if (i < second.size())
+			{
+				res.push_back(second[i]);
+			}
+		}
+		return res;
+	}
+
+	std::unique_ptr<ip::tcp::socket> ConnectToEndpoints(io_service& ioCtx, const std::vector<ip::tcp::endpoint>& inEndpoints, uint32_t timeout)
+	{
+		using namespace std::chrono;
+
+		const std::vector<ip::tcp::endpoint> endpoints = InterleaveEndpoints(inEndpoints);
+
+		const steady_clock::time_point deadline = steady_clock::now() + milliseconds(timeout);
+		steady_clock::time_point nextAttemptTime = steady_clock::now();
+
+		std::vector<std::unique_ptr<ip::tcp::socket> > pending;
+		std::vector<PollFdType> pollFds;
+		std::string errMsg = "No address is available.";
+		size_t nextIdx = 0;
+
+		while (true)
+		{
+			steady_clock::time_point now = steady_clock::now();
+			if (timeout != 0 && now >= deadline)
+			{
+				throw TimeoutException("Timed out when connecting to the remote server.");
+			}
+
+			//Start a new attempt when nothing is pending, or when the previous one has taken too long.
+			if (nextIdx < endpoints.size() && (pending.size() == 0 || now >= nextAttemptTime))
+			{
+				bool isConnected = false;
+				std::unique_ptr<ip::tcp::socket> socket = StartConnect(ioCtx, endpoints[nextIdx++], isConnected, errMsg);
+				if (isConnected)
+				{
+					return socket;
+				}
+				if (socket)
+				{
+					PollFdType pollFd;
+					pollFd.fd = socket->native_handle();
+					pollFd.events = POLLOUT;
+					pollFd.revents = 0;
+
+					pollFds.push_back(pollFd);
+					pending.push_back(std::move(socket));
+					nextAttemptTime = now + milliseconds(TCPConnection::sk_connAttemptDelay);
+				}
+				continue;
+			}
+
+			if (pending.size() == 0)
+			{
+				throw Exception("Failed to connect to the remote server. Error: " + errMsg);
+			}
+
+			//Wait until any pending attempt finishes, next attempt is due, or deadline is reached.
+			int waitMs = -1;
+			if (nextIdx < endpoints.size())
+			{
+				waitMs = std::max(0, static_cast<int>(duration_cast<milliseconds>(nextAttemptTime - now).count()));
+			}
+			if (timeout != 0)
+			{
+				const int remainMs = std::max(0, static_cast<int>(duration_cast<milliseconds>(deadline - now).count()));
+				waitMs = waitMs < 0 ? remainMs : std::min(waitMs, remainMs);
+			}
+
+			if (PollSockets(pollFds.data(), pollFds.size(), waitMs) < 0)
+			{
+				const int err = GetLastSocketError();
+				if (!IsInterrupted(err))
+				{
+					throw Exception("Failed to poll sockets. Error: " + GetSocketErrorMsg(err));
+				}
+				continue;
+			}
+
+			for (size_t i = 0; i < pollFds.size(); )
+			{
+				if (pollFds[i].revents == 0)
+				{
+					++i;
+					continue;
+				}
+
+				int sockErr = 0;
+				SockOptLenType optLen = sizeof(sockErr);
+				if (::getsockopt(pollFds[i].fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&sockErr), &optLen) != 0)
+				{
+					sockErr = GetLastSocketError();
+				}
+
+				if (sockErr == 0)
+				{
+					//The rest of pending attempts will be closed on return.
+					return std::move(pending[i]);
+				}
+
+				errMsg = GetSocketErrorMsg(sockErr);
+				pending.erase(pending.begin() + i);
+				pollFds.erase(pollFds.begin() + i);
+			}
+		}
+	}
+
+	std::vector<ip::tcp::endpoint> ResolveHost(io_service& ioCtx, const std::string& host, uint16_t portNum)
+	{
+		boost::system::error_code ec;
+		const ip::address addr = ip::address::from_string(host, ec);
+		if (!ec)
+		{
+			return std::vector<ip::tcp::endpoint>{ ip::tcp::endpoint(addr, portNum) };
+		}
+
+		std::vector<ip::tcp::endpoint> res;
+		try
+		{
+			ip::tcp::resolver resolver(ioCtx);
+			for (const auto& entry : resolver.resolve(host, std::to_string(portNum), ip::resolver_base::numeric_service))
+			{
+				res.push_back(entry.endpoint());
+			}
+		}
+		RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at host name resolution.")
+
+		return res;
+	}
+
+	std::unique_ptr<ip::tcp::socket> ConnectToHost(io_service& ioCtx, const std::vector<ip::tcp::endpoint>& endpoints, uint32_t timeout)
 	{
+		std::unique_ptr<ip::tcp::socket> socket = ConnectToEndpoints(ioCtx, endpoints, timeout);
+
 		try
 		{
-			return std::make_unique<io_service>();
+			socket->set_option(ip::tcp::no_delay(true));
 		}
-		RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at io_service constrcution.")
+		RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at TCP connect.")
+
+		return socket;
 	}
 
-	static std::unique_ptr<ip::tcp::socket> ConstrSocket(io_service& ioCtx)
+	template<typename SocketT>
+	void SetSocketNonBlocking(SocketT& socket, uint32_t sendTimeout, uint32_t recvTimeout)
 	{
 		try
 		{
-			return std::make_unique<ip::tcp::socket>(ioCtx);
+			//Non-blocking mode is only needed when there is a deadline to watch.
+			socket.non_blocking(sendTimeout != 0 || recvTimeout != 0);
 		}
-		RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at tcp socket constrcution.")
+		RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at setting socket mode.")
+	}
+}
+
+constexpr uint32_t TCPConnection::sk_connAttemptDelay;
+constexpr size_t TCPConnection::sk_recvBufferSize;
+
+TCPConnection::Timeouts TCPConnection::GetDefaultTimeouts() noexcept
+{
+	return Timeouts{ gs_defConnectTimeout.load(), gs_defSendTimeout.load(), gs_defRecvTimeout.load() };
+}
+
+void TCPConnection::SetDefaultTimeouts(const Timeouts & timeouts) noexcept
+{
+	gs_defConnectTimeout = timeouts.m_connect;
+	gs_defSendTimeout = timeouts.m_send;
+	gs_defRecvTimeout = timeouts.m_recv;
+}
+
+std::shared_ptr<boost::asio::io_service> TCPConnection::GetSharedIoService()
+{
+	try
+	{
+		static std::shared_ptr<io_service> sharedIoService = std::make_shared<io_service>();
+		return sharedIoService;
 	}
+	RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at io_service constrcution.")
 }
 
 uint32_t TCPConnection::GetIpAddressFromStr(const std::string & ipAddrStr)
@@ -47,7 +352,12 @@ uint32_t TCPConnection::GetIpAddressFromStr(const std::string & ipAddrStr)
 
 TCPConnection::TCPConnection(std::shared_ptr<boost::asio::io_service> ioService, std::shared_ptr<TcpAcceptorType> acceptor) :
 	m_ioService(ioService),
-	m_socket(AcceptConnection(*acceptor))
+	m_socket(AcceptConnection(*acceptor)),
+	m_sendTimeout(0),
+	m_recvTimeout(0),
+	m_recvBuf(sk_recvBufferSize),
+	m_recvBufPos(0),
+	m_recvBufLen(0)
 {
 	try
 	{
@@ -57,21 +367,50 @@ TCPConnection::TCPConnection(std::shared_ptr<boost::asio::io_service> ioService,
 }
 
 TCPConnection::TCPConnection(uint32_t ipAddr, uint16_t portNum) :
-	m_ioService(ConstrIoContext()),
-	m_socket(ConstrSocket(*m_ioService))
+	TCPConnection(ipAddr, portNum, GetDefaultTimeouts())
 {
-	try
-	{
-		m_socket->connect(ip::tcp::endpoint(ip::address_v4(ipAddr), portNum));
-		m_socket->set_option(ip::tcp::no_delay(true));
-	}
-	RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at TCP connect.")
+}
+
+TCPConnection::TCPConnection(uint32_t ipAddr, uint16_t portNum, const Timeouts & timeouts) :
+	m_ioService(GetSharedIoService()),
+	m_socket(ConnectToHost(*m_ioService, std::vector<ip::tcp::endpoint>{ ip::tcp::endpoint(ip::address_v4(ipAddr), portNum) }, timeouts.m_connect)),
+	m_sendTimeout(timeouts.m_send),
+	m_recvTimeout(timeouts.m_recv),
+	m_recvBuf(sk_recvBufferSize),
+	m_recvBufPos(0),
+	m_recvBufLen(0)
+{
+	SetSocketNonBlocking(*m_socket, m_sendTimeout, m_recvTimeout);
+}
+
+TCPConnection::TCPConnection(const std::string & host, uint16_t portNum) :
+	TCPConnection(host, portNum, GetDefaultTimeouts())
+{
+}
+
+TCPConnection::TCPConnection(const std::string & host, uint16_t portNum, const Timeouts & timeouts) :
+	m_ioService(GetSharedIoService()),
+	m_socket(ConnectToHost(*m_ioService, ResolveHost(*m_ioService, host, portNum), timeouts.m_connect)),
+	m_sendTimeout(timeouts.m_send),
+	m_recvTimeout(timeouts.m_recv),
+	m_recvBuf(sk_recvBufferSize),
+	m_recvBufPos(0),
+	m_recvBufLen(0)
+{
+	SetSocketNonBlocking(*m_socket, m_sendTimeout, m_recvTimeout);
 }
 
 TCPConnection::TCPConnection(TCPConnection && rhs) noexcept :
 	m_ioService(std::move(rhs.m_ioService)),
-	m_socket(std::move(rhs.m_socket))
+	m_socket(std::move(rhs.m_socket)),
+	m_sendTimeout(rhs.m_sendTimeout),
+	m_recvTimeout(rhs.m_recvTimeout),
+	m_recvBuf(std::move(rhs.m_recvBuf)),
+	m_recvBufPos(rhs.m_recvBufPos),
+	m_recvBufLen(rhs.m_recvBufLen)
 {
+	rhs.m_recvBufPos = 0;
+	rhs.m_recvBufLen = 0;
 }
 
 TCPConnection::~TCPConnection()
@@ -81,34 +420,134 @@ TCPConnection::~TCPConnection()
 
 size_t TCPConnection::SendRaw(const void * const dataPtr, const size_t size)
 {
-	try 
-	{
-		return m_socket->send(boost::asio::buffer(dataPtr, size));
-	}
-	RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at TCP send.")
+	const ConstBufferItem item{ dataPtr, size };
+	return SendRawV(&item, 1);
 }
 
 size_t TCPConnection::RecvRaw(void * const bufPtr, const size_t size)
 {
-	try
+	const MutableBufferItem item{ bufPtr, size };
+	return RecvRawV(&item, 1);
+}
+
+size_t TCPConnection::SendRawV(const ConstBufferItem * items, const size_t count)
+{
+	boost::container::small_vector<const_buffer, 4> bufSeq;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (items[i].m_size > 0)
+		{
+			bufSeq.push_back(boost::asio::buffer(items[i].m_ptr, items[i].m_size));
+		}
+	}
+
+	if (bufSeq.size() == 0)
+	{
+		return 0;
+	}
+
+	boost::system::error_code ec;
+	size_t sentSize = 0;
+	while (true)
 	{
-		return m_socket->receive(boost::asio::buffer(bufPtr, size));
+		try
+		{
+			sentSize = m_socket->send(bufSeq, 0, ec);
+		}
+		RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at TCP send.")
+
+		//would_block is only possible when the socket is in non-blocking mode (i.e. a deadline is set).
+		if (ec != error::would_block && ec != error::try_again)
+		{
+			break;
+		}
+		WaitReady(false, m_sendTimeout);
 	}
-	RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at TCP receive.")
+
+	if (ec)
+	{
+		throw Exception(boost::system::system_error(ec).what());
+	}
+	return sentSize;
 }
 
-void TCPConnection::Terminate() noexcept
+size_t TCPConnection::RecvRawV(const MutableBufferItem * items, const size_t count)
 {
-	try
+	if (m_recvBufLen > 0)
 	{
-		if (m_ioService->stopped()) { m_ioService->stop(); }
-	}//Just close the connection, no need to handle any exception.
-	catch (...) { }
+		return ConsumeRecvBuffer(items, count);
+	}
+
+	size_t reqSize = 0;
+	boost::container::small_vector<mutable_buffer, 5> bufSeq;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (items[i].m_size > 0)
+		{
+			bufSeq.push_back(boost::asio::buffer(items[i].m_ptr, items[i].m_size));
+			reqSize += items[i].m_size;
+		}
+	}
+
+	if (bufSeq.size() == 0)
+	{
+		return 0;
+	}
+
+	//For small reads, whatever else is already available on the socket is read ahead into the
+	//receive buffer, within the same system call.
+	const bool isReadAhead = reqSize < m_recvBuf.size();
+	if (isReadAhead)
+	{
+		bufSeq.push_back(boost::asio::buffer(m_recvBuf));
+	}
 
+	boost::system::error_code ec;
+	size_t recvSize = 0;
+	while (true)
+	{
+		try
+		{
+			recvSize = m_socket->receive(bufSeq, 0, ec);
+		}
+		RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught at TCP receive.")
+
+		//would_block is only possible when the socket is in non-blocking mode (i.e. a deadline is set).
+		if (ec != error::would_block && ec != error::try_again)
+		{
+			break;
+		}
+		WaitReady(true, m_recvTimeout);
+	}
+
+	if (ec)
+	{
+		throw Exception(boost::system::system_error(ec).what());
+	}
+
+	if (isReadAhead && recvSize > reqSize)
+	{
+		m_recvBufPos = 0;
+		m_recvBufLen = recvSize - reqSize;
+		return reqSize;
+	}
+	return recvSize;
+}
+
+void TCPConnection::SetIoTimeouts(uint32_t sendTimeout, uint32_t recvTimeout)
+{
+	SetSocketNonBlocking(*m_socket, sendTimeout, recvTimeout);
+	m_sendTimeout = sendTimeout;
+	m_recvTimeout = recvTimeout;
+}
+
+void TCPConnection::Terminate() noexcept
+{
+	//The i/o service may be shared with other connections, thus, it's not stopped here.
 	try
 	{
 		if (m_socket->is_open()) { m_socket->close(); }
-	}
+	}//Just close the connection, no need to handle any exception.
 	catch (...) { }
 }
 
@@ -116,7 +555,12 @@ uint32_t TCPConnection::GetIPv4Addr() const
 {
 	try
 	{
-		return m_socket->remote_endpoint().address().to_v4().to_uint();
+		const ip::address addr = m_socket->remote_endpoint().address();
+		if (addr.is_v6() && addr.to_v6().is_v4_mapped())
+		{
+			return addr.to_v6().to_v4().to_uint();
+		}
+		return addr.to_v4().to_uint();
 	}
 	RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught when getting IPv4 addr.")
 }
@@ -132,5 +576,63 @@ uint16_t TCPConnection::GetPortNum() const
 
 uint64_t TCPConnection::GetConnectionID() const
 {
-	return CombineIpAndPort(GetIPv4Addr(), GetPortNum());
+	ip::address addr;
+	try
+	{
+		addr = m_socket->remote_endpoint().address();
+	}
+	RETHROW_BOOST_EXCEPTION_AS_DECENT_EXCEPTION("Unknown exception caught when getting connection ID.")
+
+	if (addr.is_v4() || addr.to_v6().is_v4_mapped())
+	{
+		return CombineIpAndPort(GetIPv4Addr(), GetPortNum());
+	}
+
+	//FNV-1a over the 128-bit address.
+	uint32_t hash = 2166136261U;
+	for (const uint8_t byte : addr.to_v6().to_bytes())
+	{
+		hash = (hash ^ byte) * 16777619U;
+	}
+
+	return CombineIpAndPort(hash, GetPortNum()) | (static_cast<uint64_t>(0x0006) << 16);
+}
+
+size_t TCPConnection::ConsumeRecvBuffer(const MutableBufferItem * items, const size_t count)
+{
+	size_t copied = 0;
+	for (size_t i = 0; i < count && m_recvBufLen > 0; ++i)
+	{
+		const size_t toCopy = std::min(items[i].m_size, m_recvBufLen);
+		std::memcpy(items[i].m_ptr, m_recvBuf.data() + m_recvBufPos, toCopy);
+
+		m_recvBufPos += toCopy;
+		m_recvBufLen -= toCopy;
+		copied += toCopy;
+	}
+	return copied;
+}
+
+void TCPConnection::WaitReady(bool isRead, uint32_t timeout)
+{
+	PollFdType pollFd;
+	pollFd.fd = m_socket->native_handle();
+	pollFd.events = isRead ? POLLIN : POLLOUT;
+	pollFd.revents = 0;
+
+	const int waitMs = timeout == 0 ? -1 : static_cast<int>(timeout);
+
+	int pollRes = 0;
+	while ((pollRes = PollSockets(&pollFd, 1, waitMs)) < 0 && IsInterrupted(GetLastSocketError()))
+	{}
+
+	if (pollRes == 0)
+	{
+		throw TimeoutException(isRead ? "Timed out when receiving data from TCP connection." :
+			"Timed out when sending data through TCP connection.");
+	}
+	if (pollRes < 0)
+	{
+		throw Exception("Failed to poll socket. Error: " + GetSocketErrorMsg(GetLastSocketError()));
+	}
 }
@@ -44,6 +44,44 @@ namespace Decent
 		class TCPConnection : public ConnectionBase
 		{
 		public: //static members:
+			/** \brief	Timeouts, in milliseconds, for TCP operations. Zero means no timeout. */
+			struct Timeouts
+			{
+				uint32_t m_connect;
+				uint32_t m_send;
+				uint32_t m_recv;
+			};
+
+			/** \brief	The delay, in milliseconds, between two connection attempts (RFC 8305). */
+			static constexpr uint32_t sk_connAttemptDelay = 250;
+
+			/**
+			 * \brief	Gets the default timeouts used by constructors without explicit timeouts. Initially,
+			 * 			the connect timeout is 10 seconds, and there is no send/receive timeout, since
+			 * 			pooled connections are usually held idle for long time.
+			 *
+			 * \return	The default timeouts.
+			 */
+			static Timeouts GetDefaultTimeouts() noexcept;
+
+			/**
+			 * \brief	Sets the default timeouts used by constructors without explicit timeouts. This
+			 * 			function is thread-safe.
+			 *
+			 * \param	timeouts	The timeouts.
+			 */
+			static void SetDefaultTimeouts(const Timeouts& timeouts) noexcept;
+
+			/**
+			 * \brief	Gets the i/o service shared by all out-going TCP connections in this process.
+			 *
+			 * \return	The shared i/o service.
+			 */
+			static std::shared_ptr<boost::asio::io_service> GetSharedIoService();
+
+			/** \brief	Size of the receive buffer. Reads smaller than this size are served from the buffer. */
+			static constexpr size_t sk_recvBufferSize = 4096;
+
 			typedef boost::asio::basic_stream_socket<boost::asio::ip::tcp, boost::asio::executor> TcpSocketType;
 			typedef boost::asio::basic_socket_acceptor<boost::asio::ip::tcp, boost::asio::executor> TcpAcceptorType;
 
@@ -88,12 +126,13 @@ namespace Decent
 			TCPConnection(std::shared_ptr<boost::asio::io_service> ioService, std::shared_ptr<TcpAcceptorType> acceptor);
 
 			/**
-			 * \brief	Construct TCP connection by connecting to a server. Usually this constructor is
-			 * 			called in client side.
+			 * \brief	Construct TCP connection by connecting to a server, with the default timeouts.
+			 * 			Usually this constructor is called in client side.
 			 *
-			 * \exception	Decent::Net::Exception	It is thrown when failed to connect remote server.
+			 * \exception	Decent::Net::TimeoutException	It is thrown when the connect is timed out.
+			 * \exception	Decent::Net::Exception			It is thrown when failed to connect remote server.
 			 *
-			 * \param	ipAddr 	The IP address.
+			 * \param	ipAddr 	The IPv4 address.
 			 * \param	portNum	The port number.
 			 */
 			TCPConnection(uint32_t ipAddr, uint16_t portNum);
@@ -102,14 +141,42 @@ namespace Decent
 			 * \brief	Construct TCP connection by connecting to a server. Usually this constructor is
 			 * 			called in client side.
 			 *
-			 * \exception	Decent::Net::Exception	It is thrown when failed to connect remote server.
+			 * \exception	Decent::Net::TimeoutException	It is thrown when the connect is timed out.
+			 * \exception	Decent::Net::Exception			It is thrown when failed to connect remote server.
+			 *
+			 * \param	ipAddr  	The IPv4 address.
+			 * \param	portNum 	The port number.
+			 * \param	timeouts	The timeouts.
+			 */
+			TCPConnection(uint32_t ipAddr, uint16_t portNum, const Timeouts& timeouts);
+
+			/**
+			 * \brief	Construct TCP connection by connecting to a server, with the default timeouts.
+			 * 			Usually this constructor is called in client side.
 			 *
-			 * \param	ipAddr 	The IP address.
+			 * \exception	Decent::Net::TimeoutException	It is thrown when the connect is timed out.
+			 * \exception	Decent::Net::Exception			It is thrown when failed to connect remote server.
+			 *
+			 * \param	host   	The host, which can be a IPv4 address, a IPv6 address, or a host name.
 			 * \param	portNum	The port number.
 			 */
-			TCPConnection(const std::string& ipAddr, uint16_t portNum) :
-				TCPConnection(GetIpAddressFromStr(ipAddr), portNum)
-			{}
+			TCPConnection(const std::string& host, uint16_t portNum);
+
+			/**
+			 * \brief	Construct TCP connection by connecting to a server. If the host resolves to more than
+			 * 			one address, they are tried in the "happy eyeballs" manner (RFC 8305), i.e.
+			 * 			alternating between IPv6 and IPv4, starting a new attempt every
+			 * 			sk_connAttemptDelay milliseconds, and the first one connected wins. Usually this
+			 * 			constructor is called in client side.
+			 *
+			 * \exception	Decent::Net::TimeoutException	It is thrown when the connect is timed out.
+			 * \exception	Decent::Net::Exception			It is thrown when failed to connect remote server.
+			 *
+			 * \param	host		The host, which can be a IPv4 address, a IPv6 address, or a host name.
+			 * \param	portNum 	The port number.
+			 * \param	timeouts	The timeouts.
+			 */
+			TCPConnection(const std::string& host, uint16_t portNum, const Timeouts& timeouts);
 
 			/**
 			 * \brief	Construct TCP connection by connecting to a server. Usually this constructor is
@@ -139,12 +206,50 @@ namespace Decent
 
 			virtual size_t RecvRaw(void* const bufPtr, const size_t size) override;
 
+			/**
+			 * \brief	Sends data from a list of buffers with one system call (i.e. writev).
+			 *
+			 * \exception	Decent::Net::Exception	.
+			 *
+			 * \param	items	The list of buffers.
+			 * \param	count	Number of items in the list.
+			 *
+			 * \return	A size_t. The size of data has been sent.
+			 */
+			virtual size_t SendRawV(const ConstBufferItem* items, const size_t count) override;
+
+			/**
+			 * \brief	Receives data into a list of buffers with one system call (i.e. readv). Extra data
+			 * 			available on the socket is read ahead into the receive buffer.
+			 *
+			 * \exception	Decent::Net::Exception	.
+			 *
+			 * \param	items	The list of buffers.
+			 * \param	count	Number of items in the list.
+			 *
+			 * \return	A size_t. The size of data has been received.
+			 */
+			virtual size_t RecvRawV(const MutableBufferItem* items, const size_t count) override;
+
+			/**
+			 * \brief	Sets the deadlines for each send and receive operation. If an operation can't make
+			 * 			any progress within the deadline, Decent::Net::TimeoutException will be thrown.
+			 *
+			 * \exception	Decent::Net::Exception	.
+			 *
+			 * \param	sendTimeout	The send timeout in milliseconds. Zero means no timeout.
+			 * \param	recvTimeout	The receive timeout in milliseconds. Zero means no timeout.
+			 */
+			void SetIoTimeouts(uint32_t sendTimeout, uint32_t recvTimeout);
+
 			/** \brief	Terminates this TCP connection */
 			virtual void Terminate() noexcept override;
 
 			/**
-			 * \brief	Gets IPv4 address
-			 * 			Known exceptions: Decent::Net::Exception
+			 * \brief	Gets IPv4 address. A peer connected through an IPv4-mapped IPv6 address is reported
+			 * 			with its IPv4 address.
+			 * 			Known exceptions: Decent::Net::Exception (including when the peer has a native IPv6
+			 * 			address; use GetConnectionID to identify such peers)
 			 *
 			 * \return	The IPv4 address in the form of a 4-Byte-number.
 			 */
@@ -159,16 +264,44 @@ namespace Decent
 			uint16_t GetPortNum() const;
 
 			/**
-			 * \brief	Connection ID is a combination of IPv4 and Port number in the format of 
-			 * 			IP(32-bits)|0x0000|Port(16-bits).
+			 * \brief	Connection ID is a combination of IP address and Port number. For IPv4 peers
+			 * 			(including IPv4-mapped IPv6 addresses), it's in the format of
+			 * 			IP(32-bits)|0x0000|Port(16-bits). For native IPv6 peers, it's in the format of
+			 * 			Hash(32-bits)|0x0006|Port(16-bits), where the hash is folded from the 128-bit
+			 * 			address, so it never equals the ID of an IPv4 peer.
+			 * 			Known exceptions: Decent::Net::Exception
 			 *
 			 * \return	The connection identifier.
 			 */
 			uint64_t GetConnectionID() const;
 
 		private:
+			/**
+			 * \brief	Copies the data already buffered into the given list of buffers.
+			 *
+			 * \return	A size_t. The size of data has been copied.
+			 */
+			size_t ConsumeRecvBuffer(const MutableBufferItem* items, const size_t count);
+
+			/**
+			 * \brief	Waits until the socket is ready for the operation.
+			 *
+			 * \exception	Decent::Net::TimeoutException	It is thrown when the socket is not ready in time.
+			 *
+			 * \param	isRead 	True for receive, false for send.
+			 * \param	timeout	The timeout in milliseconds. Zero means no timeout.
+			 */
+			void WaitReady(bool isRead, uint32_t timeout);
+
 			std::shared_ptr<boost::asio::io_service> m_ioService;
 			std::unique_ptr<TcpSocketType> m_socket;
+
+			uint32_t m_sendTimeout;
+			uint32_t m_recvTimeout;
+
+			std::vector<uint8_t> m_recvBuf;
+			size_t m_recvBufPos;
+			size_t m_recvBufLen;
 		};
 	}
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <map>
 #include <string>
+#include <vector>
 
 namespace Decent
 {
@@ -16,6 +18,22 @@ namespace Decent
 		public:
 			virtual std::string GetDecentSelfRAReport() const = 0;
 			virtual void LoadConstWhiteList(const std::string& key, const std::string& whiteList) = 0;
+
+			/**
+			 * \brief	Loads a batch of const white lists at once. The batch is validated as a whole; if any
+			 * 			white list is invalid, nothing is changed.
+			 *
+			 * \param	whiteLists	The white lists to add (or replace), in the format of Map[Key] = List_JSON.
+			 * \param	removeKeys	The keys of the white lists to remove.
+			 */
+			virtual void LoadConstWhiteLists(const std::map<std::string, std::string>& whiteLists, const std::vector<std::string>& removeKeys) = 0;
+
+			/**
+			 * \brief	Loads a batch of const white lists packed by Ra::WhiteList::ConstListBatch.
+			 *
+			 * \param	packed	The packed batch.
+			 */
+			virtual void LoadConstWhiteLists(const std::string& packed) = 0;
 			virtual void ProcessAppCertReq(const std::string& wListKey, Net::ConnectionBase& connection) = 0;
 
 		protected:
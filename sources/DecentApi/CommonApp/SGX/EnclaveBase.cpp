@@ -13,6 +13,7 @@
 
 #include "../Tools/FileSystemUtil.h"
 #include "../Tools/DiskFile.h"
+#include "../Tools/UntrustedArena.h"
 
 #include "../../Common/Common.h"
 #include "../../Common/Tools/DataCoding.h"
@@ -22,6 +23,7 @@
 #include "../Base/EnclaveException.h"
 
 #include "edl_decent_sgx_client.h"
+#include "SwitchlessMonitor.h"
 
 using namespace Decent::Sgx;
 using namespace Decent::Net;
@@ -29,6 +31,12 @@ using namespace Decent::Tools;
 
 namespace
 {
+	static void SwitchlessWorkerCallback(sgx_uswitchless_worker_type_t type, sgx_uswitchless_worker_event_t workerEvent, const sgx_uswitchless_worker_stats_t* stats)
+	{
+		SwitchlessMonitor::Get().OnWorkerEvent(type == SGX_USWITCHLESS_WORKER_TYPE_TRUSTED, static_cast<int>(workerEvent),
+			stats ? stats->processed : 0, stats ? stats->missed : 0);
+	}
+
 	static sgx_uswitchless_config_t ConstructSwitchlessConfig(const size_t numTWorker, const size_t numUWorker, const size_t retryFallback, const size_t retrySleep)
 	{
 		if (numTWorker > UINT32_MAX || numUWorker > UINT32_MAX || retryFallback > UINT32_MAX || retrySleep > UINT32_MAX)
@@ -40,6 +48,10 @@ namespace
 		configRes.num_uworkers = static_cast<uint32_t>(numUWorker);
 		configRes.retries_before_fallback = static_cast<uint32_t>(retryFallback);
 		configRes.retries_before_sleep = static_cast<uint32_t>(retrySleep);
+		for (size_t i = 0; i < _SGX_USWITCHLESS_WORKER_EVENT_NUM; ++i)
+		{
+			configRes.callback_func[i] = &SwitchlessWorkerCallback;
+		}
 
 		return configRes;
 	}
@@ -133,6 +145,11 @@ namespace
 
 constexpr char EnclaveBase::sk_platformType[];
 
+SwitchlessMonitor & EnclaveBase::GetSwitchlessMonitor()
+{
+	return SwitchlessMonitor::Get();
+}
+
 void EnclaveBase::InternalInitSgxEnclave(const sgx_enclave_id_t & encId)
 {
 	sgx_status_t retval = SGX_SUCCESS;
@@ -241,9 +258,9 @@ extern "C" int ocall_decent_sgx_ra_get_msg1(const uint64_t enclave_id, const uin
 	return (enclaveRet == SGX_SUCCESS);
 }
 
-extern "C" size_t ocall_decent_sgx_ra_proc_msg2(const uint64_t enclave_id, const uint32_t ra_ctx, const sgx_ra_msg2_t* msg2, const size_t msg2_size, uint8_t** out_msg3)
+extern "C" size_t ocall_decent_sgx_ra_proc_msg2(const uint64_t enclave_id, const uint32_t ra_ctx, const sgx_ra_msg2_t* msg2, const size_t msg2_size, uint8_t** out_msg3, uint64_t* out_token)
 {
-	if (!msg2 || !out_msg3)
+	if (!msg2 || !out_msg3 || !out_token)
 	{
 		return 0;
 	}
@@ -264,8 +281,8 @@ extern "C" size_t ocall_decent_sgx_ra_proc_msg2(const uint64_t enclave_id, const
 		return 0;
 	}
 
-	//Copy msg3 to our buffer pointer to avoid the mix use of malloc and delete[];
-	*out_msg3 = new uint8_t[tmpMsg3Size];
+	//Copy msg3 to the buffer for the enclave to avoid the mix use of malloc and delete[];
+	*out_msg3 = UntrustedArena::AllocateForEnclave(tmpMsg3Size, *out_token);
 	std::memcpy(*out_msg3, tmpMsg3, tmpMsg3Size);
 	std::free(tmpMsg3);
 
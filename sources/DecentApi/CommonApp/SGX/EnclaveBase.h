@@ -23,6 +23,8 @@ namespace Decent
 {
 	namespace Sgx
 	{
+		class SwitchlessMonitor;
+
 		class EnclaveBase : virtual public Base::EnclaveBase
 		{
 		public: //static member:
@@ -31,6 +33,17 @@ namespace Decent
 			static bool InternalUpdateToken(const fs::path& tokenPath, const std::vector<uint8_t>& inToken);
 			static void InternalInitSgxEnclave(const sgx_enclave_id_t& encId);
 
+			/**
+			 * \brief	Gets the monitor of switchless OCALLs, which decides whether the hot OCALLs go
+			 * 			switchless at runtime, and keeps the per-call and worker statistics. The workers are
+			 * 			only available if the enclave is created with the switchless config (i.e.
+			 * 			numTWorker, numUWorker, etc.); otherwise, the switchless variants fall back to
+			 * 			regular calls.
+			 *
+			 * \return	The switchless monitor.
+			 */
+			static SwitchlessMonitor& GetSwitchlessMonitor();
+
 		public:
 			EnclaveBase() = delete;
 
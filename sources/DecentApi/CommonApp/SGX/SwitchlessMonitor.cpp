@@ -0,0 +1,161 @@
+#include "SwitchlessMonitor.h"
+
+#include <chrono>
+
+using namespace Decent::Sgx;
+
+namespace
+{
+	static int64_t GetSteadyTimeMs() noexcept
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+constexpr uint64_t SwitchlessMonitor::sk_defaultThreshold;
+constexpr uint64_t SwitchlessMonitor::sk_windowLengthMs;
+
+SwitchlessMonitor & SwitchlessMonitor::Get()
+{
+	static SwitchlessMonitor inst;
+	return inst;
+}
+
+SwitchlessMonitor::SwitchlessMonitor() :
+	m_mode(Mode::Adaptive),
+	m_threshold(sk_defaultThreshold)
+{
+	const int64_t now = GetSteadyTimeMs();
+	for (size_t i = 0; i < gsk_switchlessOcallCount; ++i)
+	{
+		m_counters[i].m_regularCalls = 0;
+		m_counters[i].m_switchlessCalls = 0;
+		m_counters[i].m_windowCalls = 0;
+		m_counters[i].m_windowStart = now;
+		m_counters[i].m_callRate = 0;
+		m_hints[i] = 0;
+	}
+
+	for (WorkerCounter& worker : m_workers)
+	{
+		worker.m_processed = 0;
+		worker.m_missed = 0;
+		for (std::atomic<uint64_t>& eventCount : worker.m_eventCount)
+		{
+			eventCount = 0;
+		}
+	}
+}
+
+SwitchlessMonitor::~SwitchlessMonitor()
+{
+}
+
+void SwitchlessMonitor::Record(SwitchlessOcall type, bool isSwitchless) noexcept
+{
+	const size_t idx = static_cast<size_t>(type);
+	if (idx >= gsk_switchlessOcallCount)
+	{
+		return;
+	}
+
+	CallCounter& counter = m_counters[idx];
+	(isSwitchless ? counter.m_switchlessCalls : counter.m_regularCalls)++;
+	++counter.m_windowCalls;
+
+	//Every group is re-evaluated, so that an idle group doesn't keep its hint until its next call.
+	EndWindows(GetSteadyTimeMs());
+}
+
+void SwitchlessMonitor::SetMode(Mode mode) noexcept
+{
+	m_mode = mode;
+	for (size_t i = 0; i < gsk_switchlessOcallCount; ++i)
+	{
+		UpdateHint(i, m_counters[i].m_callRate);
+	}
+}
+
+SwitchlessMonitor::CallStats SwitchlessMonitor::GetCallStats(SwitchlessOcall type) const noexcept
+{
+	const size_t idx = static_cast<size_t>(type);
+	if (idx >= gsk_switchlessOcallCount)
+	{
+		return CallStats{ 0, 0, 0, false };
+	}
+
+	const CallCounter& counter = m_counters[idx];
+	return CallStats{ counter.m_regularCalls, counter.m_switchlessCalls, counter.m_callRate, m_hints[idx] != 0 };
+}
+
+SwitchlessMonitor::WorkerStats SwitchlessMonitor::GetWorkerStats(bool isTrusted) const noexcept
+{
+	const WorkerCounter& worker = m_workers[isTrusted ? 1 : 0];
+	return WorkerStats{ worker.m_processed, worker.m_missed,
+		worker.m_eventCount[0], worker.m_eventCount[1], worker.m_eventCount[2], worker.m_eventCount[3] };
+}
+
+void SwitchlessMonitor::OnWorkerEvent(bool isTrusted, int workerEvent, uint64_t processed, uint64_t missed) noexcept
+{
+	WorkerCounter& worker = m_workers[isTrusted ? 1 : 0];
+
+	if (workerEvent >= 0 && workerEvent < 4)
+	{
+		++worker.m_eventCount[workerEvent];
+	}
+
+	//The numbers are accumulated by the SDK; events may arrive out of order from different workers.
+	uint64_t prev = worker.m_processed;
+	while (processed > prev && !worker.m_processed.compare_exchange_weak(prev, processed)) {}
+	prev = worker.m_missed;
+	while (missed > prev && !worker.m_missed.compare_exchange_weak(prev, missed)) {}
+
+	//Workers go idle once the calls stop, which is a good time to let the hints decay.
+	EndWindows(GetSteadyTimeMs());
+}
+
+void SwitchlessMonitor::EndWindows(int64_t now) noexcept
+{
+	for (size_t i = 0; i < gsk_switchlessOcallCount; ++i)
+	{
+		CallCounter& counter = m_counters[i];
+
+		int64_t windowStart = counter.m_windowStart;
+		const int64_t elapsed = now - windowStart;
+		//Only the thread that moves the window forward computes the rate of the window ended.
+		if (elapsed < static_cast<int64_t>(sk_windowLengthMs) ||
+			!counter.m_windowStart.compare_exchange_strong(windowStart, now))
+		{
+			continue;
+		}
+
+		const uint64_t callRate = (counter.m_windowCalls.exchange(0) * 1000) / static_cast<uint64_t>(elapsed);
+		counter.m_callRate = callRate;
+
+		UpdateHint(i, callRate);
+	}
+}
+
+void SwitchlessMonitor::UpdateHint(size_t idx, uint64_t callRate) noexcept
+{
+	switch (m_mode.load())
+	{
+	case Mode::Never:
+		m_hints[idx] = 0;
+		break;
+	case Mode::Always:
+		m_hints[idx] = 1;
+		break;
+	case Mode::Adaptive:
+	default:
+		if (callRate >= m_threshold)
+		{
+			m_hints[idx] = 1;
+		}
+		else if (callRate < m_threshold / 2)
+		{
+			m_hints[idx] = 0;
+		}
+		break;
+	}
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+
+#include "../../Common/SGX/SwitchlessOcall.h"
+
+namespace Decent
+{
+	namespace Sgx
+	{
+		/**
+		 * \brief	Monitor of the switchless OCALLs of all enclaves in this process. It counts the
+		 * 			calls to each group of hot OCALLs (see SwitchlessOcall), measures the call rate in
+		 * 			fixed windows, and publishes a hint per group that tells the enclave whether to use
+		 * 			the switchless variant. The windows of all groups are ended on any call or worker
+		 * 			event, so the hint of a group that has gone idle decays within two windows, even if
+		 * 			it's not called anymore. The hints are in untrusted memory that is read by the
+		 * 			enclave directly; they only affect performance, never the security. The statistics
+		 * 			reported by the switchless workers are collected as well, so that the number of
+		 * 			workers can be sized from data. This class is thread-safe.
+		 */
+		class SwitchlessMonitor
+		{
+		public: //static members:
+			enum class Mode : uint8_t
+			{
+				Never    = 0,
+				Adaptive = 1,
+				Always   = 2,
+			};
+
+			struct CallStats
+			{
+				uint64_t m_regularCalls;
+				uint64_t m_switchlessCalls;
+				uint64_t m_callRate;   //Calls per second in the last complete window.
+				bool m_useSwitchless;
+			};
+
+			struct WorkerStats
+			{
+				uint64_t m_processed;  //Number of tasks processed by the workers.
+				uint64_t m_missed;     //Number of tasks missed by the workers, which fell back to regular calls.
+				uint64_t m_startCount;
+				uint64_t m_idleCount;
+				uint64_t m_missCount;
+				uint64_t m_exitCount;
+			};
+
+			static constexpr uint64_t sk_defaultThreshold = 1000;
+			static constexpr uint64_t sk_windowLengthMs = 1000;
+
+			/**
+			 * \brief	Gets the monitor of this process.
+			 *
+			 * \return	The monitor.
+			 */
+			static SwitchlessMonitor& Get();
+
+		public:
+			SwitchlessMonitor();
+
+			SwitchlessMonitor(const SwitchlessMonitor& rhs) = delete;
+
+			SwitchlessMonitor(SwitchlessMonitor&& rhs) = delete;
+
+			virtual ~SwitchlessMonitor();
+
+			/**
+			 * \brief	Records a call to an OCALL, and updates the hints of the groups whose window has
+			 * 			ended.
+			 *
+			 * \param	type		  	The group of the OCALL.
+			 * \param	isSwitchless	True if the switchless variant is called.
+			 */
+			void Record(SwitchlessOcall type, bool isSwitchless) noexcept;
+
+			/**
+			 * \brief	Sets the mode. In adaptive mode, a group goes switchless once its call rate reaches
+			 * 			the threshold, and goes back once the rate drops below half of the threshold.
+			 *
+			 * \param	mode	The mode.
+			 */
+			void SetMode(Mode mode) noexcept;
+
+			Mode GetMode() const noexcept { return m_mode; }
+
+			/**
+			 * \brief	Sets the threshold of the adaptive mode.
+			 *
+			 * \param	callsPerSec	The call rate, in calls per second.
+			 */
+			void SetThreshold(uint64_t callsPerSec) noexcept { m_threshold = callsPerSec; }
+
+			uint64_t GetThreshold() const noexcept { return m_threshold; }
+
+			/**
+			 * \brief	Gets the statistics of a group of OCALLs.
+			 *
+			 * \param	type	The group of the OCALL.
+			 *
+			 * \return	The statistics.
+			 */
+			CallStats GetCallStats(SwitchlessOcall type) const noexcept;
+
+			/**
+			 * \brief	Gets the statistics of switchless workers.
+			 *
+			 * \param	isTrusted	True to get the ones of the trusted workers (i.e. for ECALLs), false
+			 * 						to get the ones of the untrusted workers (i.e. for OCALLs).
+			 *
+			 * \return	The statistics.
+			 */
+			WorkerStats GetWorkerStats(bool isTrusted) const noexcept;
+
+			/**
+			 * \brief	Gets the hints read by the enclave, one byte per group of OCALLs, where non-zero
+			 * 			means using the switchless variant.
+			 *
+			 * \return	The pointer to the hints, with gsk_switchlessOcallCount bytes.
+			 */
+			volatile uint8_t* GetHints() noexcept { return m_hints; }
+
+			/**
+			 * \brief	Records an event reported by the switchless workers, i.e. through the callbacks in
+			 * 			sgx_uswitchless_config_t.
+			 *
+			 * \param	isTrusted  	True if it's reported by a trusted worker.
+			 * \param	workerEvent	The event, i.e. the value of sgx_uswitchless_worker_event_t.
+			 * \param	processed  	Number of tasks processed by all workers of this type.
+			 * \param	missed	   	Number of tasks missed by all workers of this type.
+			 */
+			void OnWorkerEvent(bool isTrusted, int workerEvent, uint64_t processed, uint64_t missed) noexcept;
+
+		private:
+			struct CallCounter
+			{
+				std::atomic<uint64_t> m_regularCalls;
+				std::atomic<uint64_t> m_switchlessCalls;
+				std::atomic<uint64_t> m_windowCalls;
+				std::atomic<int64_t> m_windowStart;
+				std::atomic<uint64_t> m_callRate;
+			};
+
+			struct WorkerCounter
+			{
+				std::atomic<uint64_t> m_processed;
+				std::atomic<uint64_t> m_missed;
+				std::atomic<uint64_t> m_eventCount[4];
+			};
+
+			/**
+			 * \brief	Ends the window of each group that has lasted long enough, and updates its hint with
+			 * 			the call rate in that window (which is zero for an idle group).
+			 *
+			 * \param	now	The current steady time, in milliseconds.
+			 */
+			void EndWindows(int64_t now) noexcept;
+
+			void UpdateHint(size_t idx, uint64_t callRate) noexcept;
+
+			std::atomic<Mode> m_mode;
+			std::atomic<uint64_t> m_threshold;
+
+			CallCounter m_counters[gsk_switchlessOcallCount];
+			WorkerCounter m_workers[2];
+
+			//Plain bytes, since they are read by the enclave as they are.
+			volatile uint8_t m_hints[gsk_switchlessOcallCount];
+		};
+	}
+}
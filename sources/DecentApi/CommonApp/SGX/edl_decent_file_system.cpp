@@ -57,4 +57,36 @@ extern "C" size_t ocall_decent_tools_fwrite(const void* buffer, size_t buffer_si
 	return std::fwrite(buffer, sizeof(uint8_t), buffer_size, static_cast<FILE*>(file));
 }
 
+extern "C" size_t ocall_decent_tools_fsize(void* file)
+{
+	FILE* filePtr = static_cast<FILE*>(file);
+	const long pos = std::ftell(filePtr);
+	if (pos < 0 || std::fseek(filePtr, 0, SEEK_END) != 0)
+	{
+		return 0;
+	}
+	const long size = std::ftell(filePtr);
+	std::fseek(filePtr, pos, SEEK_SET);
+	return size < 0 ? 0 : static_cast<size_t>(size);
+}
+
+extern "C" size_t ocall_decent_tools_fread_at(void* buffer, size_t buffer_size, void* file, int64_t offset)
+{
+	if (std::fseek(static_cast<FILE*>(file), static_cast<long>(offset), SEEK_SET) != 0)
+	{
+		return 0;
+	}
+	return std::fread(buffer, sizeof(uint8_t), buffer_size, static_cast<FILE*>(file));
+}
+
+extern "C" size_t ocall_decent_tools_fwrite_at(const void* buffer, size_t buffer_size, void* file, int64_t offset)
+{
+	//In append modes, the position is ignored by fwrite and the data always goes to the end of file.
+	if (std::fseek(static_cast<FILE*>(file), static_cast<long>(offset), SEEK_SET) != 0)
+	{
+		return 0;
+	}
+	return std::fwrite(buffer, sizeof(uint8_t), buffer_size, static_cast<FILE*>(file));
+}
+
 //#endif //ENCLAVE_PLATFORM_SGX
\ No newline at end of file
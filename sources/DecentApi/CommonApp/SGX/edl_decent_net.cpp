@@ -2,10 +2,42 @@
 
 #include "../../Common/Common.h"
 #include "../../Common/Net/ConnectionBase.h"
+#include "../Tools/UntrustedArena.h"
+#include "SwitchlessMonitor.h"
 
 using namespace Decent::Net;
+using namespace Decent::Sgx;
+using namespace Decent::Tools;
 
-extern "C" int ocall_decent_net_cnet_send_pack(void* const ptr, const uint8_t* msg, size_t size)
+namespace
+{
+	/**
+	 * \brief	Receives a package of message into a buffer given by UntrustedArena::AllocateForEnclave,
+	 * 			so that the enclave can read and recycle it without another OCALL. The format is the
+	 * 			same as the one of ConnectionBase::RecvPack.
+	 */
+	static size_t RecvPackForEnclave(ConnectionBase& cnt, uint8_t*& dest, uint64_t& token)
+	{
+		uint64_t packSize = 0;
+		cnt.RecvRawAll(&packSize, sizeof(packSize));
+
+		uint8_t* buf = UntrustedArena::AllocateForEnclave(static_cast<size_t>(packSize), token);
+		try
+		{
+			cnt.RecvRawAll(buf, static_cast<size_t>(packSize));
+		}
+		catch (...)
+		{
+			UntrustedArena::FreeForEnclave(buf, token);
+			throw;
+		}
+
+		dest = buf;
+		return static_cast<size_t>(packSize);
+	}
+}
+
+static int CnetSendPack(void* const ptr, const uint8_t* msg, size_t size)
 {
 	if (!ptr || !msg)
 	{
@@ -25,9 +57,21 @@ extern "C" int ocall_decent_net_cnet_send_pack(void* const ptr, const uint8_t* m
 	}
 }
 
-extern "C" int ocall_decent_net_cnet_recv_pack(void* const ptr, uint8_t** msg, size_t* recv_size)
+extern "C" int ocall_decent_net_cnet_send_pack(void* const ptr, const uint8_t* msg, size_t size)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::NetSend, false);
+	return CnetSendPack(ptr, msg, size);
+}
+
+extern "C" int ocall_decent_net_cnet_send_pack_swl(void* const ptr, const uint8_t* msg, size_t size)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::NetSend, true);
+	return CnetSendPack(ptr, msg, size);
+}
+
+static int CnetRecvPack(void* const ptr, uint8_t** msg, size_t* recv_size, uint64_t* token)
 {
-	if (!recv_size || !ptr || !msg)
+	if (!recv_size || !ptr || !msg || !token)
 	{
 		PRINT_W("Nullptr is given to the ocall_decent_net_cnet_recv_pack");
 		return false;
@@ -35,7 +79,7 @@ extern "C" int ocall_decent_net_cnet_recv_pack(void* const ptr, uint8_t** msg, s
 
 	try
 	{
-		*recv_size = static_cast<ConnectionBase*>(ptr)->RecvPack(*msg);
+		*recv_size = RecvPackForEnclave(*static_cast<ConnectionBase*>(ptr), *msg, *token);
 		return true;
 	}
 	catch (const std::exception& e)
@@ -45,9 +89,21 @@ extern "C" int ocall_decent_net_cnet_recv_pack(void* const ptr, uint8_t** msg, s
 	}
 }
 
-extern "C" int ocall_decent_net_cnet_send_and_recv_pack(void* const ptr, const uint8_t* in_msg, size_t in_size, uint8_t** out_msg, size_t* out_size)
+extern "C" int ocall_decent_net_cnet_recv_pack(void* const ptr, uint8_t** msg, size_t* recv_size, uint64_t* token)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::NetRecv, false);
+	return CnetRecvPack(ptr, msg, recv_size, token);
+}
+
+extern "C" int ocall_decent_net_cnet_recv_pack_swl(void* const ptr, uint8_t** msg, size_t* recv_size, uint64_t* token)
 {
-	if (!ptr || !in_msg || !out_msg || !out_size)
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::NetRecv, true);
+	return CnetRecvPack(ptr, msg, recv_size, token);
+}
+
+static int CnetSendAndRecvPack(void* const ptr, const uint8_t* in_msg, size_t in_size, uint8_t** out_msg, size_t* out_size, uint64_t* out_token)
+{
+	if (!ptr || !in_msg || !out_msg || !out_size || !out_token)
 	{
 		PRINT_W("Nullptr is given to the ocall_decent_net_cnet_send_and_recv_pack");
 		return false;
@@ -56,7 +112,7 @@ extern "C" int ocall_decent_net_cnet_send_and_recv_pack(void* const ptr, const u
 	try
 	{
 		static_cast<ConnectionBase*>(ptr)->SendPack(in_msg, in_size);
-		*out_size = static_cast<ConnectionBase*>(ptr)->RecvPack(*out_msg);
+		*out_size = RecvPackForEnclave(*static_cast<ConnectionBase*>(ptr), *out_msg, *out_token);
 		return true;
 	}
 	catch (const std::exception& e)
@@ -66,7 +122,19 @@ extern "C" int ocall_decent_net_cnet_send_and_recv_pack(void* const ptr, const u
 	}
 }
 
-extern "C" int ocall_decent_net_cnet_send_raw(size_t* sent_size, void* const ptr, const uint8_t* msg, size_t size)
+extern "C" int ocall_decent_net_cnet_send_and_recv_pack(void* const ptr, const uint8_t* in_msg, size_t in_size, uint8_t** out_msg, size_t* out_size, uint64_t* out_token)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::NetRecv, false);
+	return CnetSendAndRecvPack(ptr, in_msg, in_size, out_msg, out_size, out_token);
+}
+
+extern "C" int ocall_decent_net_cnet_send_and_recv_pack_swl(void* const ptr, const uint8_t* in_msg, size_t in_size, uint8_t** out_msg, size_t* out_size, uint64_t* out_token)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::NetRecv, true);
+	return CnetSendAndRecvPack(ptr, in_msg, in_size, out_msg, out_size, out_token);
+}
+
+static int CnetSendRaw(size_t* sent_size, void* const ptr, const uint8_t* msg, size_t size)
 {
 	if (!sent_size || !ptr || !msg)
 	{
@@ -86,7 +154,19 @@ extern "C" int ocall_decent_net_cnet_send_raw(size_t* sent_size, void* const ptr
 	}
 }
 
-extern "C" int ocall_decent_net_cnet_recv_raw(size_t* recv_size, void* const ptr, uint8_t* buf, size_t buf_size)
+extern "C" int ocall_decent_net_cnet_send_raw(size_t* sent_size, void* const ptr, const uint8_t* msg, size_t size)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::NetSend, false);
+	return CnetSendRaw(sent_size, ptr, msg, size);
+}
+
+extern "C" int ocall_decent_net_cnet_send_raw_swl(size_t* sent_size, void* const ptr, const uint8_t* msg, size_t size)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::NetSend, true);
+	return CnetSendRaw(sent_size, ptr, msg, size);
+}
+
+static int CnetRecvRaw(size_t* recv_size, void* const ptr, uint8_t* buf, size_t buf_size)
 {
 	if (!recv_size || !ptr || !buf)
 	{
@@ -106,6 +186,18 @@ extern "C" int ocall_decent_net_cnet_recv_raw(size_t* recv_size, void* const ptr
 	}
 }
 
+extern "C" int ocall_decent_net_cnet_recv_raw(size_t* recv_size, void* const ptr, uint8_t* buf, size_t buf_size)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::NetRecv, false);
+	return CnetRecvRaw(recv_size, ptr, buf, buf_size);
+}
+
+extern "C" int ocall_decent_net_cnet_recv_raw_swl(size_t* recv_size, void* const ptr, uint8_t* buf, size_t buf_size)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::NetRecv, true);
+	return CnetRecvRaw(recv_size, ptr, buf, buf_size);
+}
+
 extern "C" void ocall_decent_net_cnet_terminate(void* cnt_ptr)
 {
 	if (!cnt_ptr)
@@ -2,36 +2,100 @@
 
 #include <cstdio>
 #include <ctime>
+#include <new>
 
 #include "../Common.h"
+#include "../Tools/UntrustedArena.h"
+#include "SwitchlessMonitor.h"
 #include "../../Common/Common.h"
+#include "../../Common/Tools/UntrustedArenaLayout.h"
 
+using namespace Decent::Sgx;
 using namespace Decent::Tools;
 
+namespace
+{
+	static void PrintString(const char *str)
+	{
+		printf("%s", str);
+	}
+
+	static void PrintStringI(const char *str)
+	{
+		SetConsoleColor(ConsoleColors::Green, ConsoleColors::Default);
+		printf("%s", str);
+		SetConsoleColor(ConsoleColors::Default, ConsoleColors::Default);
+	}
+
+	static void PrintStringW(const char *str)
+	{
+		SetConsoleColor(ConsoleColors::Yellow, ConsoleColors::Default);
+		printf("%s", str);
+		SetConsoleColor(ConsoleColors::Default, ConsoleColors::Default);
+	}
+}
+
 extern "C" void ocall_decent_tools_print_string(const char *str)
 {
-	printf("%s", str);
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::Print, false);
+	PrintString(str);
+}
+
+extern "C" void ocall_decent_tools_print_string_swl(const char *str)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::Print, true);
+	PrintString(str);
 }
 
 extern "C" void ocall_decent_tools_print_string_i(const char *str)
 {
-	SetConsoleColor(ConsoleColors::Green, ConsoleColors::Default);
-	printf("%s", str);
-	SetConsoleColor(ConsoleColors::Default, ConsoleColors::Default);
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::Print, false);
+	PrintStringI(str);
+}
+
+extern "C" void ocall_decent_tools_print_string_i_swl(const char *str)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::Print, true);
+	PrintStringI(str);
 }
 
 extern "C" void ocall_decent_tools_print_string_w(const char *str)
 {
-	SetConsoleColor(ConsoleColors::Yellow, ConsoleColors::Default);
-	printf("%s", str);
-	SetConsoleColor(ConsoleColors::Default, ConsoleColors::Default);
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::Print, false);
+	PrintStringW(str);
+}
+
+extern "C" void ocall_decent_tools_print_string_w_swl(const char *str)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::Print, true);
+	PrintStringW(str);
 }
 
 extern "C" void ocall_decent_tools_get_sys_time(time_t* timer)
 {
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::Time, false);
+	std::time(timer);
+}
+
+extern "C" void ocall_decent_tools_get_sys_time_swl(time_t* timer)
+{
+	SwitchlessMonitor::Get().Record(SwitchlessOcall::Time, true);
 	std::time(timer);
 }
 
+extern "C" int ocall_decent_tools_get_swl_hints(uint8_t** hints, size_t* count)
+{
+	if (!hints || !count)
+	{
+		return false;
+	}
+
+	*hints = const_cast<uint8_t*>(SwitchlessMonitor::Get().GetHints());
+	*count = gsk_switchlessOcallCount;
+
+	return true;
+}
+
 extern "C" void ocall_decent_tools_get_sys_utc_time(const time_t* timer, tm* out_time)
 {
 	if (!timer || !out_time)
@@ -42,6 +106,11 @@ extern "C" void ocall_decent_tools_get_sys_utc_time(const time_t* timer, tm* out
 	GetSystemUtcTime(*timer, *out_time);
 }
 
+extern "C" uint8_t* ocall_decent_tools_new_buf_uint8(size_t size)
+{
+	return new (std::nothrow) uint8_t[size];
+}
+
 extern "C" void ocall_decent_tools_del_buf_char(char* ptr)
 {
 	delete[] ptr;
@@ -52,4 +121,29 @@ extern "C" void ocall_decent_tools_del_buf_uint8(uint8_t* ptr)
 	delete[] ptr;
 }
 
+extern "C" int ocall_decent_tools_get_arena_info(uint16_t arena_id, uint8_t** base, size_t* slot_count, size_t* slot_size)
+{
+	const UntrustedArena* arena = UntrustedArena::Find(arena_id);
+	if (!arena || !base || !slot_count || !slot_size)
+	{
+		return false;
+	}
+
+	*base = arena->GetBase();
+	*slot_count = arena->GetSlotCount();
+	*slot_size = arena->GetSlotSize();
+
+	return true;
+}
+
+extern "C" void ocall_decent_tools_free_arena_slot(uint64_t token)
+{
+	if (token == UntrustedArenaToken::sk_heapBuffer)
+	{
+		return;
+	}
+
+	UntrustedArena::FreeForEnclave(nullptr, token);
+}
+
 //#endif //ENCLAVE_PLATFORM_SGX
@@ -12,19 +12,47 @@
 using namespace Decent;
 using namespace Decent::Tools;
 
+namespace
+{
+	/**
+	 * \brief	Gets the JSON reader of current thread. Building a reader is much more expensive than
+	 * 			the parsing of our (small) messages, thus, it's built once per thread.
+	 *
+	 * \return	The reader.
+	 */
+	Json::CharReader& GetThreadReader()
+	{
+		thread_local std::unique_ptr<Json::CharReader> reader;
+		if (!reader)
+		{
+			Json::CharReaderBuilder rbuilder;
+			rbuilder["collectComments"] = false;
+
+			reader.reset(rbuilder.newCharReader());
+		}
+		return *reader;
+	}
+}
+
 void Tools::ParseStr2Json(JsonDoc& outJson, const std::string& inStr)
+{
+	ParseStr2Json(outJson, inStr.c_str(), inStr.size());
+}
+
+void Tools::ParseStr2Json(JsonDoc& outJson, const char* inStr)
+{
+	ParseStr2Json(outJson, inStr, std::strlen(inStr));
+}
+
+void Tools::ParseStr2Json(JsonDoc& outJson, const char* inStr, size_t size)
 {
 	bool isValid = false;
 	std::string errStr;
 	try
 	{
-		Json::CharReaderBuilder rbuilder;
-		rbuilder["collectComments"] = false;
-
-		std::unique_ptr<Json::CharReader> reader(rbuilder.newCharReader());
-		isValid = reader->parse(inStr.c_str(), inStr.c_str() + inStr.size(), &outJson, &errStr);
+		isValid = GetThreadReader().parse(inStr, inStr + size, &outJson, &errStr);
 	}
-	catch (const std::bad_alloc)
+	catch (const std::bad_alloc&)
 	{ //We run out of space, there is nothing we can do...
 		throw;
 	}
@@ -42,35 +70,25 @@ void Tools::ParseStr2Json(JsonDoc& outJson, const std::string& inStr)
 	}
 }
 
-void Tools::ParseStr2Json(JsonDoc& outJson, const char* inStr)
+void Tools::ParseStr2JsonInsitu(JsonDoc& outJson, std::string& inStr)
 {
-	bool isValid = false;
-	std::string errStr;
-	try
-	{
-		Json::CharReaderBuilder rbuilder;
-		rbuilder["collectComments"] = false;
-
-		std::unique_ptr<Json::CharReader> reader(rbuilder.newCharReader());
+	//JsonCpp always copies strings into the document.
+	ParseStr2Json(outJson, inStr.c_str(), inStr.size());
+}
 
-		isValid = reader->parse(inStr, inStr + std::strlen(inStr), &outJson, &errStr);
-	}
-	catch (const std::bad_alloc)
+JsonStrView Tools::JsonAsStrView(const JsonValue& val)
+{
+	const char* begin = nullptr;
+	const char* end = nullptr;
+	if (!val.isString())
 	{
-		throw;
+		throw RuntimeException("The JSON value is not a string.");
 	}
-	catch (const std::exception& e)
-	{
-		std::string errStrFinal = "JsonCpp parse error: ";
-		errStrFinal += e.what();
-		throw RuntimeException(errStrFinal);
-
-	}
-	if (!isValid)
-	{
-		std::string errStrFinal = "JsonCpp parse error: " + errStr;
-		throw RuntimeException(errStrFinal);
+	if (!val.getString(&begin, &end))
+	{ //String value without any content.
+		return JsonStrView();
 	}
+	return JsonStrView(begin, static_cast<size_t>(end - begin));
 }
 
 std::string Tools::Json2StyledString(const Json::Value & inJson)
@@ -0,0 +1,176 @@
+#include "UntrustedArena.h"
+
+#include <new>
+#include <mutex>
+#include <vector>
+
+#include "../../Common/make_unique.h"
+#include "../../Common/RuntimeException.h"
+#include "../../Common/Tools/UntrustedArenaLayout.h"
+
+using namespace Decent::Tools;
+
+namespace
+{
+	static constexpr size_t gsk_maxArenaCount = 0xFFFF;
+
+	static std::mutex gs_arenaMutex;
+	//Index i holds the arena with ID i + 1.
+	static std::vector<std::unique_ptr<UntrustedArena> > gs_arenas;
+	static std::vector<UntrustedArena*> gs_freeArenas;
+
+	/** \brief	Holds the arena of a thread, and gives it back for reuse once the thread exits. */
+	class ThreadArenaHolder
+	{
+	public:
+		ThreadArenaHolder() :
+			m_arena(nullptr)
+		{
+			std::unique_lock<std::mutex> arenaLock(gs_arenaMutex);
+
+			if (gs_freeArenas.size() > 0)
+			{
+				m_arena = gs_freeArenas.back();
+				gs_freeArenas.pop_back();
+				return;
+			}
+
+			if (gs_arenas.size() >= gsk_maxArenaCount)
+			{
+				throw Decent::RuntimeException("Too many untrusted arenas are created.");
+			}
+
+			gs_arenas.push_back(Decent::Tools::make_unique<UntrustedArena>(static_cast<uint16_t>(gs_arenas.size() + 1),
+				UntrustedArena::sk_defaultSlotCount, UntrustedArena::sk_defaultSlotSize));
+			m_arena = gs_arenas.back().get();
+		}
+
+		~ThreadArenaHolder()
+		{
+			std::unique_lock<std::mutex> arenaLock(gs_arenaMutex);
+			gs_freeArenas.push_back(m_arena);
+		}
+
+		UntrustedArena& Get() { return *m_arena; }
+
+	private:
+		UntrustedArena* m_arena;
+	};
+
+	static UntrustedArenaSlotHeader& GetHeader(uint8_t* base, size_t slotSize, size_t slot)
+	{
+		return *reinterpret_cast<UntrustedArenaSlotHeader*>(base + (slot * GetUntrustedArenaStride(slotSize)));
+	}
+}
+
+constexpr size_t UntrustedArena::sk_defaultSlotCount;
+constexpr size_t UntrustedArena::sk_defaultSlotSize;
+
+UntrustedArena & UntrustedArena::GetThreadArena()
+{
+	thread_local ThreadArenaHolder holder;
+	return holder.Get();
+}
+
+UntrustedArena * UntrustedArena::Find(uint16_t id) noexcept
+{
+	std::unique_lock<std::mutex> arenaLock(gs_arenaMutex);
+	return (id == 0 || id > gs_arenas.size()) ? nullptr : gs_arenas[id - 1].get();
+}
+
+uint8_t * UntrustedArena::AllocateForEnclave(size_t size, uint64_t & token)
+{
+	uint8_t* res = GetThreadArena().Acquire(size, token);
+	if (res)
+	{
+		return res;
+	}
+
+	token = UntrustedArenaToken::sk_heapBuffer;
+	return new uint8_t[size];
+}
+
+void UntrustedArena::FreeForEnclave(uint8_t * ptr, uint64_t token) noexcept
+{
+	if (token == UntrustedArenaToken::sk_heapBuffer)
+	{
+		delete[] ptr;
+		return;
+	}
+
+	UntrustedArena* arena = Find(UntrustedArenaToken::Unpack(token).m_arenaId);
+	if (arena)
+	{
+		arena->Release(token);
+	}
+}
+
+UntrustedArena::UntrustedArena(uint16_t id, size_t slotCount, size_t slotSize) :
+	m_id(id),
+	m_slotCount(slotCount),
+	m_slotSize(slotSize),
+	m_mem(),
+	m_nextSlot(0)
+{
+	if (m_id == 0 || m_slotCount == 0 || m_slotCount > 0x10000)
+	{
+		throw Decent::RuntimeException("Invalid parameters are given to construct UntrustedArena.");
+	}
+
+	m_mem.reset(new uint8_t[m_slotCount * GetUntrustedArenaStride(m_slotSize)]);
+
+	for (size_t i = 0; i < m_slotCount; ++i)
+	{
+		UntrustedArenaSlotHeader& header = *new (&GetHeader(m_mem.get(), m_slotSize, i)) UntrustedArenaSlotHeader;
+		header.m_generation.store(0);
+		header.m_isOwned.store(0);
+	}
+}
+
+UntrustedArena::~UntrustedArena()
+{
+}
+
+uint8_t * UntrustedArena::Acquire(size_t size, uint64_t & token) noexcept
+{
+	if (size > m_slotSize)
+	{
+		return nullptr;
+	}
+
+	//Only the owner thread acquires slots, so searching in round-robin order needs no lock.
+	for (size_t i = 0; i < m_slotCount; ++i)
+	{
+		const size_t slot = (m_nextSlot + i) % m_slotCount;
+		UntrustedArenaSlotHeader& header = GetHeader(m_mem.get(), m_slotSize, slot);
+
+		if (header.m_isOwned.load(std::memory_order_acquire) == 0)
+		{
+			const uint32_t generation = header.m_generation.load(std::memory_order_relaxed) + 1;
+			header.m_generation.store(generation, std::memory_order_relaxed);
+			header.m_isOwned.store(1, std::memory_order_release);
+
+			m_nextSlot = (slot + 1) % m_slotCount;
+			token = UntrustedArenaToken{ m_id, static_cast<uint16_t>(slot), generation }.Pack();
+
+			return reinterpret_cast<uint8_t*>(&header) + sizeof(UntrustedArenaSlotHeader);
+		}
+	}
+
+	return nullptr;
+}
+
+void UntrustedArena::Release(uint64_t token) noexcept
+{
+	const UntrustedArenaToken tokenVal = UntrustedArenaToken::Unpack(token);
+	if (tokenVal.m_arenaId != m_id || tokenVal.m_slot >= m_slotCount)
+	{
+		return;
+	}
+
+	UntrustedArenaSlotHeader& header = GetHeader(m_mem.get(), m_slotSize, tokenVal.m_slot);
+	if (header.m_generation.load(std::memory_order_relaxed) == tokenVal.m_generation)
+	{
+		header.m_isOwned.store(0, std::memory_order_release);
+	}
+}
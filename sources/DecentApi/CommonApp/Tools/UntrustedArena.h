@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include <memory>
+
+namespace Decent
+{
+	namespace Tools
+	{
+		/**
+		 * \brief	An arena of fixed-size slots in untrusted memory, which is used to hand variable-
+		 * 			length results (e.g., received messages) to the enclave. Each thread has its own
+		 * 			arena, which is registered once with an ID; the enclave looks up the location of
+		 * 			the arena by that ID only once, and then it reads and recycles the slots with the
+		 * 			ownership tokens (see UntrustedArenaToken), without calling back to the untrusted
+		 * 			side to free the buffer. Arenas are never freed, so the location cached by the
+		 * 			enclave stays valid; the arena of an exited thread is reused by a new thread.
+		 */
+		class UntrustedArena
+		{
+		public: //static members:
+			static constexpr size_t sk_defaultSlotCount = 4;
+			static constexpr size_t sk_defaultSlotSize = 16 * 1024;
+
+			/**
+			 * \brief	Gets the arena of the current thread. It's created and registered on the first
+			 * 			call in each thread.
+			 *
+			 * \exception	Decent::RuntimeException	Thrown when there are too many arenas.
+			 *
+			 * \return	The arena.
+			 */
+			static UntrustedArena& GetThreadArena();
+
+			/**
+			 * \brief	Finds the arena with the given ID.
+			 *
+			 * \param	id	The identifier.
+			 *
+			 * \return	Null if it's not found, else the pointer to the arena.
+			 */
+			static UntrustedArena* Find(uint16_t id) noexcept;
+
+			/**
+			 * \brief	Allocates a buffer to be handed to the enclave. It's taken from the arena of the
+			 * 			current thread if there is a free slot big enough, otherwise, it's allocated by
+			 * 			new[] and the token is set to UntrustedArenaToken::sk_heapBuffer.
+			 *
+			 * \param 	   	size 	The size of the buffer.
+			 * \param [out]	token	The ownership token of the buffer.
+			 *
+			 * \return	The pointer to the buffer.
+			 */
+			static uint8_t* AllocateForEnclave(size_t size, uint64_t& token);
+
+			/**
+			 * \brief	Frees a buffer allocated by AllocateForEnclave, which hasn't been handed to the
+			 * 			enclave, e.g., when the operation is failed half way.
+			 *
+			 * \param	ptr  	The pointer to the buffer.
+			 * \param	token	The ownership token of the buffer.
+			 */
+			static void FreeForEnclave(uint8_t* ptr, uint64_t token) noexcept;
+
+		public:
+			UntrustedArena() = delete;
+
+			/**
+			 * \brief	Constructor
+			 *
+			 * \param	id		 	The identifier, which must not be zero.
+			 * \param	slotCount	Number of slots, which must not be greater than 65536.
+			 * \param	slotSize 	Size of each slot.
+			 */
+			UntrustedArena(uint16_t id, size_t slotCount, size_t slotSize);
+
+			UntrustedArena(const UntrustedArena& rhs) = delete;
+
+			UntrustedArena(UntrustedArena&& rhs) = delete;
+
+			virtual ~UntrustedArena();
+
+			/**
+			 * \brief	Acquires a free slot, and marks it as owned by the enclave.
+			 *
+			 * \param 	   	size 	The size needed.
+			 * \param [out]	token	The ownership token of the slot.
+			 *
+			 * \return	Null if the size is too big or there is no free slot, else the pointer to the slot.
+			 */
+			uint8_t* Acquire(size_t size, uint64_t& token) noexcept;
+
+			/**
+			 * \brief	Releases a slot acquired, if the token is still the owner of it.
+			 *
+			 * \param	token	The ownership token of the slot.
+			 */
+			void Release(uint64_t token) noexcept;
+
+			uint16_t GetId() const noexcept { return m_id; }
+
+			uint8_t* GetBase() const noexcept { return m_mem.get(); }
+
+			size_t GetSlotCount() const noexcept { return m_slotCount; }
+
+			size_t GetSlotSize() const noexcept { return m_slotSize; }
+
+		private:
+			const uint16_t m_id;
+			const size_t m_slotCount;
+			const size_t m_slotSize;
+			std::unique_ptr<uint8_t[]> m_mem;
+			size_t m_nextSlot;
+		};
+	}
+}
@@ -8,6 +8,11 @@
 #include <sgx_trts.h>
 #include <sgx_thread.h>
 
+#include <mbedtls/platform_util.h>
+
+#include "../../../Common/Common.h"
+#include "../../../Common/Tools/UtcTime.h"
+
 using namespace Decent;
 
 void MbedTls::mbedtls_mutex_init(mbedtls_threading_mutex_t *mutex)
@@ -69,6 +74,34 @@ int MbedTls::mbedtls_mutex_unlock(mbedtls_threading_mutex_t *mutex)
 	return sgx_thread_mutex_unlock(sgxMutex) == 0 ? 0 : -1;
 }
 
+#ifdef MBEDTLS_PLATFORM_TIME_ALT
+mbedtls_time_t MbedTls::mbedtls_time_func(mbedtls_time_t *timer)
+{
+	time_t res;
+	Tools::GetSystemTime(res);
+
+	if (timer)
+	{
+		*timer = static_cast<mbedtls_time_t>(res);
+	}
+	return static_cast<mbedtls_time_t>(res);
+}
+#endif // MBEDTLS_PLATFORM_TIME_ALT
+
+#if defined(MBEDTLS_HAVE_TIME_DATE) && defined(MBEDTLS_PLATFORM_GMTIME_R_ALT)
+extern "C" struct tm *mbedtls_platform_gmtime_r(const mbedtls_time_t *tt, struct tm *tm_buf)
+{
+	if (!tt || !tm_buf)
+	{
+		return nullptr;
+	}
+
+	const time_t timer = static_cast<time_t>(*tt);
+	Tools::EpochToUtcTime(timer, *tm_buf);
+	return tm_buf;
+}
+#endif // MBEDTLS_HAVE_TIME_DATE && MBEDTLS_PLATFORM_GMTIME_R_ALT
+
 extern "C" int mbedtls_hardware_poll(void *data, unsigned char *output, size_t len, size_t *olen)
 {
 	sgx_status_t enclaveRet = sgx_read_rand(output, len);
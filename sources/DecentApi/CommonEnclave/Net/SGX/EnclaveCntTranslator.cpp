@@ -4,12 +4,14 @@
 
 #include "../../SGX/edl_decent_net.h"
 #include "../../SGX/edl_decent_tools.h"
+#include "../../SGX/SwitchlessOcall.h"
 
 #include "../../Tools/UntrustedBuffer.h"
 
 #include "../EnclaveCntTranslator.h"
 
 using namespace Decent::Net;
+using namespace Decent::Sgx;
 using namespace Decent::Tools;
 
 #define CHECK_SGX_ERROR(X) if (X != SGX_SUCCESS) { throw Decent::Net::Exception("OCall to send message pack failed with SGX error code: " + std::to_string(X)); }
@@ -19,7 +21,9 @@ size_t EnclaveCntTranslator::SendRaw(const void * const dataPtr, const size_t si
 {
 	int sentRes = 0;
 	size_t sentSize = 0;
-	sgx_status_t enclaveRet = ocall_decent_net_cnet_send_raw(&sentRes, &sentSize, m_cntPtr, static_cast<const uint8_t*>(dataPtr), size);
+	sgx_status_t enclaveRet = UseSwitchlessOcall(SwitchlessOcall::NetSend) ?
+		ocall_decent_net_cnet_send_raw_swl(&sentRes, &sentSize, m_cntPtr, static_cast<const uint8_t*>(dataPtr), size) :
+		ocall_decent_net_cnet_send_raw(&sentRes, &sentSize, m_cntPtr, static_cast<const uint8_t*>(dataPtr), size);
 
 	CHECK_SGX_ERROR(enclaveRet);
 	CHECK_OCALL_BOOL_RET(sentRes);
@@ -30,7 +34,9 @@ size_t EnclaveCntTranslator::RecvRaw(void * const bufPtr, const size_t size)
 {
 	int recvRes = 0;
 	size_t recvSize = 0;
-	sgx_status_t enclaveRet = ocall_decent_net_cnet_recv_raw(&recvRes, &recvSize, m_cntPtr, static_cast<uint8_t*>(bufPtr), size);
+	sgx_status_t enclaveRet = UseSwitchlessOcall(SwitchlessOcall::NetRecv) ?
+		ocall_decent_net_cnet_recv_raw_swl(&recvRes, &recvSize, m_cntPtr, static_cast<uint8_t*>(bufPtr), size) :
+		ocall_decent_net_cnet_recv_raw(&recvRes, &recvSize, m_cntPtr, static_cast<uint8_t*>(bufPtr), size);
 
 	CHECK_SGX_ERROR(enclaveRet);
 	CHECK_OCALL_BOOL_RET(recvRes);
@@ -40,7 +46,9 @@ size_t EnclaveCntTranslator::RecvRaw(void * const bufPtr, const size_t size)
 void EnclaveCntTranslator::SendPack(const void * const dataPtr, const size_t size)
 {
 	int sentRes = 0;
-	sgx_status_t enclaveRet = ocall_decent_net_cnet_send_pack(&sentRes, m_cntPtr, static_cast<const uint8_t*>(dataPtr), size);
+	sgx_status_t enclaveRet = UseSwitchlessOcall(SwitchlessOcall::NetSend) ?
+		ocall_decent_net_cnet_send_pack_swl(&sentRes, m_cntPtr, static_cast<const uint8_t*>(dataPtr), size) :
+		ocall_decent_net_cnet_send_pack(&sentRes, m_cntPtr, static_cast<const uint8_t*>(dataPtr), size);
 
 	CHECK_SGX_ERROR(enclaveRet);
 	CHECK_OCALL_BOOL_RET(sentRes);
@@ -51,14 +59,19 @@ size_t EnclaveCntTranslator::RecvPack(uint8_t*& dest)
 	int sentRes = 0;
 	size_t size = 0;
 	uint8_t* bufPtr = nullptr;
+	uint64_t token = 0;
 
-	sgx_status_t enclaveRet = ocall_decent_net_cnet_recv_pack(&sentRes, m_cntPtr, &bufPtr, &size);
+	sgx_status_t enclaveRet = UseSwitchlessOcall(SwitchlessOcall::NetRecv) ?
+		ocall_decent_net_cnet_recv_pack_swl(&sentRes, m_cntPtr, &bufPtr, &size, &token) :
+		ocall_decent_net_cnet_recv_pack(&sentRes, m_cntPtr, &bufPtr, &size, &token);
 	CHECK_SGX_ERROR(enclaveRet);
 	CHECK_OCALL_BOOL_RET(sentRes);
 
+	UntrustedBuffer buf(bufPtr, size, token);
+
 	dest = new uint8_t[size];
 
-	UntrustedBuffer(bufPtr, size).Read(dest, size);
+	buf.Read(dest, size);
 
 	return size;
 }
@@ -68,12 +81,15 @@ std::vector<uint8_t> EnclaveCntTranslator::SendAndRecvPack(const void * const in
 	int retVal = 0;
 	size_t size = 0;
 	uint8_t* bufPtr = nullptr;
+	uint64_t token = 0;
 
-	sgx_status_t enclaveRet = ocall_decent_net_cnet_send_and_recv_pack(&retVal, m_cntPtr, static_cast<const uint8_t*>(inData), inDataLen, &bufPtr, &size);
+	sgx_status_t enclaveRet = UseSwitchlessOcall(SwitchlessOcall::NetRecv) ?
+		ocall_decent_net_cnet_send_and_recv_pack_swl(&retVal, m_cntPtr, static_cast<const uint8_t*>(inData), inDataLen, &bufPtr, &size, &token) :
+		ocall_decent_net_cnet_send_and_recv_pack(&retVal, m_cntPtr, static_cast<const uint8_t*>(inData), inDataLen, &bufPtr, &size, &token);
 	CHECK_SGX_ERROR(enclaveRet);
 	CHECK_OCALL_BOOL_RET(retVal);
 
-	return UntrustedBuffer(bufPtr, size).Read();
+	return UntrustedBuffer(bufPtr, size, token).Read();
 }
 
 void EnclaveCntTranslator::Terminate() noexcept
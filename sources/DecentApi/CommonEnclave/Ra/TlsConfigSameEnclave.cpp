@@ -36,7 +36,7 @@ int TlsConfigSameEnclave::VerifyDecentAppCert(const AppX509Cert & cert, int dept
 	}
 
 	//Check Loaded Lists are equivalent
-	StaticList peerLoadedList(LoadedList::ParseWhiteListFromJson(cert.GetWhiteList()));
+	StaticList peerLoadedList(LoadedList::ParseWhiteList(cert));
 	if (peerLoadedList != GetState().GetLoadedWhiteList())
 	{
 		flag = MBEDTLS_X509_BADCERT_NOT_TRUSTED;
@@ -4,14 +4,35 @@
 #include <stdio.h>      /* vsnprintf */
 
 #include "../../Common/make_unique.h"
+#include "../../Common/SGX/RuntimeError.h"
+#include "../../Common/Tools/UtcTime.h"
 
 #include "edl_decent_tools.h"
+#include "SwitchlessOcall.h"
 
 using namespace Decent;
 
 namespace
 {
 	static constexpr size_t PRINT_BUFFER_SIZE = 20 * BUFSIZ;
+
+	void GetUntrustedSystemTime(time_t& timer)
+	{
+		sgx_status_t sgxRet = SGX_SUCCESS;
+		if (Sgx::UseSwitchlessOcall(Sgx::SwitchlessOcall::Time))
+		{
+			sgxRet = ocall_decent_tools_get_sys_time_swl(&timer);
+		}
+		else
+		{
+			sgxRet = ocall_decent_tools_get_sys_time(&timer);
+		}
+
+		if (sgxRet != SGX_SUCCESS)
+		{
+			throw Sgx::RuntimeError(sgxRet, "ocall_decent_tools_get_sys_time");
+		}
+	}
 }
 
 void Tools::Printf(const char * fmt, ...)
@@ -21,7 +42,14 @@ void Tools::Printf(const char * fmt, ...)
 	va_start(ap, fmt);
 	vsnprintf(buf, PRINT_BUFFER_SIZE, fmt, ap);
 	va_end(ap);
-	ocall_decent_tools_print_string(buf);
+	if (Sgx::UseSwitchlessOcall(Sgx::SwitchlessOcall::Print))
+	{
+		ocall_decent_tools_print_string_swl(buf);
+	}
+	else
+	{
+		ocall_decent_tools_print_string(buf);
+	}
 }
 
 void Tools::LogInfo(const char* fmt, ...)
@@ -41,7 +69,14 @@ void Tools::LogInfo(const char* fmt, ...)
 	va_start(ap, fmt);
 	vsnprintf(buf, PRINT_BUFFER_SIZE, resFmt.get(), ap);
 	va_end(ap);
-	ocall_decent_tools_print_string_i(buf);
+	if (Sgx::UseSwitchlessOcall(Sgx::SwitchlessOcall::Print))
+	{
+		ocall_decent_tools_print_string_i_swl(buf);
+	}
+	else
+	{
+		ocall_decent_tools_print_string_i(buf);
+	}
 }
 
 void Tools::LogWarning(const char* file, int line, const char* fmt, ...)
@@ -61,17 +96,24 @@ void Tools::LogWarning(const char* file, int line, const char* fmt, ...)
 	va_start(ap, fmt);
 	vsnprintf(buf, PRINT_BUFFER_SIZE, resFmt.get(), ap);
 	va_end(ap);
-	ocall_decent_tools_print_string_w(buf);
+	if (Sgx::UseSwitchlessOcall(Sgx::SwitchlessOcall::Print))
+	{
+		ocall_decent_tools_print_string_w_swl(buf);
+	}
+	else
+	{
+		ocall_decent_tools_print_string_w(buf);
+	}
 }
 
 void Tools::GetSystemTime(time_t & timer)
 {
-	ocall_decent_tools_get_sys_time(&timer);
+	GetUntrustedSystemTime(timer);
 }
 
 void Tools::GetSystemUtcTime(const time_t& timer, struct tm& outTime)
 {
-	ocall_decent_tools_get_sys_utc_time(&timer, &outTime);
+	EpochToUtcTime(timer, outTime);
 }
 
 #ifdef __GNUC__
@@ -4,19 +4,35 @@
 
 #include "../../Common/Common.h"
 #include "../../Common/make_unique.h"
+#include "../../Common/consttime_memequal.h"
+#include "../../Common/Net/RpcWriter.h"
+#include "../../Common/Net/RpcParser.h"
 #include "../../Common/Net/ConnectionBase.h"
 #include "../../Common/Net/NetworkException.h"
 #include "../../Common/MbedTls/Kdf.h"
+#include "../../Common/MbedTls/Drbg.h"
+#include "../../Common/MbedTls/Hasher.h"
+#include "../../Common/MbedTls/TlsPrf.h"
 
 using namespace Decent;
 using namespace Decent::Sgx;
 using namespace Decent::Net;
+using namespace Decent::MbedTlsObj;
 
 #define CHECK_SGX_SDK_RESULT(X, MSG) if((X) != SGX_SUCCESS) { throw Decent::Net::Exception("Local Attestation failed: " MSG); }
 #define ASSERT_BOOL_RESULT(X, MSG) if(!(X)) { throw Decent::Net::Exception("Local Attestation failed: " MSG); }
 
 namespace
 {
+	static constexpr uint8_t gsk_hasTicket = 1;
+	static constexpr uint8_t gsk_noTicket = 0;
+
+	static constexpr uint8_t gsk_resumeSucc = 1;
+	static constexpr uint8_t gsk_resumeFail = 0;
+
+	static constexpr char const gsk_keyDerLabel[] = "new_session_keys";
+	static constexpr char const gsk_finishLabel[] = "finished";
+	static constexpr size_t gsk_defPrfResSize = 12;
 	template<typename T>
 	static inline T* CastPtr(void* ptr)
 	{
@@ -37,6 +53,28 @@ namespace
 		CKDF<CipherType::AES, GENERAL_128BIT_16BYTE_SIZE, CipherMode::ECB>(aeKey, label, sk);
 		return sk;
 	}
+
+	std::shared_ptr<const LocAttResumeSession> MakeResumeSession(const LocAttSession& session)
+	{
+		std::shared_ptr<LocAttResumeSession> res = std::make_shared<LocAttResumeSession>();
+
+		G128BitSecretKeyWrap ticket = DeriveSubKeys(session.m_aek, "RT");
+		res->m_ticket = ticket.m_key;
+		res->m_secret = DeriveSubKeys(session.m_aek, "RS");
+		res->m_id = Decent::Tools::make_unique<sgx_dh_session_enclave_identity_t>(*session.m_id);
+
+		return std::move(res);
+	}
+
+	std::unique_ptr<LocAttSession> MakeResumedSession(const LocAttResumeSession& saved, const std::array<uint64_t, 2>& nonces)
+	{
+		std::unique_ptr<LocAttSession> res = Decent::Tools::make_unique<LocAttSession>();
+
+		HKDF<HashType::SHA256>(saved.m_secret.m_key, gsk_keyDerLabel, nonces, res->m_aek.m_key);
+		res->m_id = Decent::Tools::make_unique<sgx_dh_session_enclave_identity_t>(*saved.m_id);
+
+		return std::move(res);
+	}
 }
 
 LocAttCommLayer::LocAttCommLayer(ConnectionBase& cnt, bool isInitiator) :
@@ -44,9 +82,20 @@ LocAttCommLayer::LocAttCommLayer(ConnectionBase& cnt, bool isInitiator) :
 {
 }
 
+LocAttCommLayer::LocAttCommLayer(ConnectionBase& cnt, LocAttInitiatorCache& cache, const std::string& peerKey) :
+	LocAttCommLayer(InitiatorHandshake(cnt, cache, peerKey), cnt)
+{
+}
+
+LocAttCommLayer::LocAttCommLayer(ConnectionBase& cnt, LocAttResponderCache& cache) :
+	LocAttCommLayer(ResponderHandshake(cnt, cache), cnt)
+{
+}
+
 LocAttCommLayer::LocAttCommLayer(LocAttCommLayer && other) :
 	AesGcmCommLayer(std::forward<AesGcmCommLayer>(other)),
-	m_session(std::move(other.m_session))
+	m_session(std::move(other.m_session)),
+	m_isResumed(other.m_isResumed)
 {
 }
 
@@ -66,8 +115,15 @@ const sgx_dh_session_enclave_identity_t& LocAttCommLayer::GetIdentity() const
 
 LocAttCommLayer::LocAttCommLayer(std::unique_ptr<LocAttSession> session, Net::ConnectionBase& cnt) :
 	AesGcmCommLayer(DeriveSubKeys(session->m_aek, "SK"), DeriveSubKeys(session->m_aek, "MK"), &cnt),
-	m_session(std::move(session))
+	m_session(std::move(session)),
+	m_isResumed(false)
+{
+}
+
+LocAttCommLayer::LocAttCommLayer(std::pair<std::unique_ptr<LocAttSession>, bool> session, Net::ConnectionBase& cnt) :
+	LocAttCommLayer(std::move(session.first), cnt)
 {
+	m_isResumed = session.second;
 }
 
 std::unique_ptr<LocAttSession> LocAttCommLayer::InitiatorHandshake(ConnectionBase& cnt)
@@ -145,3 +201,175 @@ std::unique_ptr<LocAttSession> LocAttCommLayer::Handshake(ConnectionBase& cnt, b
 		return ResponderHandshake(cnt);
 	}
 }
+
+// Initiator steps:
+//     If there is no saved session:
+//         1. ---> Send "NoTicket" RPC ("NoTicket")
+//         FALL BACK to local attestation...
+//     Else:
+//         1. ---> Send "HasTicket" RPC ("HasTicket" || Ticket || Nonce)
+//         2. <--- Recv RPC from responder ("Accepted" || responder_nonce || TLS-PRF(key=secret, gsk_finishLabel, Hash(HasTicket_RPC))) OR ("NotAccepted")
+//         If not accepted:
+//             FALL BACK to local attestation...
+//         Else:
+//             3. Verify the responder's verification message.
+//             4. ---> Send verification message, TLS-PRF(key=secret, gsk_finishLabel, Hash(RPC_from_responder))
+//             5. Derive new AEK: new_aek = HKDF(secret, label="new_session_keys", salt=(Nonce || responder_nonce))
+//     After local attestation, both sides derive the ticket and the secret from the AEK, and save them.
+std::pair<std::unique_ptr<LocAttSession>, bool> LocAttCommLayer::InitiatorHandshake(ConnectionBase& cnt, LocAttInitiatorCache& cache, const std::string& peerKey)
+{
+	std::shared_ptr<const LocAttResumeSession> savedSession = cache.Get(peerKey);
+
+	if (!savedSession)
+	{
+		RpcWriter rpcResuTicket(RpcWriter::CalcSizePrim<uint8_t>(), 1);
+		rpcResuTicket.AddPrimitiveArg<uint8_t>() = gsk_noTicket;
+		cnt.SendRpc(rpcResuTicket);
+	}
+	else
+	{
+		std::array<uint64_t, 2> nonces;
+		uint64_t& selfNonce = nonces[0]; //Initiator nonce is at first position
+		uint64_t& peerNonce = nonces[1]; //Responder nonce is at second position
+		General256Hash selfMsgHash;
+		General256Hash peerMsgHash;
+
+		Drbg drbg;
+		drbg.RandStruct(selfNonce);
+
+		{
+			RpcWriter rpcResuTicket(RpcWriter::CalcSizePrim<uint8_t>() +
+				RpcWriter::CalcSizeBin(savedSession->m_ticket.size()) +
+				RpcWriter::CalcSizePrim<uint64_t>(),
+				3, false);
+
+			rpcResuTicket.AddPrimitiveArg<uint8_t>() = gsk_hasTicket;
+			rpcResuTicket.AddBinaryArg(savedSession->m_ticket.size()).Set(savedSession->m_ticket);
+			rpcResuTicket.AddPrimitiveArg<uint64_t>() = selfNonce;
+
+			cnt.SendRpc(rpcResuTicket);
+
+			Hasher<HashType::SHA256>().Calc(selfMsgHash, rpcResuTicket.GetFullBinary());
+		}
+
+		RpcParser rpcResuRes(cnt.RecvContainer<std::vector<uint8_t> >());
+		Hasher<HashType::SHA256>().Calc(peerMsgHash, rpcResuRes.GetFullBinary());
+
+		if (rpcResuRes.GetPrimitiveArg<uint8_t>())
+		{
+			peerNonce = rpcResuRes.GetPrimitiveArg<uint64_t>();
+			auto peerVrfyMsg = rpcResuRes.GetBinaryArg();
+
+			std::array<uint8_t, gsk_defPrfResSize> selfPrfRes;
+			TlsPrf<HashType::SHA256>(savedSession->m_secret, gsk_finishLabel, selfMsgHash, selfPrfRes);
+
+			if (static_cast<size_t>(peerVrfyMsg.second - peerVrfyMsg.first) != selfPrfRes.size() ||
+				!consttime_memequal(&(*peerVrfyMsg.first), selfPrfRes.data(), selfPrfRes.size()))
+			{
+				// At this step, we don't fall back to local attestation.
+				cache.Remove(peerKey);
+				throw Decent::Net::Exception("Failed to verify session resume message from responder.");
+			}
+
+			std::array<uint8_t, gsk_defPrfResSize> peerPrfRes;
+			TlsPrf<HashType::SHA256>(savedSession->m_secret, gsk_finishLabel, peerMsgHash, peerPrfRes);
+			cnt.SendContainer(peerPrfRes);
+
+			return std::make_pair(MakeResumedSession(*savedSession, nonces), true);
+		}
+
+		// The responder doesn't have the session anymore.
+		cache.Remove(peerKey);
+	}
+
+	std::unique_ptr<LocAttSession> session = InitiatorHandshake(cnt);
+	cache.Put(peerKey, MakeResumeSession(*session));
+
+	return std::make_pair(std::move(session), false);
+}
+
+// Responder steps:
+//     1. <--- Recv initiator RPC, ("HasTicket" || Ticket || Nonce) OR ("NoTicket")
+//     If no ticket:
+//         FALL BACK to local attestation...
+//     Else if the ticket is not found in the cache:
+//         2. ---> Send "NotAccepted" RPC, ("NotAccepted")
+//         FALL BACK to local attestation...
+//     Else:
+//         2. ---> Send "Accepted" RPC, ("Accepted" || Nonce || TLS-PRF(key=secret, gsk_finishLabel, Hash(RPC_from_initiator)))
+//         3. <--- Recv verification message, TLS-PRF(key=secret, gsk_finishLabel, Hash(Accepted_RPC))
+//         4. Derive new AEK: new_aek = HKDF(secret, label="new_session_keys", salt=(initiator_nonce || Nonce))
+std::pair<std::unique_ptr<LocAttSession>, bool> LocAttCommLayer::ResponderHandshake(ConnectionBase& cnt, LocAttResponderCache& cache)
+{
+	RpcParser rpcResuTicket(cnt.RecvContainer<std::vector<uint8_t> >());
+
+	if (rpcResuTicket.GetPrimitiveArg<uint8_t>())
+	{
+		std::array<uint64_t, 2> nonces;
+		uint64_t& peerNonce = nonces[0]; //Initiator nonce is at first position
+		uint64_t& selfNonce = nonces[1]; //Responder nonce is at second position
+		General256Hash selfMsgHash;
+		General256Hash peerMsgHash;
+
+		Hasher<HashType::SHA256>().Calc(peerMsgHash, rpcResuTicket.GetFullBinary());
+
+		General128BitBinary ticket;
+		auto ticketSpace = rpcResuTicket.GetBinaryArg();
+		peerNonce = rpcResuTicket.GetPrimitiveArg<uint64_t>();
+
+		std::shared_ptr<const LocAttResumeSession> savedSession;
+		if (static_cast<size_t>(ticketSpace.second - ticketSpace.first) == ticket.size())
+		{
+			std::copy(ticketSpace.first, ticketSpace.second, ticket.begin());
+			savedSession = cache.Get(ticket);
+		}
+
+		if (!savedSession)
+		{
+			RpcWriter rpcFailedResu(RpcWriter::CalcSizePrim<uint8_t>(), 1);
+			rpcFailedResu.AddPrimitiveArg<uint8_t>() = gsk_resumeFail;
+			cnt.SendRpc(rpcFailedResu);
+		}
+		else
+		{
+			Drbg drbg;
+			drbg.RandStruct(selfNonce);
+
+			{
+				std::array<uint8_t, gsk_defPrfResSize> peerPrfRes;
+				TlsPrf<HashType::SHA256>(savedSession->m_secret, gsk_finishLabel, peerMsgHash, peerPrfRes);
+
+				RpcWriter rpcSuccResu(RpcWriter::CalcSizePrim<uint8_t>() +
+					RpcWriter::CalcSizePrim<uint64_t>() +
+					RpcWriter::CalcSizeBin(peerPrfRes.size()), 3, false);
+
+				rpcSuccResu.AddPrimitiveArg<uint8_t>() = gsk_resumeSucc;
+				rpcSuccResu.AddPrimitiveArg<uint64_t>() = selfNonce;
+				rpcSuccResu.AddBinaryArg(peerPrfRes.size()).Set(peerPrfRes);
+				cnt.SendRpc(rpcSuccResu);
+
+				Hasher<HashType::SHA256>().Calc(selfMsgHash, rpcSuccResu.GetFullBinary());
+			}
+
+			std::array<uint8_t, gsk_defPrfResSize> selfPrfRes;
+			TlsPrf<HashType::SHA256>(savedSession->m_secret, gsk_finishLabel, selfMsgHash, selfPrfRes);
+
+			std::vector<uint8_t> peerVrfyMsg = cnt.RecvContainer<std::vector<uint8_t> >();
+
+			if (peerVrfyMsg.size() != selfPrfRes.size() ||
+				!consttime_memequal(peerVrfyMsg.data(), selfPrfRes.data(), selfPrfRes.size()))
+			{
+				// At this step, we don't fall back to local attestation.
+				throw Decent::Net::Exception("Failed to verify session resume message from initiator.");
+			}
+
+			return std::make_pair(MakeResumedSession(*savedSession, nonces), true);
+		}
+	}
+
+	std::unique_ptr<LocAttSession> session = ResponderHandshake(cnt);
+	std::shared_ptr<const LocAttResumeSession> resumeSession = MakeResumeSession(*session);
+	cache.Put(resumeSession->m_ticket, resumeSession);
+
+	return std::make_pair(std::move(session), false);
+}
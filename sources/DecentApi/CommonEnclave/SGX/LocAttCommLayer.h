@@ -1,9 +1,11 @@
 #pragma once
 
+#include <string>
 #include <utility>
 #include <memory>
 
 #include "../../Common/Net/AesGcmCommLayer.h"
+#include "../../Common/Net/SessionResumptionCache.h"
 
 typedef struct _sgx_dh_session_enclave_identity_t sgx_dh_session_enclave_identity_t;
 
@@ -18,6 +20,26 @@ namespace Decent
 			std::unique_ptr<sgx_dh_session_enclave_identity_t> m_id;
 		};
 
+		/**
+		 * \brief	The secret kept by both sides after a successful local attestation, so that later
+		 * 			connections to the same peer can be resumed without another DH key exchange. Both
+		 * 			the ticket and the secret are derived from the AEK of the original session, thus, no
+		 * 			extra message is needed to set them up.
+		 */
+		struct LocAttResumeSession
+		{
+			General128BitBinary m_ticket;
+			G128BitSecretKeyWrap m_secret;
+
+			std::unique_ptr<sgx_dh_session_enclave_identity_t> m_id;
+		};
+
+		/** \brief	Resumable sessions kept by the initiator, keyed by a name of the peer chosen by the caller. */
+		typedef Net::SessionResumptionCache<std::string, LocAttResumeSession> LocAttInitiatorCache;
+
+		/** \brief	Resumable sessions kept by the responder, keyed by the ticket. */
+		typedef Net::SessionResumptionCache<General128BitBinary, LocAttResumeSession> LocAttResponderCache;
+
 		class LocAttCommLayer : public Decent::Net::AesGcmCommLayer
 		{
 		public:
@@ -34,6 +56,38 @@ namespace Decent
 			 */
 			LocAttCommLayer(Decent::Net::ConnectionBase& cnt, bool isInitiator);
 
+			/**
+			 * \brief	Constructor for the initiator side, which tries to resume the session saved in the
+			 * 			cache first, and falls back to the local attestation if there is no saved session
+			 * 			or the peer doesn't accept it. The peer must be constructed with the responder
+			 * 			cache as well, since the messages are different from the ones of the constructor
+			 * 			above. Note: resumed sessions don't have forward secrecy with respect to the
+			 * 			resumption secret.
+			 *
+			 * \exception	Decent::RuntimeException	This is thrown if the connection fails, received
+			 * message has invalid length, the SGX SDK failed to process the message, or the peer failed
+			 * the verification of the resumption.
+			 *
+			 * \param [in,out]	cnt    	The connection to the peer.
+			 * \param [in,out]	cache  	The cache of resumable sessions.
+			 * \param 		  	peerKey	The name of the peer used as the key in the cache.
+			 */
+			LocAttCommLayer(Decent::Net::ConnectionBase& cnt, LocAttInitiatorCache& cache, const std::string& peerKey);
+
+			/**
+			 * \brief	Constructor for the responder side, which resumes the session if the initiator
+			 * 			gives a ticket found in the cache, or falls back to the local attestation
+			 * 			otherwise.
+			 *
+			 * \exception	Decent::RuntimeException	This is thrown if the connection fails, received
+			 * message has invalid length, the SGX SDK failed to process the message, or the peer failed
+			 * the verification of the resumption.
+			 *
+			 * \param [in,out]	cnt  	The connection to the peer.
+			 * \param [in,out]	cache	The cache of resumable sessions.
+			 */
+			LocAttCommLayer(Decent::Net::ConnectionBase& cnt, LocAttResponderCache& cache);
+
 			LocAttCommLayer(const LocAttCommLayer& other) = delete;
 
 			/**
@@ -61,6 +115,14 @@ namespace Decent
 			 */
 			const sgx_dh_session_enclave_identity_t& GetIdentity() const;
 
+			/**
+			 * \brief	Query if this session is resumed from a cached session, rather than a new local
+			 * 			attestation.
+			 *
+			 * \return	True if resumed, false if not.
+			 */
+			bool IsResumed() const noexcept { return m_isResumed; }
+
 		private:
 
 			/**
@@ -71,6 +133,14 @@ namespace Decent
 			 */
 			LocAttCommLayer(std::unique_ptr<LocAttSession> session, Net::ConnectionBase& cnt);
 
+			/**
+			 * \brief	Constructor that accept the result of the handshake with resumption.
+			 *
+			 * \param 		  	session	The LA session, and whether or not it's resumed.
+			 * \param [in,out]	cnt	   	Network connection.
+			 */
+			LocAttCommLayer(std::pair<std::unique_ptr<LocAttSession>, bool> session, Net::ConnectionBase& cnt);
+
 			/**
 			 * \brief	Perform the handshakes procedure (i.e. local attestation).
 			 *
@@ -99,7 +169,29 @@ namespace Decent
 			 */
 			static std::unique_ptr<LocAttSession> ResponderHandshake(Decent::Net::ConnectionBase& cnt);
 
+			/**
+			 * \brief	Perform the handshakes procedure with resumption in initiator side.
+			 *
+			 * \param [in,out]	cnt    	The connection to the peer.
+			 * \param [in,out]	cache  	The cache of resumable sessions.
+			 * \param 		  	peerKey	The name of the peer used as the key in the cache.
+			 *
+			 * \return	The LA session, and whether or not it's resumed.
+			 */
+			static std::pair<std::unique_ptr<LocAttSession>, bool> InitiatorHandshake(Decent::Net::ConnectionBase& cnt, LocAttInitiatorCache& cache, const std::string& peerKey);
+
+			/**
+			 * \brief	Perform the handshakes procedure with resumption in responder side.
+			 *
+			 * \param [in,out]	cnt  	The connection to the peer.
+			 * \param [in,out]	cache	The cache of resumable sessions.
+			 *
+			 * \return	The LA session, and whether or not it's resumed.
+			 */
+			static std::pair<std::unique_ptr<LocAttSession>, bool> ResponderHandshake(Decent::Net::ConnectionBase& cnt, LocAttResponderCache& cache);
+
 			std::unique_ptr<LocAttSession> m_session;
+			bool m_isResumed;
 		};
 	}
 }
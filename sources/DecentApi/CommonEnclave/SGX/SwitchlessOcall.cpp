@@ -0,0 +1,33 @@
+#include "SwitchlessOcall.h"
+
+#include <sgx_trts.h>
+
+#include "edl_decent_tools.h"
+
+using namespace Decent::Sgx;
+
+namespace
+{
+	static const volatile uint8_t* FetchSwitchlessHints() noexcept
+	{
+		int retVal = false;
+		uint8_t* hints = nullptr;
+		size_t count = 0;
+		if (ocall_decent_tools_get_swl_hints(&retVal, &hints, &count) != SGX_SUCCESS ||
+			!retVal || !hints || count < gsk_switchlessOcallCount ||
+			!sgx_is_outside_enclave(hints, gsk_switchlessOcallCount))
+		{
+			return nullptr;
+		}
+
+		return hints;
+	}
+}
+
+bool Decent::Sgx::UseSwitchlessOcall(SwitchlessOcall type) noexcept
+{
+	static const volatile uint8_t* const hints = FetchSwitchlessHints();
+
+	const size_t idx = static_cast<size_t>(type);
+	return hints && idx < gsk_switchlessOcallCount && hints[idx] != 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "../../Common/SGX/SwitchlessOcall.h"
+
+namespace Decent
+{
+	namespace Sgx
+	{
+		/**
+		 * \brief	Query if the switchless variant of a group of OCALLs should be used now. The decision
+		 * 			is made by the untrusted side (see CommonApp/SGX/SwitchlessMonitor.h), and it's read
+		 * 			from the untrusted memory without leaving the enclave; the location of the hints is
+		 * 			fetched only once. Since it only affects the performance, the untrusted side is
+		 * 			trusted with it. If the hints are not available, the regular variant is used.
+		 *
+		 * \param	type	The group of OCALLs.
+		 *
+		 * \return	True if the switchless variant should be used, false if not.
+		 */
+		bool UseSwitchlessOcall(SwitchlessOcall type) noexcept;
+	}
+}
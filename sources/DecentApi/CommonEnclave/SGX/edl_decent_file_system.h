@@ -15,6 +15,9 @@ extern "C" {
 	sgx_status_t SGX_CDECL ocall_decent_tools_ftell(size_t* retval, void* file);
 	sgx_status_t SGX_CDECL ocall_decent_tools_fread(size_t* retval, void* buffer, size_t buffer_size, void* file);
 	sgx_status_t SGX_CDECL ocall_decent_tools_fwrite(size_t* retval, const void* buffer, size_t buffer_size, void* file);
+	sgx_status_t SGX_CDECL ocall_decent_tools_fsize(size_t* retval, void* file);
+	sgx_status_t SGX_CDECL ocall_decent_tools_fread_at(size_t* retval, void* buffer, size_t buffer_size, void* file, int64_t offset);
+	sgx_status_t SGX_CDECL ocall_decent_tools_fwrite_at(size_t* retval, const void* buffer, size_t buffer_size, void* file, int64_t offset);
 
 #ifdef __cplusplus
 }
@@ -11,7 +11,7 @@ extern "C" {
 
 	sgx_status_t SGX_CDECL ocall_decent_sgx_ra_get_msg0s(int* retval, void* connection_ptr);
 	sgx_status_t SGX_CDECL ocall_decent_sgx_ra_get_msg1(int* retval, uint64_t enclave_id, uint32_t ra_ctx, sgx_ra_msg1_t* msg1);
-	sgx_status_t SGX_CDECL ocall_decent_sgx_ra_proc_msg2(size_t* retval, uint64_t enclave_id, uint32_t ra_ctx, const sgx_ra_msg2_t* msg2, size_t msg2_size, uint8_t** out_msg3);
+	sgx_status_t SGX_CDECL ocall_decent_sgx_ra_proc_msg2(size_t* retval, uint64_t enclave_id, uint32_t ra_ctx, const sgx_ra_msg2_t* msg2, size_t msg2_size, uint8_t** out_msg3, uint64_t* out_token);
 
 #ifdef __cplusplus
 }
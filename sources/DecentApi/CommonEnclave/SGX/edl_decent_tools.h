@@ -13,10 +13,19 @@ extern "C" {
 	sgx_status_t SGX_CDECL ocall_decent_tools_print_string(const char* str);
 	sgx_status_t SGX_CDECL ocall_decent_tools_print_string_i(const char* str);
 	sgx_status_t SGX_CDECL ocall_decent_tools_print_string_w(const char* str);
+	sgx_status_t SGX_CDECL ocall_decent_tools_new_buf_uint8(uint8_t** retval, size_t size);
 	sgx_status_t SGX_CDECL ocall_decent_tools_del_buf_char(char* ptr);
 	sgx_status_t SGX_CDECL ocall_decent_tools_del_buf_uint8(uint8_t* ptr);
+	sgx_status_t SGX_CDECL ocall_decent_tools_get_arena_info(int* retval, uint16_t arena_id, uint8_t** base, size_t* slot_count, size_t* slot_size);
+	sgx_status_t SGX_CDECL ocall_decent_tools_free_arena_slot(uint64_t token);
 	sgx_status_t SGX_CDECL ocall_decent_tools_get_sys_time(time_t* timer);
 	sgx_status_t SGX_CDECL ocall_decent_tools_get_sys_utc_time(const time_t* timer, struct tm* out_time);
+	sgx_status_t SGX_CDECL ocall_decent_tools_get_swl_hints(int* retval, uint8_t** hints, size_t* count);
+
+	sgx_status_t SGX_CDECL ocall_decent_tools_print_string_swl(const char* str);
+	sgx_status_t SGX_CDECL ocall_decent_tools_print_string_i_swl(const char* str);
+	sgx_status_t SGX_CDECL ocall_decent_tools_print_string_w_swl(const char* str);
+	sgx_status_t SGX_CDECL ocall_decent_tools_get_sys_time_swl(time_t* timer);
 
 #ifdef __cplusplus
 }
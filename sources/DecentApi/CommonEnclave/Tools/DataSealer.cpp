@@ -0,0 +1,110 @@
+#include "DataSealer.h"
+
+#include "../../Common/make_unique.h"
+#include "../../Common/Tools/CachingQueue.h"
+#include "../../Common/Ra/States.h"
+#include "../../Common/Ra/WhiteList/LoadedList.h"
+
+using namespace Decent;
+using namespace Decent::Tools;
+using namespace Decent::Tools::DataSealer;
+
+namespace
+{
+	constexpr size_t gsk_sealCtxCacheSize = 16;
+	constexpr size_t gsk_unsealCtxCacheSize = 64;
+
+	/** \brief	A seal key that has been derived, together with its key metadata. */
+	struct SealContext
+	{
+		SealContext(std::vector<uint8_t>&& keyMeta, GcmPacker&& packer) :
+			m_keyMeta(std::forward<std::vector<uint8_t> >(keyMeta)),
+			m_packer(std::forward<GcmPacker>(packer)),
+			m_sealCount(0)
+		{}
+
+		std::vector<uint8_t> m_keyMeta;
+		GcmPacker m_packer;
+		uint64_t m_sealCount;
+	};
+
+	//Each item is taken by one thread at a time, and then put back, thus, contexts are never shared.
+	Tools::CachingQueue<std::string, SealContext>& GetSealCtxCache()
+	{
+		static Tools::CachingQueue<std::string, SealContext> inst(gsk_sealCtxCacheSize);
+		return inst;
+	}
+
+	Tools::CachingQueue<std::string, GcmPacker>& GetUnsealCtxCache()
+	{
+		static Tools::CachingQueue<std::string, GcmPacker> inst(gsk_unsealCtxCacheSize);
+		return inst;
+	}
+
+	/**
+	 * \brief	Constructs the cache key from all the inputs of the seal key derivation (except the
+	 * 			root seal key, which is determined by the key metadata).
+	 */
+	std::string ConstructCacheKey(KeyPolicy keyPolicy, const Ra::States& decentState, const std::string& keyLabel,
+		const void* keyMeta, const size_t keyMetaSize)
+	{
+		std::string res(1, static_cast<char>(keyPolicy));
+		res += decentState.GetLoadedWhiteList().GetWhiteListHash();
+		res.push_back('\0');
+		res += keyLabel;
+		res.push_back('\0');
+		res.append(static_cast<const char*>(keyMeta), keyMetaSize);
+		return res;
+	}
+
+	GcmPacker DeriveSealPacker(KeyPolicy keyPolicy, const Ra::States& decentState, const std::string& keyLabel,
+		const std::vector<uint8_t>& keyMeta)
+	{
+		G128BitSecretKeyWrap sealKey;
+		DeriveSealKey(keyPolicy, decentState, keyLabel, sealKey.m_key, keyMeta, std::vector<uint8_t>());
+
+		return GcmPacker(sealKey.m_key);
+	}
+}
+
+std::vector<uint8_t> DataSealer::detail::SealData(KeyPolicy keyPolicy, const Ra::States& decentState, const std::string& keyLabel,
+	const void* inMeta, const size_t inMetaSize, const void* inData, const size_t inDataSize,
+	General128Tag* outTag, const size_t sealedBlockSize)
+{
+	const std::string cacheKey = ConstructCacheKey(keyPolicy, decentState, keyLabel, nullptr, 0);
+
+	std::unique_ptr<SealContext> ctx = GetSealCtxCache().Get(cacheKey);
+	if (!ctx || ctx->m_sealCount >= sk_maxSealCountPerKey)
+	{
+		std::vector<uint8_t> keyMeta = GenSealKeyRecoverMeta(false);
+		GcmPacker packer = DeriveSealPacker(keyPolicy, decentState, keyLabel, keyMeta);
+		ctx = Tools::make_unique<SealContext>(std::move(keyMeta), std::move(packer));
+	}
+
+	std::vector<uint8_t> res = ctx->m_packer.Pack(ctx->m_keyMeta.data(), ctx->m_keyMeta.size(),
+		inMeta, inMetaSize, inData, inDataSize, nullptr, 0, outTag, sealedBlockSize);
+	++(ctx->m_sealCount);
+
+	GetSealCtxCache().Put(cacheKey, std::move(ctx));
+
+	return res;
+}
+
+void DataSealer::detail::UnsealData(KeyPolicy keyPolicy, const Ra::States& decentState, const std::string& keyLabel,
+	const void* inData, const size_t inDataSize, std::vector<uint8_t>& outMeta, std::vector<uint8_t>& outData,
+	const General128Tag* inTag, const size_t sealedBlockSize)
+{
+	const std::vector<uint8_t> keyMeta = Tools::detail::GetKeyMetaFromPack(inData, inDataSize);
+	const std::string cacheKey = ConstructCacheKey(keyPolicy, decentState, keyLabel, keyMeta.data(), keyMeta.size());
+
+	std::unique_ptr<GcmPacker> packer = GetUnsealCtxCache().Get(cacheKey);
+	if (!packer)
+	{
+		packer = Tools::make_unique<GcmPacker>(DeriveSealPacker(keyPolicy, decentState, keyLabel, keyMeta));
+	}
+
+	//The packer is only put back when the data is successfully unsealed.
+	packer->Unpack(inData, inDataSize, nullptr, 0, outMeta, outData, inTag, sealedBlockSize);
+
+	GetUnsealCtxCache().Put(cacheKey, std::move(packer));
+}
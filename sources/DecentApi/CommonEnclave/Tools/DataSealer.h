@@ -31,8 +31,24 @@ namespace Decent
 			{
 				void DeriveSealKey(KeyPolicy keyPolicy, const Ra::States& decentState, const std::string& label, 
 					void* outKey, const size_t expectedKeySize, const void* inMeta, const size_t inMetaSize, const std::vector<uint8_t>& salt);
+
+				std::vector<uint8_t> SealData(KeyPolicy keyPolicy, const Ra::States& decentState, const std::string& keyLabel,
+					const void* inMeta, const size_t inMetaSize, const void* inData, const size_t inDataSize,
+					General128Tag* outTag, const size_t sealedBlockSize);
+
+				void UnsealData(KeyPolicy keyPolicy, const Ra::States& decentState, const std::string& keyLabel,
+					const void* inData, const size_t inDataSize, std::vector<uint8_t>& outMeta, std::vector<uint8_t>& outData,
+					const General128Tag* inTag, const size_t sealedBlockSize);
 			}
 
+			/**
+			 * \brief	Maximum number of data sealed with the same seal key. Seal keys (and their key
+			 * 			metadata) are cached and reused to avoid the key derivation and the AES key
+			 * 			expansion on each seal; a new one is generated once this limit is reached, so that
+			 * 			the number of random IVs used under one key stays far below the GCM limit.
+			 */
+			constexpr uint64_t sk_maxSealCountPerKey = 1ULL << 20;
+
 			/**
 			 * \brief	Generates a seal key recovery metadata. This metadata is necessary when deriving the
 			 * 			seal key. Moreover, to derive the same seal key that has been used before, the
@@ -73,7 +89,8 @@ namespace Decent
 			}
 
 			/**
-			 * \brief	Seal data
+			 * \brief	Seal data. The seal key is reused for up to sk_maxSealCountPerKey calls with the
+			 * 			same key policy and label.
 			 *
 			 * \exception	Decent::RuntimeException	Thrown when underlying function call failed.
 			 *
@@ -95,15 +112,14 @@ namespace Decent
 			std::vector<uint8_t> SealData(KeyPolicy keyPolicy, const Ra::States& decentState, const std::string& keyLabel, 
 				const MetaCtn& metadata, const DataCtn& data, General128Tag* outTag = nullptr, const size_t sealedBlockSize = 4096)
 			{
-				std::vector<uint8_t> keyMeta = GenSealKeyRecoverMeta(false);
-				G128BitSecretKeyWrap sealKey;
-				DeriveSealKey(keyPolicy, decentState, keyLabel, sealKey.m_key, keyMeta, std::vector<uint8_t>());
-
-				return QuickAesGcmPack(sealKey.m_key, keyMeta, metadata, data, std::array<uint8_t, 0>(), outTag, sealedBlockSize);
+				using namespace ArrayPtrAndSize;
+				return detail::SealData(keyPolicy, decentState, keyLabel,
+					GetPtr(metadata), GetSize(metadata), GetPtr(data), GetSize(data),
+					outTag, sealedBlockSize);
 			}
 
 			/**
-			 * \brief	Unseal data
+			 * \brief	Unseal data. Keys derived from recently seen key metadata are cached.
 			 *
 			 * \exception	Decent::RuntimeException	Thrown when the sealed data structure is invalid, or
 			 * 											underlying function call failed.
@@ -124,10 +140,10 @@ namespace Decent
 			void UnsealData(KeyPolicy keyPolicy, const Ra::States& decentState, const std::string& keyLabel, 
 				const SealedDataCtn& inData, std::vector<uint8_t>& metadata, std::vector<uint8_t>& data, const General128Tag* inTag = nullptr, const size_t sealedBlockSize = 4096)
 			{
-				G128BitSecretKeyWrap sealKey;
-				DeriveSealKey(keyPolicy, decentState, keyLabel, sealKey.m_key, GetKeyMetaFromPack(inData), std::vector<uint8_t>());
-
-				return QuickAesGcmUnpack(sealKey.m_key, inData, std::array<uint8_t, 0>(), metadata, data, inTag, sealedBlockSize);
+				using namespace ArrayPtrAndSize;
+				return detail::UnsealData(keyPolicy, decentState, keyLabel,
+					GetPtr(inData), GetSize(inData), metadata, data,
+					inTag, sealedBlockSize);
 			}
 		}
 	}
@@ -79,30 +79,52 @@ const char* GetErrorString(rapidjson::ParseErrorCode code)
 	}
 }
 
-void Tools::ParseStr2Json(JsonDoc& outDoc, const std::string& inStr)
+namespace
 {
-	outDoc.Parse(inStr.c_str());
-	rapidjson::ParseErrorCode errcode = outDoc.GetParseError();
-	
-	if (errcode != rapidjson::ParseErrorCode::kParseErrorNone)
+	static void CheckParseResult(const JsonDoc& doc)
 	{
-		std::string errorStr = "rapidJson parse error: ";
-		(errorStr += GetErrorString(errcode)) += ". ";
-		throw RuntimeException(errorStr);
+		rapidjson::ParseErrorCode errcode = doc.GetParseError();
+
+		if (errcode != rapidjson::ParseErrorCode::kParseErrorNone)
+		{
+			std::string errorStr = "rapidJson parse error: ";
+			(errorStr += GetErrorString(errcode)) += ". ";
+			throw RuntimeException(errorStr);
+		}
 	}
 }
 
+void Tools::ParseStr2Json(JsonDoc& outDoc, const std::string& inStr)
+{
+	ParseStr2Json(outDoc, inStr.c_str(), inStr.size());
+}
+
 void Tools::ParseStr2Json(JsonDoc& outDoc, const char* inStr)
 {
 	outDoc.Parse(inStr);
-	rapidjson::ParseErrorCode errcode = outDoc.GetParseError();
+	CheckParseResult(outDoc);
+}
+
+void Tools::ParseStr2Json(JsonDoc& outDoc, const char* inStr, size_t size)
+{
+	outDoc.Parse(inStr, size);
+	CheckParseResult(outDoc);
+}
 
-	if (errcode != rapidjson::ParseErrorCode::kParseErrorNone)
+void Tools::ParseStr2JsonInsitu(JsonDoc& outDoc, std::string& inStr)
+{
+	//Strings in the document will point into inStr, rather than being copied into the allocator.
+	outDoc.ParseInsitu(&inStr[0]);
+	CheckParseResult(outDoc);
+}
+
+JsonStrView Tools::JsonAsStrView(const JsonValue& val)
+{
+	if (!val.IsString())
 	{
-		std::string errorStr = "rapidJson parse error: ";
-		(errorStr += GetErrorString(errcode)) += ". ";
-		throw RuntimeException(errorStr);
+		throw RuntimeException("The JSON value is not a string.");
 	}
+	return JsonStrView(val.GetString(), val.GetStringLength());
 }
 
 std::string Tools::Json2StyledString(const rapidjson::Value & inJson)
@@ -2,12 +2,22 @@
 
 #include "../../Common/Tools/FileBase.h"
 
+#include <vector>
+
 namespace Decent
 {
 	namespace Tools
 	{
+		/**
+		 * \brief	A plain (untrusted) file accessed through OCALLs. Reads are served from an in-enclave
+		 * 			read-ahead buffer, writes are coalesced in a write-back buffer, and the file position
+		 * 			is tracked in trusted memory, so that FTell and FSeek do not leave the enclave.
+		 */
 		class PlainFile : virtual public FileBase
 		{
+		public: //Static Members:
+			static constexpr size_t sk_defaultBufferSize = 4096;
+
 		public:
 			PlainFile() = delete;
 
@@ -29,6 +39,46 @@ namespace Decent
 			virtual int FSeek(const int64_t pos, const int origin) override;
 			virtual size_t FTell() const override;
 
+			/**
+			 * \brief	Gets file size. Any pending write is flushed first, and the size is re-queried from
+			 * 			the untrusted side, so that changes made outside this object are observed.
+			 *
+			 * \return	The file size.
+			 */
+			virtual size_t GetFileSize() override;
+
+			/**
+			 * \brief	Reads from the current position to the end of the file, with at most one OCALL. The
+			 * 			end of the file is the one known at the last time the file size was queried (i.e.
+			 * 			Open or GetFileSize), plus the writes made through this object.
+			 *
+			 * \param [out]	buffer	The buffer.
+			 *
+			 * \return	The number of bytes read.
+			 */
+			virtual size_t ReadFileToEnd(std::vector<uint8_t>& buffer) override;
+
+			/**
+			 * \brief	Reads from the current position to the end of the file, with at most one OCALL. The
+			 * 			end of the file is the one known at the last time the file size was queried (i.e.
+			 * 			Open or GetFileSize), plus the writes made through this object.
+			 *
+			 * \param [out]	buffer	The buffer.
+			 *
+			 * \return	The number of bytes read.
+			 */
+			virtual size_t ReadFileToEnd(std::string& buffer) override;
+
+			/**
+			 * \brief	Sets the size of the read-ahead/write-back buffer. Any pending write is flushed
+			 * 			first. Size of zero disables the buffering.
+			 *
+			 * \param	size	The buffer size.
+			 */
+			virtual void SetBufferSize(const size_t size);
+
+			virtual size_t GetBufferSize() const { return m_bufferSize; }
+
 			virtual operator bool() const { return IsOpen(); }
 
 		protected:
@@ -36,15 +86,40 @@ namespace Decent
 
 			virtual size_t ReadBlockRaw(void* buffer, const size_t size) override;
 
+			/**
+			 * \brief	Writes data at the current position through the write-back buffer.
+			 *
+			 * \param	buffer	The buffer.
+			 * \param	size  	The size.
+			 *
+			 * \return	The number of bytes written.
+			 */
+			size_t BufferedWrite(const void* buffer, const size_t size);
+
+			/** \brief	Writes all pending data in the write-back buffer to the file. */
+			void FlushWriteBuffer();
+
 			void* GetFilePtr() { return m_file; }
 
 			const std::string& GetPath() { return m_path; }
 
 		private:
+			void CloseFile() noexcept;
+
 			std::string m_path;
 			const char* m_modeChar;
 			void* m_file;
 			bool m_isExclusive;
+			bool m_isAppend;
+
+			size_t m_bufferSize;
+			std::vector<uint8_t> m_buffer;
+			int64_t m_bufferPos; //File offset of the first byte in the buffer.
+			size_t m_readLen;    //Number of read-ahead bytes in the buffer.
+			size_t m_writeLen;   //Number of pending bytes in the buffer.
+
+			int64_t m_pos;
+			int64_t m_fileSize;
 		};
 
 		class WritablePlainFile : public PlainFile, virtual public WritableFileBase
@@ -72,6 +147,9 @@ namespace Decent
 
 			virtual size_t GetFileSize() override { return PlainFile::GetFileSize(); }
 
+			virtual size_t ReadFileToEnd(std::vector<uint8_t>& buffer) override { return PlainFile::ReadFileToEnd(buffer); }
+			virtual size_t ReadFileToEnd(std::string& buffer) override { return PlainFile::ReadFileToEnd(buffer); }
+
 		protected:
 			virtual size_t WriteBlockRaw(const void* buffer, const size_t size) override;
 
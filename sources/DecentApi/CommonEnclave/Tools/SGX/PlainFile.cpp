@@ -2,6 +2,10 @@
 
 #include "../PlainFile.h"
 
+#include <cstring>
+
+#include <algorithm>
+
 #include "../../../Common/SGX/RuntimeError.h"
 #include "../../SGX/edl_decent_file_system.h"
 
@@ -9,6 +13,39 @@ using namespace Decent::Tools;
 
 #define THROW_FILE_NOT_OPENED_EXCEPTION throw FileException("Specified file is not opened yet!")
 
+namespace
+{
+	size_t OcallFread(void* buffer, size_t bufferSize, void* file, int64_t offset)
+	{
+		size_t retVal = 0;
+		DECENT_CHECK_SGX_STATUS_ERROR(ocall_decent_tools_fread_at(&retVal, buffer, bufferSize, file, offset), ocall_decent_tools_fread_at);
+		return retVal;
+	}
+
+	size_t OcallFwrite(const void* buffer, size_t bufferSize, void* file, int64_t offset)
+	{
+		size_t retVal = 0;
+		DECENT_CHECK_SGX_STATUS_ERROR(ocall_decent_tools_fwrite_at(&retVal, buffer, bufferSize, file, offset), ocall_decent_tools_fwrite_at);
+		return retVal;
+	}
+
+	size_t OcallFsize(void* file)
+	{
+		size_t retVal = 0;
+		DECENT_CHECK_SGX_STATUS_ERROR(ocall_decent_tools_fsize(&retVal, file), ocall_decent_tools_fsize);
+		return retVal;
+	}
+
+	int OcallFflush(void* file)
+	{
+		int retVal = 0;
+		DECENT_CHECK_SGX_STATUS_ERROR(ocall_decent_tools_fflush(&retVal, file), ocall_decent_tools_fflush);
+		return retVal;
+	}
+}
+
+constexpr size_t PlainFile::sk_defaultBufferSize;
+
 PlainFile::PlainFile(const std::string & path, const Mode mode, bool isExclusive) :
 	PlainFile(path, mode, isExclusive, sk_deferOpen)
 {
@@ -23,19 +60,25 @@ PlainFile::PlainFile(const std::string & path, const Mode mode, bool isExclusive
 PlainFile::PlainFile(PlainFile && rhs) :
 	m_path(std::move(rhs.m_path)),
 	m_modeChar(rhs.m_modeChar),
-	m_file(rhs.m_file)
+	m_file(rhs.m_file),
+	m_isExclusive(rhs.m_isExclusive),
+	m_isAppend(rhs.m_isAppend),
+	m_bufferSize(rhs.m_bufferSize),
+	m_buffer(std::move(rhs.m_buffer)),
+	m_bufferPos(rhs.m_bufferPos),
+	m_readLen(rhs.m_readLen),
+	m_writeLen(rhs.m_writeLen),
+	m_pos(rhs.m_pos),
+	m_fileSize(rhs.m_fileSize)
 {
 	rhs.m_file = nullptr;
+	rhs.m_readLen = 0;
+	rhs.m_writeLen = 0;
 }
 
 PlainFile::~PlainFile()
 {
-	if (IsOpen())
-	{
-		int retVal = 0;
-		ocall_decent_tools_fclose(&retVal, m_file); //Just close it, there is nothing we can do to the error.
-		m_file = nullptr;
-	}
+	CloseFile();
 }
 
 void PlainFile::Open()
@@ -47,6 +90,11 @@ void PlainFile::Open()
 	{
 		throw FileException("Could not open the specific file! (path = " + m_path + ")");
 	}
+
+	m_readLen = 0;
+	m_writeLen = 0;
+	m_fileSize = static_cast<int64_t>(OcallFsize(m_file));
+	m_pos = m_isAppend ? m_fileSize : 0;
 }
 
 int PlainFile::FSeek(const int64_t pos)
@@ -54,48 +102,218 @@ int PlainFile::FSeek(const int64_t pos)
 	return FSeek(pos, DECENT_FS_SEEK_SET);
 }
 
-static int OcallFseek(void* file, int64_t pos, int ori)
+int PlainFile::FSeek(const int64_t pos, const int origin)
 {
-	int retVal = 0;
-	DECENT_CHECK_SGX_STATUS_ERROR(ocall_decent_tools_fseek(& retVal, file, pos, ori), ocall_decent_tools_fseek);
-	return retVal;
+	if (!IsOpen())
+	{
+		THROW_FILE_NOT_OPENED_EXCEPTION;
+	}
+
+	int64_t newPos = 0;
+	switch (origin)
+	{
+	case DECENT_FS_SEEK_SET:
+		newPos = pos;
+		break;
+	case DECENT_FS_SEEK_CUR:
+		newPos = m_pos + pos;
+		break;
+	case DECENT_FS_SEEK_END:
+		newPos = m_fileSize + pos;
+		break;
+	default:
+		return -1;
+	}
+
+	if (newPos < 0)
+	{
+		return -1;
+	}
+
+	//Buffers are kept; they are tagged with their own file offsets.
+	m_pos = newPos;
+	return 0;
 }
 
-int PlainFile::FSeek(const int64_t pos, const int origin)
+size_t PlainFile::FTell() const
 {
-	return IsOpen() ? OcallFseek(m_file, pos, origin) : THROW_FILE_NOT_OPENED_EXCEPTION;
+	return IsOpen() ? static_cast<size_t>(m_pos) : THROW_FILE_NOT_OPENED_EXCEPTION;
 }
 
-static size_t OcalllFtell(void* file)
+size_t PlainFile::GetFileSize()
 {
-	size_t retVal = 0;
-	DECENT_CHECK_SGX_STATUS_ERROR(ocall_decent_tools_ftell(&retVal, file), ocall_decent_tools_ftell);
-	return retVal;
+	if (!IsOpen())
+	{
+		THROW_FILE_NOT_OPENED_EXCEPTION;
+	}
+
+	FlushWriteBuffer();
+	m_fileSize = static_cast<int64_t>(OcallFsize(m_file));
+	return static_cast<size_t>(m_fileSize);
 }
 
-size_t PlainFile::FTell() const
+size_t PlainFile::ReadFileToEnd(std::vector<uint8_t>& buffer)
 {
-	return IsOpen() ? OcalllFtell(m_file) : THROW_FILE_NOT_OPENED_EXCEPTION;
+	buffer.resize(IsOpen() && m_fileSize > m_pos ? static_cast<size_t>(m_fileSize - m_pos) : 0);
+	buffer.resize(ReadBlockRaw(buffer.data(), buffer.size()));
+	return buffer.size();
+}
+
+size_t PlainFile::ReadFileToEnd(std::string& buffer)
+{
+	buffer.resize(IsOpen() && m_fileSize > m_pos ? static_cast<size_t>(m_fileSize - m_pos) : 0);
+	buffer.resize(ReadBlockRaw(&buffer[0], buffer.size()));
+	return buffer.size();
+}
+
+void PlainFile::SetBufferSize(const size_t size)
+{
+	FlushWriteBuffer();
+	m_readLen = 0;
+	m_bufferSize = size;
+	m_buffer.resize(size);
+	m_buffer.shrink_to_fit();
 }
 
 PlainFile::PlainFile(const std::string & path, const char * modeStr, bool isExclusive) :
 	m_path(path),
 	m_modeChar(modeStr),
 	m_file(nullptr),
-	m_isExclusive(isExclusive)
+	m_isExclusive(isExclusive),
+	m_isAppend(modeStr != nullptr && modeStr[0] == 'a'),
+	m_bufferSize(sk_defaultBufferSize),
+	m_buffer(sk_defaultBufferSize),
+	m_bufferPos(0),
+	m_readLen(0),
+	m_writeLen(0),
+	m_pos(0),
+	m_fileSize(0)
 {
 }
 
-static size_t OcallFread(void* buffer, size_t bufferSize, void* file)
+size_t PlainFile::ReadBlockRaw(void * buffer, const size_t size)
 {
-	size_t retVal = 0;
-	DECENT_CHECK_SGX_STATUS_ERROR(ocall_decent_tools_fread(&retVal, buffer, bufferSize, file), ocall_decent_tools_fread);
-	return retVal;
+	if (!IsOpen())
+	{
+		THROW_FILE_NOT_OPENED_EXCEPTION;
+	}
+
+	//Pending writes must reach the file before anything is read back.
+	FlushWriteBuffer();
+
+	uint8_t* outPtr = static_cast<uint8_t*>(buffer);
+	size_t remain = size;
+
+	//1. Serve what we can from the read-ahead buffer.
+	if (m_readLen > 0 && m_pos >= m_bufferPos && m_pos < m_bufferPos + static_cast<int64_t>(m_readLen))
+	{
+		const size_t offset = static_cast<size_t>(m_pos - m_bufferPos);
+		const size_t toCopy = std::min(remain, m_readLen - offset);
+		std::memcpy(outPtr, m_buffer.data() + offset, toCopy);
+
+		outPtr += toCopy;
+		remain -= toCopy;
+		m_pos += toCopy;
+	}
+
+	if (remain == 0)
+	{
+		return size;
+	}
+
+	//2. Large reads go directly into the caller's buffer.
+	if (remain >= m_bufferSize)
+	{
+		const size_t readSize = OcallFread(outPtr, remain, m_file, m_pos);
+		m_pos += readSize;
+		return (size - remain) + readSize;
+	}
+
+	//3. Otherwise, refill the read-ahead buffer.
+	m_readLen = OcallFread(m_buffer.data(), m_bufferSize, m_file, m_pos);
+	m_bufferPos = m_pos;
+
+	const size_t toCopy = std::min(remain, m_readLen);
+	std::memcpy(outPtr, m_buffer.data(), toCopy);
+	m_pos += toCopy;
+
+	return (size - remain) + toCopy;
 }
 
-size_t PlainFile::ReadBlockRaw(void * buffer, const size_t size)
+size_t PlainFile::BufferedWrite(const void * buffer, const size_t size)
+{
+	if (!IsOpen())
+	{
+		THROW_FILE_NOT_OPENED_EXCEPTION;
+	}
+
+	//Any read-ahead data may be stale after this write.
+	m_readLen = 0;
+
+	if (m_isAppend)
+	{
+		m_pos = m_fileSize;
+	}
+
+	//Write-back buffer only holds contiguous data.
+	if (m_writeLen > 0 && (m_pos != m_bufferPos + static_cast<int64_t>(m_writeLen) || m_writeLen + size > m_bufferSize))
+	{
+		FlushWriteBuffer();
+	}
+
+	size_t written = 0;
+	if (size >= m_bufferSize)
+	{
+		written = OcallFwrite(buffer, size, m_file, m_pos);
+	}
+	else
+	{
+		if (m_writeLen == 0)
+		{
+			m_bufferPos = m_pos;
+		}
+		std::memcpy(m_buffer.data() + m_writeLen, buffer, size);
+		m_writeLen += size;
+		written = size;
+	}
+
+	m_pos += written;
+	m_fileSize = std::max(m_fileSize, m_pos);
+
+	return written;
+}
+
+void PlainFile::FlushWriteBuffer()
+{
+	if (m_writeLen == 0)
+	{
+		return;
+	}
+
+	const size_t toWrite = m_writeLen;
+	m_writeLen = 0;
+
+	if (OcallFwrite(m_buffer.data(), toWrite, m_file, m_bufferPos) != toWrite)
+	{
+		throw FileException("Failed to write buffered data to the file! (path = " + m_path + ")");
+	}
+}
+
+void PlainFile::CloseFile() noexcept
 {
-	return IsOpen() ? OcallFread(buffer, size, m_file) : THROW_FILE_NOT_OPENED_EXCEPTION;
+	if (IsOpen())
+	{
+		try
+		{
+			FlushWriteBuffer();
+		}
+		catch (const std::exception&)
+		{} //Just close it, there is nothing we can do to the error.
+
+		int retVal = 0;
+		ocall_decent_tools_fclose(&retVal, m_file); //Just close it, there is nothing we can do to the error.
+		m_file = nullptr;
+	}
 }
 
 WritablePlainFile::WritablePlainFile(const std::string & path, const WritableMode mode, bool isExclusive) :
@@ -118,28 +336,20 @@ WritablePlainFile::~WritablePlainFile()
 {
 }
 
-static int OcallFflush(void* file)
-{
-	int retVal = 0;
-	DECENT_CHECK_SGX_STATUS_ERROR(ocall_decent_tools_fflush(&retVal, file), ocall_decent_tools_fflush);
-	return retVal;
-}
-
 void WritablePlainFile::FFlush()
 {
-	int res = IsOpen() ? OcallFflush(GetFilePtr()) : THROW_FILE_NOT_OPENED_EXCEPTION;
-}
+	if (!IsOpen())
+	{
+		THROW_FILE_NOT_OPENED_EXCEPTION;
+	}
 
-static size_t OcallFwrite(const void* buffer, size_t bufferSize, void* file)
-{
-	size_t retVal = 0;
-	DECENT_CHECK_SGX_STATUS_ERROR(ocall_decent_tools_fwrite(&retVal, buffer, bufferSize, file), ocall_decent_tools_fwrite);
-	return retVal;
+	FlushWriteBuffer();
+	OcallFflush(GetFilePtr());
 }
 
 size_t WritablePlainFile::WriteBlockRaw(const void * buffer, const size_t size)
 {
-	return IsOpen() ? OcallFwrite(buffer, size, GetFilePtr()) : THROW_FILE_NOT_OPENED_EXCEPTION;
+	return BufferedWrite(buffer, size);
 }
 
 //#endif //ENCLAVE_PLATFORM_SGX
@@ -2,13 +2,199 @@
 
 #include "../UntrustedBuffer.h"
 
+#include <cstring>
+
+#include <map>
+#include <mutex>
+#include <limits>
+
+#include <sgx_trts.h>
+
+#include "../../../Common/RuntimeException.h"
+#include "../../../Common/Tools/UntrustedArenaLayout.h"
 #include "../../SGX/edl_decent_tools.h"
 
 using namespace Decent::Tools;
 
+namespace
+{
+	struct ArenaInfo
+	{
+		uint8_t* m_base;
+		size_t m_slotCount;
+		size_t m_slotSize;
+	};
+
+	static std::mutex gs_arenaMutex;
+	//Entries are never removed, since arenas in untrusted side are never freed.
+	static std::map<uint16_t, ArenaInfo> gs_arenas;
+
+	static const ArenaInfo& GetArenaInfo(uint16_t arenaId)
+	{
+		std::unique_lock<std::mutex> arenaLock(gs_arenaMutex);
+
+		auto it = gs_arenas.find(arenaId);
+		if (it != gs_arenas.end())
+		{
+			return it->second;
+		}
+
+		int retVal = false;
+		ArenaInfo info{ nullptr, 0, 0 };
+		if (ocall_decent_tools_get_arena_info(&retVal, arenaId, &info.m_base, &info.m_slotCount, &info.m_slotSize) != SGX_SUCCESS ||
+			!retVal)
+		{
+			throw Decent::RuntimeException("Failed to get the information of the untrusted arena.");
+		}
+
+		const size_t stride = GetUntrustedArenaStride(info.m_slotSize);
+		if (!info.m_base ||
+			(reinterpret_cast<uintptr_t>(info.m_base) % alignof(UntrustedArenaSlotHeader)) != 0 ||
+			info.m_slotCount == 0 || info.m_slotCount > 0x10000 ||
+			info.m_slotSize == 0 || stride < info.m_slotSize ||
+			info.m_slotCount > (std::numeric_limits<size_t>::max() / stride) ||
+			!sgx_is_outside_enclave(info.m_base, info.m_slotCount * stride))
+		{
+			throw Decent::RuntimeException("The untrusted arena given by untrusted side is invalid.");
+		}
+
+		return gs_arenas.insert(std::make_pair(arenaId, info)).first->second;
+	}
+
+	static void ReleaseArenaSlot(UntrustedArenaSlotHeader& header, uint64_t token) noexcept
+	{
+		if (header.m_generation.load(std::memory_order_acquire) == UntrustedArenaToken::Unpack(token).m_generation)
+		{
+			header.m_isOwned.store(0, std::memory_order_release);
+		}
+	}
+
+	/**
+	 * \brief	Gives the arena slot back if the construction of UntrustedBuffer fails half way, so that
+	 * 			the slot is not held forever. The slot is released through its header once it's
+	 * 			located, or by an OCALL otherwise.
+	 */
+	class ArenaSlotGuard
+	{
+	public:
+		ArenaSlotGuard(uint64_t token) noexcept :
+			m_token(token),
+			m_header(nullptr)
+		{}
+
+		~ArenaSlotGuard()
+		{
+			if (m_token == UntrustedArenaToken::sk_heapBuffer)
+			{
+				return;
+			}
+
+			if (m_header)
+			{
+				ReleaseArenaSlot(*m_header, m_token);
+			}
+			else
+			{
+				ocall_decent_tools_free_arena_slot(m_token);
+			}
+		}
+
+		void SetHeader(UntrustedArenaSlotHeader& header) noexcept { m_header = &header; }
+
+		void Dismiss() noexcept { m_token = UntrustedArenaToken::sk_heapBuffer; }
+
+	private:
+		uint64_t m_token;
+		UntrustedArenaSlotHeader* m_header;
+	};
+
+	static void CheckHeapBuffer(const uint8_t* ptr, size_t size)
+	{
+		if (size > 0 && (!ptr || !sgx_is_outside_enclave(ptr, size)))
+		{
+			throw Decent::RuntimeException("The untrusted buffer given by untrusted side is not outside the enclave.");
+		}
+	}
+}
+
+UntrustedBuffer::UntrustedBuffer(uint8_t * ptr, const size_t size) :
+	m_ptr(ptr),
+	m_size(size),
+	m_token(UntrustedArenaToken::sk_heapBuffer)
+{
+	CheckHeapBuffer(m_ptr, m_size);
+}
+
+UntrustedBuffer::UntrustedBuffer(uint8_t * ptr, const size_t size, const uint64_t token) :
+	m_ptr(ptr),
+	m_size(size),
+	m_token(token)
+{
+	if (m_token == UntrustedArenaToken::sk_heapBuffer)
+	{
+		CheckHeapBuffer(m_ptr, m_size);
+		return;
+	}
+
+	ArenaSlotGuard slotGuard(m_token);
+
+	const UntrustedArenaToken tokenVal = UntrustedArenaToken::Unpack(m_token);
+	const ArenaInfo& arena = GetArenaInfo(tokenVal.m_arenaId);
+
+	if (tokenVal.m_slot >= arena.m_slotCount)
+	{
+		throw Decent::RuntimeException("The untrusted arena token is out of bound.");
+	}
+
+	//The pointer given by untrusted side is not used; the location is computed from the registered arena.
+	uint8_t* slotPtr = arena.m_base + (tokenVal.m_slot * GetUntrustedArenaStride(arena.m_slotSize));
+	UntrustedArenaSlotHeader& header = *reinterpret_cast<UntrustedArenaSlotHeader*>(slotPtr);
+	slotGuard.SetHeader(header);
+
+	if (m_size > arena.m_slotSize)
+	{
+		throw Decent::RuntimeException("The untrusted arena token is out of bound.");
+	}
+
+	if (header.m_isOwned.load(std::memory_order_acquire) == 0 ||
+		header.m_generation.load(std::memory_order_acquire) != tokenVal.m_generation)
+	{
+		throw Decent::RuntimeException("The untrusted arena token doesn't own the slot.");
+	}
+
+	m_ptr = slotPtr + sizeof(UntrustedArenaSlotHeader);
+	slotGuard.Dismiss();
+}
+
 UntrustedBuffer::~UntrustedBuffer()
 {
-	ocall_decent_tools_del_buf_uint8(m_ptr);
+	if (m_token == UntrustedArenaToken::sk_heapBuffer)
+	{
+		ocall_decent_tools_del_buf_uint8(m_ptr);
+		return;
+	}
+
+	ReleaseArenaSlot(*reinterpret_cast<UntrustedArenaSlotHeader*>(m_ptr - sizeof(UntrustedArenaSlotHeader)), m_token);
+}
+
+uint8_t* Decent::Tools::CopyToUntrustedBuffer(const void* ptr, const size_t size)
+{
+	uint8_t* res = nullptr;
+	if (ocall_decent_tools_new_buf_uint8(&res, size) != SGX_SUCCESS ||
+		!res)
+	{
+		throw Decent::RuntimeException("Failed to allocate buffer in untrusted side.");
+	}
+
+	if (!sgx_is_outside_enclave(res, size))
+	{
+		//The untrusted side gave us an address inside the enclave; don't touch it.
+		throw Decent::RuntimeException("The buffer allocated by untrusted side is not outside the enclave.");
+	}
+
+	std::memcpy(res, ptr, size);
+
+	return res;
 }
 
 //#endif //ENCLAVE_PLATFORM_SGX
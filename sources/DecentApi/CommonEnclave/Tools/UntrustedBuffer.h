@@ -12,7 +12,9 @@ namespace Decent
 	{
 		/**
 		 * \brief	Untrusted Buffer. This object holds a buffer that allocated in untrusted side (i.e.
-		 * 			application side, non-enclave side).
+		 * 			application side, non-enclave side). The buffer is either allocated by new[], or
+		 * 			a slot in an untrusted arena (see CommonApp/Tools/UntrustedArena.h), which is
+		 * 			identified by an ownership token rather than the pointer given by untrusted side.
 		 */
 		class UntrustedBuffer
 		{
@@ -20,17 +22,37 @@ namespace Decent
 			UntrustedBuffer() = delete;
 
 			/**
-			 * \brief	Constructor
+			 * \brief	Constructor for a buffer allocated by new[] in untrusted side.
+			 *
+			 * \exception	Decent::RuntimeException	Thrown when the buffer is not outside the enclave.
 			 *
 			 * \param [in,out]	ptr 	If non-null, the pointer to the untrusted buffer.
 			 * \param 		  	size	The size of that buffer.
 			 */
-			UntrustedBuffer(uint8_t* ptr, const size_t size) :
-				m_ptr(ptr),
-				m_size(size)
-			{}
+			UntrustedBuffer(uint8_t* ptr, const size_t size);
+
+			/**
+			 * \brief	Constructor for a buffer given with an ownership token. If the token is
+			 * 			UntrustedArenaToken::sk_heapBuffer, it's same as the constructor above;
+			 * 			otherwise, the pointer given is ignored, and the location of the slot is
+			 * 			computed from the arena registered with the ID in the token. The arena is looked
+			 * 			up with an OCALL only the first time it's seen.
+			 *
+			 * \exception	Decent::RuntimeException	Thrown when the token is invalid, or the buffer is not
+			 * 											outside the enclave.
+			 *
+			 * \param [in,out]	ptr  	The pointer to the untrusted buffer given by untrusted side.
+			 * \param 		  	size 	The size of that buffer.
+			 * \param 		  	token	The ownership token.
+			 */
+			UntrustedBuffer(uint8_t* ptr, const size_t size, const uint64_t token);
 
-			/** \brief	Destructor. This will call the function in untrusted side to free the buffer. */
+			UntrustedBuffer(const UntrustedBuffer& rhs) = delete;
+
+			/**
+			 * \brief	Destructor. The slot in arena is given back by writing its header directly;
+			 * 			otherwise, this will call the function in untrusted side to free the buffer.
+			 */
 			virtual ~UntrustedBuffer();
 
 			/**
@@ -72,6 +94,37 @@ namespace Decent
 		private:
 			uint8_t * m_ptr;
 			size_t m_size;
+			uint64_t m_token;
 		};
+
+		/**
+		 * \brief	Allocates a buffer in untrusted side, with a single OCALL, and copies the given data
+		 * 			into it. This is used to return a variable-length result from an ECALL in one call,
+		 * 			rather than querying the size first. The untrusted side takes the ownership of the
+		 * 			buffer, and frees it with delete[].
+		 *
+		 * \exception	Decent::RuntimeException	Thrown when the allocation in untrusted side failed.
+		 *
+		 * \param	ptr 	The pointer to the data.
+		 * \param	size	The size of the data.
+		 *
+		 * \return	The pointer to the untrusted buffer.
+		 */
+		uint8_t* CopyToUntrustedBuffer(const void* ptr, const size_t size);
+
+		/**
+		 * \brief	Allocates a buffer in untrusted side, and copies the given data into it. See the
+		 * 			function above.
+		 *
+		 * \tparam	Container	Type of the container.
+		 * \param	data	The data.
+		 *
+		 * \return	The pointer to the untrusted buffer.
+		 */
+		template<typename Container>
+		uint8_t* CopyToUntrustedBuffer(const Container& data)
+		{
+			return CopyToUntrustedBuffer(ArrayPtrAndSize::GetPtr(data), ArrayPtrAndSize::GetSize(data));
+		}
 	}
 }
\ No newline at end of file
@@ -53,23 +53,16 @@ std::string DecentApp::GetAppX509Cert()
 	sgx_status_t enclaveRet = SGX_SUCCESS;
 	sgx_status_t retval = SGX_SUCCESS;
 
+	uint8_t* certPtr = nullptr;
 	size_t certLen = 0;
-	std::string retReport(5000, '\0');
 
-	enclaveRet = ecall_decent_ra_app_get_x509_pem(GetEnclaveId(), &certLen, &retReport[0], retReport.size());
+	enclaveRet = ecall_decent_ra_app_get_x509_pem(GetEnclaveId(), &retval, &certPtr, &certLen);
+	std::unique_ptr<uint8_t[]> certBuf(certPtr); //The buffer is allocated by us, on request of the enclave.
 	DECENT_CHECK_SGX_STATUS_ERROR(enclaveRet, ecall_decent_ra_app_get_x509_pem);
-	DECENT_ASSERT_ENCLAVE_APP_RESULT(certLen > 0, "get Decent App's certificate.");
+	DECENT_CHECK_SGX_STATUS_ERROR(retval, ecall_decent_ra_app_get_x509_pem);
+	DECENT_ASSERT_ENCLAVE_APP_RESULT(certBuf && certLen > 0, "get Decent App's certificate.");
 
-	if (certLen > retReport.size())
-	{
-		retReport.resize(certLen);
-
-		enclaveRet = ecall_decent_ra_app_get_x509_pem(GetEnclaveId(), &certLen, &retReport[0], retReport.size());
-		DECENT_CHECK_SGX_STATUS_ERROR(enclaveRet, ecall_decent_ra_app_get_x509_pem);
-		DECENT_ASSERT_ENCLAVE_APP_RESULT(certLen > 0, "get Decent App's certificate.");
-	}
-
-	return retReport;
+	return std::string(reinterpret_cast<const char*>(certBuf.get()), certLen);
 }
 
 bool DecentApp::ProcessSmartMessage(const std::string & category, ConnectionBase& connection, ConnectionBase*& freeHeldCnt)
@@ -8,7 +8,7 @@
 extern "C" {
 #endif
 
-	sgx_status_t ecall_decent_ra_app_get_x509_pem(sgx_enclave_id_t eid, size_t* retval, char* buf, size_t buf_len);
+	sgx_status_t ecall_decent_ra_app_get_x509_pem(sgx_enclave_id_t eid, sgx_status_t* retval, uint8_t** out_pem, size_t* out_size);
 	sgx_status_t ecall_decent_ra_app_init(sgx_enclave_id_t eid, sgx_status_t* retval, void* connection);
 
 #ifdef __cplusplus
@@ -5,6 +5,7 @@
 #include <sgx_dh.h>
 
 #include "../../CommonEnclave/Tools/Crypto.h"
+#include "../../CommonEnclave/Tools/UntrustedBuffer.h"
 #include "../../CommonEnclave/Net/EnclaveCntTranslator.h"
 #include "../../CommonEnclave/SGX/LocAttCommLayer.h"
 #include "../../CommonEnclave/Ra/TlsConfigSameEnclave.h"
@@ -37,18 +38,33 @@ namespace
 	static AppStates& gs_appStates = GetAppStateSingleton();
 }
 
-extern "C" size_t ecall_decent_ra_app_get_x509_pem(char* buf, size_t buf_len)
+extern "C" sgx_status_t ecall_decent_ra_app_get_x509_pem(uint8_t** out_pem, size_t* out_size)
 {
+	if (!out_pem || !out_size)
+	{
+		return SGX_ERROR_INVALID_PARAMETER;
+	}
+
 	auto cert = gs_appStates.GetCertContainer().GetCert();
 	if (!cert)
 	{
-		return 0;
+		return SGX_ERROR_UNEXPECTED;
 	}
 
-	std::string x509Pem = cert->GetPemChain();
-	std::memcpy(buf, x509Pem.data(), buf_len >= x509Pem.size() ? x509Pem.size() : buf_len);
+	try
+	{
+		std::string x509Pem = cert->GetPemChain();
 
-	return x509Pem.size();
+		*out_pem = CopyToUntrustedBuffer(x509Pem);
+		*out_size = x509Pem.size();
+
+		return SGX_SUCCESS;
+	}
+	catch (const std::exception& e)
+	{
+		PRINT_W("Failed to get App certificate. Caught exception: %s", e.what());
+		return SGX_ERROR_UNEXPECTED;
+	}
 }
 
 extern "C" sgx_status_t ecall_decent_ra_app_init(void* connection)
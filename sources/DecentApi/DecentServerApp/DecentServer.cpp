@@ -2,6 +2,7 @@
 
 #include <thread>
 #include <cstring>
+#include <memory>
 
 #include <sgx_ukey_exchange.h>
 #include <sgx_tcrypto.h>
@@ -9,10 +10,12 @@
 
 #include "../Common/Tools/DataCoding.h"
 #include "../Common/Ra/RequestCategory.h"
+#include "../Common/Ra/WhiteList/ConstListBatch.h"
 #include "../Common/SGX/RuntimeError.h"
 #include "../Common/Net/ConnectionBase.h"
 
 #include "../CommonApp/Base/EnclaveException.h"
+#include "../CommonApp/Tools/UntrustedArena.h"
 
 #include "edl_decent_ra_server.h"
 
@@ -79,6 +82,29 @@ void DecentServer::LoadConstWhiteList(const std::string & key, const std::string
 
 	enclaveRet = ecall_decent_ra_server_load_const_loaded_list(GetEnclaveId(), &retval, key.c_str(), whiteList.c_str());
 	DECENT_CHECK_SGX_STATUS_ERROR(enclaveRet, ecall_decent_ra_server_load_const_loaded_list);
+	DECENT_ASSERT_ENCLAVE_APP_RESULT(retval, "load const white list");
+}
+
+void DecentServer::LoadConstWhiteLists(const std::map<std::string, std::string>& whiteLists, const std::vector<std::string>& removeKeys)
+{
+	Ra::WhiteList::ConstListBatch batch;
+	batch.Add(whiteLists);
+	for (const std::string& key : removeKeys)
+	{
+		batch.Remove(key);
+	}
+
+	LoadConstWhiteLists(batch.Pack());
+}
+
+void DecentServer::LoadConstWhiteLists(const std::string & packed)
+{
+	sgx_status_t enclaveRet = SGX_SUCCESS;
+	int retval = 0;
+
+	enclaveRet = ecall_decent_ra_server_load_const_lists(GetEnclaveId(), &retval, reinterpret_cast<const uint8_t*>(packed.data()), packed.size());
+	DECENT_CHECK_SGX_STATUS_ERROR(enclaveRet, ecall_decent_ra_server_load_const_lists);
+	DECENT_ASSERT_ENCLAVE_APP_RESULT(retval, "load const white lists");
 }
 
 void DecentServer::ProcessAppCertReq(const std::string & wListKey, ConnectionBase& connection)
@@ -103,6 +129,16 @@ bool DecentServer::ProcessSmartMessage(const std::string& category, ConnectionBa
 
 		return false;
 	}
+	else if (category == Ra::RequestCategory::sk_loadWhiteLists)
+	{
+		static const char ackMsg[] = "ACK";
+		std::string packed = connection.RecvContainer<std::string>();
+		LoadConstWhiteLists(packed);
+
+		connection.SendRawAll(&ackMsg, sizeof(ackMsg));
+
+		return false;
+	}
 	else if (category == Ra::RequestCategory::sk_requestAppCert)
 	{
 		std::string key = connection.RecvContainer<std::string>();
@@ -122,19 +158,16 @@ std::string DecentServer::GenerateDecentSelfRAReport()
 	DECENT_CHECK_SGX_STATUS_ERROR(enclaveRet, ecall_decent_ra_server_gen_x509);
 	DECENT_CHECK_SGX_STATUS_ERROR(retval, ecall_decent_ra_server_gen_x509);
 
+	uint8_t* certPtr = nullptr;
 	size_t certLen = 0;
 
-	enclaveRet = ecall_decent_ra_server_get_x509_pem(GetEnclaveId(), &certLen, nullptr, 0);
-	DECENT_CHECK_SGX_STATUS_ERROR(enclaveRet, ecall_decent_ra_server_get_x509_pem);
-	DECENT_ASSERT_ENCLAVE_APP_RESULT(certLen > 0, "get Decent Server's certificate");
-
-	std::string retReport(certLen, '\0');
-	
-	enclaveRet = ecall_decent_ra_server_get_x509_pem(GetEnclaveId(), &certLen, &retReport[0], retReport.size());
+	enclaveRet = ecall_decent_ra_server_get_x509_pem(GetEnclaveId(), &retval, &certPtr, &certLen);
+	std::unique_ptr<uint8_t[]> certBuf(certPtr); //The buffer is allocated by us, on request of the enclave.
 	DECENT_CHECK_SGX_STATUS_ERROR(enclaveRet, ecall_decent_ra_server_get_x509_pem);
-	DECENT_ASSERT_ENCLAVE_APP_RESULT(certLen > 0, "get Decent Server's certificate");
+	DECENT_CHECK_SGX_STATUS_ERROR(retval, ecall_decent_ra_server_get_x509_pem);
+	DECENT_ASSERT_ENCLAVE_APP_RESULT(certBuf && certLen > 0, "get Decent Server's certificate");
 
-	return retReport;
+	return std::string(reinterpret_cast<const char*>(certBuf.get()), certLen);
 }
 
 extern "C" int ocall_decent_ra_server_ra_get_msg1(const uint64_t enclave_id, const uint32_t ra_ctx, sgx_ra_msg1_t* msg1)
@@ -153,9 +186,9 @@ extern "C" int ocall_decent_ra_server_ra_get_msg1(const uint64_t enclave_id, con
 	return (enclaveRet == SGX_SUCCESS);
 }
 
-extern "C" size_t ocall_decent_ra_server_ra_proc_msg2(const uint64_t enclave_id, const uint32_t ra_ctx, const sgx_ra_msg2_t* msg2, const size_t msg2_size, uint8_t** out_msg3)
+extern "C" size_t ocall_decent_ra_server_ra_proc_msg2(const uint64_t enclave_id, const uint32_t ra_ctx, const sgx_ra_msg2_t* msg2, const size_t msg2_size, uint8_t** out_msg3, uint64_t* out_token)
 {
-	if (!msg2 || !out_msg3)
+	if (!msg2 || !out_msg3 || !out_token)
 	{
 		return 0;
 	}
@@ -176,8 +209,8 @@ extern "C" size_t ocall_decent_ra_server_ra_proc_msg2(const uint64_t enclave_id,
 		return 0;
 	}
 
-	//Copy msg3 to our buffer pointer to avoid the mix use of malloc and delete[];
-	*out_msg3 = new uint8_t[tmpMsg3Size];
+	//Copy msg3 to the buffer for the enclave to avoid the mix use of malloc and delete[];
+	*out_msg3 = UntrustedArena::AllocateForEnclave(tmpMsg3Size, *out_token);
 	std::memcpy(*out_msg3, tmpMsg3, tmpMsg3Size);
 	std::free(tmpMsg3);
 
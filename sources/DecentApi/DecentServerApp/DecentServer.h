@@ -27,6 +27,8 @@ namespace Decent
 			//DecentEnclave methods:
 			virtual std::string GetDecentSelfRAReport() const override;
 			virtual void LoadConstWhiteList(const std::string& key, const std::string& whiteList) override;
+			virtual void LoadConstWhiteLists(const std::map<std::string, std::string>& whiteLists, const std::vector<std::string>& removeKeys) override;
+			virtual void LoadConstWhiteLists(const std::string& packed) override;
 			virtual void ProcessAppCertReq(const std::string& wListKey, Net::ConnectionBase& connection) override;
 
 			virtual bool ProcessSmartMessage(const std::string& category, Net::ConnectionBase& connection, Net::ConnectionBase*& freeHeldCnt) override;
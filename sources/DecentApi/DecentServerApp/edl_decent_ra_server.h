@@ -12,8 +12,9 @@ extern "C" {
 	sgx_status_t ecall_decent_ra_server_init(sgx_enclave_id_t eid, sgx_status_t* retval, const sgx_spid_t* inSpid);
 	sgx_status_t ecall_decent_ra_server_terminate(sgx_enclave_id_t eid);
 	sgx_status_t ecall_decent_ra_server_gen_x509(sgx_enclave_id_t eid, sgx_status_t* retval, const void* ias_connector, uint64_t enclave_Id);
-	sgx_status_t ecall_decent_ra_server_get_x509_pem(sgx_enclave_id_t eid, size_t* retval, char* buf, size_t buf_len);
+	sgx_status_t ecall_decent_ra_server_get_x509_pem(sgx_enclave_id_t eid, sgx_status_t* retval, uint8_t** out_pem, size_t* out_size);
 	sgx_status_t ecall_decent_ra_server_load_const_loaded_list(sgx_enclave_id_t eid, int* retval, const char* key, const char* listJson);
+	sgx_status_t ecall_decent_ra_server_load_const_lists(sgx_enclave_id_t eid, int* retval, const uint8_t* packed, size_t packed_size);
 	sgx_status_t ecall_decent_ra_server_proc_app_cert_req(sgx_enclave_id_t eid, sgx_status_t* retval, const char* key, void* connection);
 
 	sgx_status_t decent_ra_get_ga(sgx_enclave_id_t eid, sgx_status_t* retval, sgx_ra_context_t context, sgx_ec256_public_t* g_a);
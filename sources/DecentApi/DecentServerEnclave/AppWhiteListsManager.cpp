@@ -1,10 +1,28 @@
 #include "AppWhiteListsManager.h"
 
+#include <vector>
+
 #include "../Common/Common.h"
+#include "../Common/RuntimeException.h"
+#include "../Common/Tools/StrView.h"
+#include "../Common/Ra/WhiteList/EncodedList.h"
+#include "../Common/Ra/WhiteList/ConstListBatch.h"
 
+using namespace Decent::Tools;
 using namespace Decent::Ra::WhiteList;
 
-AppWhiteListsManager::AppWhiteListsManager()
+namespace
+{
+	static const std::shared_ptr<const EncodedList>& GetEmptyList()
+	{
+		static const std::shared_ptr<const EncodedList> emptyList = std::make_shared<EncodedList>();
+		return emptyList;
+	}
+}
+
+AppWhiteListsManager::AppWhiteListsManager() :
+	m_listMap(std::make_shared<ListMapType>()),
+	m_updateMutex()
 {
 }
 
@@ -12,23 +30,124 @@ AppWhiteListsManager::~AppWhiteListsManager()
 {
 }
 
-std::string AppWhiteListsManager::GetWhiteList(const std::string & key) const
+std::shared_ptr<const EncodedList> AppWhiteListsManager::GetWhiteList(const std::string & key) const
 {
-	std::unique_lock<std::mutex> listMapLock(m_listMapMutex);
-	auto it = m_listMap.find(key);
+	std::shared_ptr<const ListMapType> listMap = GetListMap();
+	auto it = listMap->find(key);
 
-	const bool isFound = it != m_listMap.cend();
-	return isFound ? it ->second : std::string();
+	const bool isFound = it != listMap->cend();
+	return isFound ? it->second : GetEmptyList();
 }
 
 bool AppWhiteListsManager::AddWhiteList(const std::string & key, const std::string & listJson)
 {
-	//Add validation code for "listJson" as necessary here.
-	
-	std::unique_lock<std::mutex> listMapLock(m_listMapMutex);
-	m_listMap[key] = listJson;
+	std::shared_ptr<const EncodedList> list;
+	try
+	{
+		list = std::make_shared<EncodedList>(listJson);
+	}
+	catch (const std::exception&)
+	{}
 
-	LOGI("Loaded Const WhiteList: Key = %s. \n%s \n", key.c_str(), listJson.c_str());
+	if (key.size() == 0 || !list)
+	{
+		LOGW("Rejected invalid const white list: Key = %s.", key.c_str());
+		return false;
+	}
+
+	{
+		std::unique_lock<std::mutex> updateLock(m_updateMutex);
+		std::shared_ptr<ListMapType> listMap = std::make_shared<ListMapType>(*GetListMap());
+		(*listMap)[key] = list;
+		std::atomic_store(&m_listMap, std::shared_ptr<const ListMapType>(std::move(listMap)));
+	}
+
+	LOGI("Loaded Const WhiteList: Key = %s, with %llu entries.", key.c_str(), static_cast<unsigned long long>(list->GetMap().size()));
 
 	return true;
 }
+
+bool AppWhiteListsManager::RemoveWhiteList(const std::string & key)
+{
+	{
+		std::unique_lock<std::mutex> updateLock(m_updateMutex);
+		std::shared_ptr<const ListMapType> oldMap = GetListMap();
+		if (oldMap->find(key) == oldMap->end())
+		{
+			return false;
+		}
+
+		std::shared_ptr<ListMapType> listMap = std::make_shared<ListMapType>(*oldMap);
+		listMap->erase(key);
+		std::atomic_store(&m_listMap, std::shared_ptr<const ListMapType>(std::move(listMap)));
+	}
+
+	LOGI("Removed Const WhiteList: Key = %s.", key.c_str());
+	return true;
+}
+
+void AppWhiteListsManager::ApplyBatch(const StrView & packed)
+{
+	const std::vector<ConstListBatch::Entry> entries = ConstListBatch::Unpack(packed);
+
+	//Validation pass; white lists are parsed and encoded here, outside of the update lock.
+	std::vector<std::shared_ptr<const EncodedList> > lists;
+	lists.reserve(entries.size());
+	for (const ConstListBatch::Entry& entry : entries)
+	{
+		if (entry.m_key.size() == 0)
+		{
+			throw Decent::RuntimeException("Const white list batch contains an empty key.");
+		}
+
+		if (entry.m_op == ConstListBatch::Operation::Add)
+		{
+			try
+			{
+				lists.push_back(std::make_shared<EncodedList>(entry.m_listJson.ToString()));
+			}
+			catch (const std::exception&)
+			{
+				throw Decent::RuntimeException("Const white list batch contains an invalid white list, with key " + entry.m_key.ToString() + ".");
+			}
+		}
+		else
+		{
+			lists.push_back(nullptr);
+		}
+	}
+
+	unsigned long long addCount = 0;
+	unsigned long long removeCount = 0;
+	unsigned long long totalCount = 0;
+	{
+		std::unique_lock<std::mutex> updateLock(m_updateMutex);
+		std::shared_ptr<ListMapType> listMap = std::make_shared<ListMapType>(*GetListMap());
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			if (lists[i])
+			{
+				(*listMap)[entries[i].m_key.ToString()] = std::move(lists[i]);
+				++addCount;
+			}
+			else
+			{
+				removeCount += listMap->erase(entries[i].m_key.ToString());
+			}
+		}
+		totalCount = listMap->size();
+		std::atomic_store(&m_listMap, std::shared_ptr<const ListMapType>(std::move(listMap)));
+	}
+
+	LOGI("Applied Const WhiteList batch: %llu added, %llu removed, %llu loaded in total.", addCount, removeCount, totalCount);
+}
+
+size_t AppWhiteListsManager::GetSize() const
+{
+	return GetListMap()->size();
+}
+
+std::shared_ptr<const AppWhiteListsManager::ListMapType> AppWhiteListsManager::GetListMap() const
+{
+	return std::atomic_load(&m_listMap);
+}
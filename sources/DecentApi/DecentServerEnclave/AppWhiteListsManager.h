@@ -2,6 +2,16 @@
 
 #include <map>
 #include <mutex>
+#include <memory>
+#include <string>
+
+namespace Decent
+{
+	namespace Tools
+	{
+		class StrView;
+	}
+}
 
 namespace Decent
 {
@@ -9,12 +19,21 @@ namespace Decent
 	{
 		namespace WhiteList
 		{
+			class EncodedList;
+
 			/**
 			 * \brief	Manager for loading application's white lists, which will be embedded in Decent App's
-			 * 			certificate later.
+			 * 			certificate later. Each white list is parsed and encoded once when it's loaded, and
+			 * 			kept as an immutable EncodedList. The map of white lists is copy-on-write: changes
+			 * 			are made to a copy of the map (which only holds pointers to the white lists), and
+			 * 			then the copy is published atomically. Thus, lookups never wait on the changes, nor
+			 * 			copy any white list.
 			 */
 			class AppWhiteListsManager
 			{
+			public: //static members:
+				typedef std::map<std::string, std::shared_ptr<const EncodedList> > ListMapType;
+
 			public:
 				/** \brief	Default constructor */
 				AppWhiteListsManager();
@@ -25,30 +44,64 @@ namespace Decent
 				/**
 				 * \brief	Get the white list with the given key (i.e. index). Note: If a application is asking
 				 * 			a white list that doesn't exist, we simply see that as that application doesn't have
-				 * 			a white list, thus, an empty string will be returned. This function is thread-safe.
+				 * 			a white list, thus, an empty white list will be returned. This function is
+				 * 			thread-safe, and it doesn't block on the changes to the white lists.
 				 *
 				 * \param	key	The key (i.e. index).
 				 *
-				 * \return	The white list. If the white list doesn't exist, an empty string will be returned.
+				 * \return	The white list, which is never null. If the white list doesn't exist, an empty white
+				 * 			list will be returned.
 				 */
-				std::string GetWhiteList(const std::string& key) const;
+				std::shared_ptr<const EncodedList> GetWhiteList(const std::string& key) const;
 
 				/**
-				 * \brief	Add a white list
+				 * \brief	Add a white list. Since the map is copy-on-write, use ApplyBatch to add many white
+				 * 			lists.
 				 *
 				 * \param	key			The key (i.e. index).
-				 * \param	listJson	The string of white list, which is usually encoded in JSON, however, this
-				 * 						function won't check the format of the white list, thus, this more features
-				 * 						might be added in future. This function is thread-safe.
+				 * \param	listJson	The white list in JSON. This function is thread-safe.
 				 *
-				 * \return	True if it is successfully added, false if it fails. For now, it only return true, as
-				 * 			it does not check the format of the white list.
+				 * \return	True if it is successfully added, false if the key is empty or the white list is
+				 * 			not a valid JSON white list.
 				 */
 				virtual bool AddWhiteList(const std::string& key, const std::string& listJson);
 
+				/**
+				 * \brief	Removes a white list. This function is thread-safe.
+				 *
+				 * \param	key	The key (i.e. index).
+				 *
+				 * \return	True if it is removed, false if it doesn't exist.
+				 */
+				virtual bool RemoveWhiteList(const std::string& key);
+
+				/**
+				 * \brief	Applies a batch of changes packed by ConstListBatch. All entries are validated
+				 * 			(i.e. parsed and encoded) first, in one pass; then they are applied in order to a
+				 * 			single copy of the map, which is published at once, so that the other threads see
+				 * 			either none or all of the changes. If any entry
+				 * 			is invalid, nothing is changed. This function is thread-safe.
+				 *
+				 * \exception	Decent::RuntimeException	Thrown when the batch is malformed, or any entry is
+				 * 											invalid.
+				 *
+				 * \param	packed	The packed batch.
+				 */
+				virtual void ApplyBatch(const Tools::StrView& packed);
+
+				/**
+				 * \brief	Gets the number of white lists loaded. This function is thread-safe.
+				 *
+				 * \return	The number of white lists.
+				 */
+				size_t GetSize() const;
+
+			protected:
+				std::shared_ptr<const ListMapType> GetListMap() const;
+
 			private:
-				std::map<std::string, std::string> m_listMap;
-				mutable std::mutex m_listMapMutex;
+				std::shared_ptr<const ListMapType> m_listMap;
+				std::mutex m_updateMutex; //Serializes the changes, which are copy-on-write.
 			};
 		}
 	}
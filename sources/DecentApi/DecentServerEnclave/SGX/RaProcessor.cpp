@@ -50,15 +50,16 @@ void RaProcessorClient::ProcessMsg2(const sgx_ra_msg2_t & msg2, const size_t msg
 {
 	size_t retVal = 0;
 	uint8_t* tmpMsg3 = nullptr;
+	uint64_t msg3Token = 0;
 
-	DECENT_CHECK_SGX_FUNC_CALL_ERROR(ocall_decent_ra_server_ra_proc_msg2, &retVal, m_enclaveId, m_raCtxId, &msg2, msg2Len, &tmpMsg3);
+	DECENT_CHECK_SGX_FUNC_CALL_ERROR(ocall_decent_ra_server_ra_proc_msg2, &retVal, m_enclaveId, m_raCtxId, &msg2, msg2Len, &tmpMsg3, &msg3Token);
 
 	if (!retVal)
 	{
 		throw RuntimeException("Function call to " "ocall_decent_ra_server_ra_proc_msg2" " Failed.");
 	}
 
-	Tools::UntrustedBuffer msg3Buf(tmpMsg3, retVal);
+	Tools::UntrustedBuffer msg3Buf(tmpMsg3, retVal, msg3Token);
 
 	msg3 = msg3Buf.Read();
 }
@@ -7,17 +7,20 @@
 #include "../../Common/Common.h"
 #include "../../Common/make_unique.h"
 #include "../../Common/Tools/DataCoding.h"
+#include "../../Common/Tools/StrView.h"
 #include "../../Common/Ra/RaReport.h"
 #include "../../Common/Ra/KeyContainer.h"
 #include "../../Common/Ra/AppX509Req.h"
 #include "../../Common/Ra/AppX509Cert.h"
 #include "../../Common/Ra/ServerX509Cert.h"
+#include "../../Common/Ra/WhiteList/EncodedList.h"
 #include "../../Common/MbedTls/Drbg.h"
 #include "../../Common/MbedTls/EcKey.h"
 
 #include "../../Common/SGX/SgxCryptoConversions.h"
 
 #include "../../CommonEnclave/Tools/Crypto.h"
+#include "../../CommonEnclave/Tools/UntrustedBuffer.h"
 #include "../../CommonEnclave/SGX/LocAttCommLayer.h"
 #include "../../CommonEnclave/Net/EnclaveCntTranslator.h"
 
@@ -91,25 +94,31 @@ extern "C" sgx_status_t ecall_decent_ra_server_gen_x509(const void * const ias_c
 }
 
 //Output cert to the untrusted side.
-extern "C" size_t ecall_decent_ra_server_get_x509_pem(char* buf, size_t buf_len)
+extern "C" sgx_status_t ecall_decent_ra_server_get_x509_pem(uint8_t** out_pem, size_t* out_size)
 {
+	if (!out_pem || !out_size)
+	{
+		return SGX_ERROR_INVALID_PARAMETER;
+	}
+
 	auto serverCert = gs_serverState.GetServerCertContainer().GetServerCert();
 	if (!serverCert)
 	{
-		return 0;
+		return SGX_ERROR_UNEXPECTED;
 	}
 	try
 	{
 		const std::string& x509Pem = serverCert->GetPemChain();
 
-		std::memcpy(buf, x509Pem.data(), buf_len >= x509Pem.size() ? x509Pem.size() : buf_len);
+		*out_pem = CopyToUntrustedBuffer(x509Pem);
+		*out_size = x509Pem.size();
 
-		return x509Pem.size();
+		return SGX_SUCCESS;
 	}
 	catch (const std::exception& e)
 	{
 		PRINT_W("Failed to get server certificate. Caught exception: %s", e.what());
-		return 0;
+		return SGX_ERROR_UNEXPECTED;
 	}
 }
 
@@ -119,6 +128,26 @@ extern "C" int ecall_decent_ra_server_load_const_loaded_list(const char* key, co
 	return gs_serverState.GetAppWhiteListsManager().AddWhiteList(key, listJson);
 }
 
+//Load a batch of const white lists (see ConstListBatch) to the const white list manager.
+extern "C" int ecall_decent_ra_server_load_const_lists(const uint8_t* packed, size_t packed_size)
+{
+	if (!packed)
+	{
+		return false;
+	}
+
+	try
+	{
+		gs_serverState.GetAppWhiteListsManager().ApplyBatch(StrView(reinterpret_cast<const char*>(packed), packed_size));
+		return true;
+	}
+	catch (const std::exception& e)
+	{
+		PRINT_W("Failed to load const white lists. Caught exception: %s", e.what());
+		return false;
+	}
+}
+
 extern "C" sgx_status_t ecall_decent_ra_server_proc_app_cert_req(const char* key, void* const connection)
 {
 	if (!key || !connection)
@@ -140,8 +169,8 @@ extern "C" sgx_status_t ecall_decent_ra_server_proc_app_cert_req(const char* key
 		EcKeyPair<EcKeyType::SECP256R1> signKey = *gs_serverState.GetKeyContainer().GetSignKeyPair();
 		auto serverCert = gs_serverState.GetServerCertContainer().GetServerCert();
 
-		std::string whiteList = gs_serverState.GetAppWhiteListsManager().GetWhiteList(key);
-		AppX509CertWriter appX509(appPubKey, *serverCert, signKey, SerializeStruct(identity.mr_enclave), RaReport::sk_ValueReportTypeSgx, SerializeStruct(identity), whiteList);
+		std::shared_ptr<const WhiteList::EncodedList> whiteList = gs_serverState.GetAppWhiteListsManager().GetWhiteList(key);
+		AppX509CertWriter appX509(appPubKey, *serverCert, signKey, SerializeStruct(identity.mr_enclave), RaReport::sk_ValueReportTypeSgx, SerializeStruct(identity), *whiteList);
 
 		Drbg drbg;
 		commLayer.SendContainer(appX509.GeneratePemChain(drbg));